@@ -0,0 +1,182 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+#[=======================================================================[.rst:
+CheckSourceCompilesBatch
+------------------------
+
+.. versionadded:: 3.19
+
+Check if many given sources compile and link into executables, building
+all of them at once.
+
+.. command:: check_source_compiles_batch
+
+  .. code-block:: cmake
+
+    check_source_compiles_batch(<lang> <resultVar> <code>
+                                [<resultVar> <code>]...)
+
+  Check that each source supplied in ``<code>`` can be compiled as a source
+  file of language ``<lang>`` and linked as an executable (so it must contain
+  at least a ``main()`` function).  The result of each check will be stored
+  in the internal cache variable specified by the ``<resultVar>`` preceding
+  it, with a boolean true value for success and boolean false for failure.
+  ``<lang>`` must be one of ``C``, ``CXX``, ``OBJC``, ``OBJCXX``, ``CUDA``
+  or ``Fortran``, and must be enabled.
+
+  The checks are independent of each other.  They are performed by a single
+  call to the ``BATCH`` form of the :command:`try_compile` command, which
+  builds all of them in one project using a parallel build.  This is faster
+  than performing the same checks one after another with, for example,
+  :module:`CheckCSourceCompiles`.
+
+  The compile and link commands can be influenced by setting any of the
+  following variables prior to calling ``check_source_compiles_batch()``:
+
+  ``CMAKE_REQUIRED_FLAGS``
+    Additional flags to pass to the compiler. Note that the contents of
+    :variable:`CMAKE_<LANG>_FLAGS` and its associated configuration-specific
+    variable are automatically added to the compiler command before the
+    contents of ``CMAKE_REQUIRED_FLAGS``.
+
+  ``CMAKE_REQUIRED_DEFINITIONS``
+    A :ref:`;-list <CMake Language Lists>` of compiler definitions of the form
+    ``-DFOO`` or ``-DFOO=bar``.  Unlike the single check modules, no
+    definition for the name specified by ``<resultVar>`` is added, because
+    all checks share the same compile flags.
+
+  ``CMAKE_REQUIRED_INCLUDES``
+    A :ref:`;-list <CMake Language Lists>` of header search paths to pass to
+    the compiler. These will be the only header search paths used by
+    ``try_compile()``, i.e. the contents of the :prop_dir:`INCLUDE_DIRECTORIES`
+    directory property will be ignored.
+
+  ``CMAKE_REQUIRED_LINK_OPTIONS``
+    A :ref:`;-list <CMake Language Lists>` of options to add to the link
+    command (see :command:`try_compile` for further details).
+
+  ``CMAKE_REQUIRED_LIBRARIES``
+    A :ref:`;-list <CMake Language Lists>` of libraries to add to the link
+    command. These can be the name of system libraries or they can be
+    :ref:`Imported Targets <Imported Targets>` (see :command:`try_compile` for
+    further details).
+
+  ``CMAKE_REQUIRED_QUIET``
+    If this variable evaluates to a boolean true value, all status messages
+    associated with the checks will be suppressed.
+
+  Each check is only performed once, with the result cached in the variable
+  named by its ``<resultVar>``.  Checks whose variable is already defined
+  are left out of the batch.  In order to force a check to be re-evaluated,
+  the variable named by its ``<resultVar>`` must be manually removed from
+  the cache.
+
+#]=======================================================================]
+
+include_guard(GLOBAL)
+
+function(CHECK_SOURCE_COMPILES_BATCH _lang)
+  set(_ext_C c)
+  set(_ext_CXX cxx)
+  set(_ext_OBJC m)
+  set(_ext_OBJCXX mm)
+  set(_ext_CUDA cu)
+  set(_ext_Fortran F)
+  set(_ext "${_ext_${_lang}}")
+  if(NOT _ext)
+    message(FATAL_ERROR "check_source_compiles_batch: unknown language:\n"
+      "  ${_lang}\n"
+      "Supported languages: C, CXX, OBJC, OBJCXX, CUDA, Fortran.\n")
+  endif()
+
+  # Index ARGV# directly because the code may contain semicolons.
+  math(EXPR _odd "${ARGC} % 2")
+  if(NOT _odd)
+    message(FATAL_ERROR "check_source_compiles_batch: expected pairs of "
+      "a result variable and source code.\n")
+  endif()
+
+  set(_tmp "${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp")
+  set(_batch)
+  set(_vars)
+  set(_k 1)
+  while(_k LESS ARGC)
+    set(_var "${ARGV${_k}}")
+    math(EXPR _k "${_k} + 1")
+    set(_code "${ARGV${_k}}")
+    math(EXPR _k "${_k} + 1")
+    if(NOT DEFINED "${_var}")
+      set(_file "${_tmp}/src_${_var}.${_ext}")
+      file(WRITE "${_file}" "${_code}\n")
+      list(APPEND _batch "${_var}" "${_file}")
+      list(APPEND _vars "${_var}")
+      set("_code_${_var}" "${_code}")
+    endif()
+  endwhile()
+  if(NOT _vars)
+    return()
+  endif()
+
+  set(_link_options)
+  if(CMAKE_REQUIRED_LINK_OPTIONS)
+    set(_link_options LINK_OPTIONS ${CMAKE_REQUIRED_LINK_OPTIONS})
+  endif()
+  set(_libraries)
+  if(CMAKE_REQUIRED_LIBRARIES)
+    set(_libraries LINK_LIBRARIES ${CMAKE_REQUIRED_LIBRARIES})
+  endif()
+  set(_includes)
+  if(CMAKE_REQUIRED_INCLUDES)
+    set(_includes "-DINCLUDE_DIRECTORIES:STRING=${CMAKE_REQUIRED_INCLUDES}")
+  endif()
+
+  if(NOT CMAKE_REQUIRED_QUIET)
+    list(JOIN _vars ", " _names)
+    message(CHECK_START "Performing Tests ${_names}")
+  endif()
+  try_compile(_CHECK_SOURCE_COMPILES_BATCH_RESULT
+    ${CMAKE_BINARY_DIR}
+    BATCH ${_batch}
+    COMPILE_DEFINITIONS ${CMAKE_REQUIRED_DEFINITIONS}
+    ${_link_options}
+    ${_libraries}
+    CMAKE_FLAGS -DCOMPILE_DEFINITIONS:STRING=${CMAKE_REQUIRED_FLAGS}
+    "${_includes}"
+    OUTPUT_VARIABLE _output)
+  unset(_CHECK_SOURCE_COMPILES_BATCH_RESULT CACHE)
+
+  set(_failed)
+  foreach(_var IN LISTS _vars)
+    if(${_var})
+      set(${_var} 1 CACHE INTERNAL "Test ${_var}")
+      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+        "Performing ${_lang} SOURCE FILE Test ${_var} succeeded.\n"
+        "Source file was:\n${_code_${_var}}\n")
+    else()
+      set(${_var} "" CACHE INTERNAL "Test ${_var}")
+      list(APPEND _failed "${_var}")
+      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+        "Performing ${_lang} SOURCE FILE Test ${_var} failed.\n"
+        "Source file was:\n${_code_${_var}}\n")
+    endif()
+  endforeach()
+  if(_failed)
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "The batch of ${_lang} SOURCE FILE Tests produced the following "
+      "output:\n${_output}\n")
+  else()
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "The batch of ${_lang} SOURCE FILE Tests produced the following "
+      "output:\n${_output}\n")
+  endif()
+
+  if(NOT CMAKE_REQUIRED_QUIET)
+    if(_failed)
+      list(JOIN _failed ", " _names)
+      message(CHECK_FAIL "Failed: ${_names}")
+    else()
+      message(CHECK_PASS "Success")
+    endif()
+  endif()
+endfunction()
@@ -132,6 +132,7 @@ void cmCTestMultiProcessHandler::RunTests()
 #endif
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
 
+  this->InitializeReadyQueue();
   uv_loop_init(&this->Loop);
   this->StartNextTests();
   uv_run(&this->Loop, UV_RUN_DEFAULT);
@@ -411,17 +412,35 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
 {
   for (std::string const& i : this->Properties[index]->LockedResources) {
     this->LockedResources.erase(i);
+
+    // Give the tests waiting for this lock another chance to start.
+    auto waiting = this->LockWaitingTests.find(i);
+    if (waiting != this->LockWaitingTests.end()) {
+      for (int test : waiting->second) {
+        this->PushReadyTest(test);
+      }
+      this->LockWaitingTests.erase(waiting);
+    }
   }
   if (this->Properties[index]->RunSerial) {
     this->SerialTestRunning = false;
   }
 }
 
+bool cmCTestMultiProcessHandler::WaitForLockedResources(int test)
+{
+  for (std::string const& i : this->Properties[test]->LockedResources) {
+    if (cm::contains(this->LockedResources, i)) {
+      this->LockWaitingTests[i].push_back(test);
+      return true;
+    }
+  }
+  return false;
+}
+
 void cmCTestMultiProcessHandler::EraseTest(int test)
 {
   this->Tests.erase(test);
-  this->SortedTests.erase(
-    std::find(this->SortedTests.begin(), this->SortedTests.end(), test));
 }
 
 inline size_t cmCTestMultiProcessHandler::GetProcessorsUsed(int test)
@@ -447,13 +466,6 @@ std::string cmCTestMultiProcessHandler::GetName(int test)
 
 bool cmCTestMultiProcessHandler::StartTest(int test)
 {
-  // Check for locked resources
-  for (std::string const& i : this->Properties[test]->LockedResources) {
-    if (cm::contains(this->LockedResources, i)) {
-      return false;
-    }
-  }
-
   // Allocate resources
   if (this->ResourceAllocationErrors[test].empty() &&
       !this->AllocateResources(test)) {
@@ -508,18 +520,17 @@ void cmCTestMultiProcessHandler::StartNextTests()
     return;
   }
 
-  bool allTestsFailedTestLoadCheck = false;
+  // Wait for the load to drop only if it held back every ready test that
+  // was checked against it.  Having no ready tests at all, e.g. because
+  // the remaining ones depend on running ones, is no reason to wait.
+  bool anyTestFailedTestLoadCheck = false;
+  bool anyTestPassedTestLoadCheck = false;
   size_t minProcessorsRequired = this->ParallelLevel;
   std::string testWithMinProcessors;
 
-  cmsys::SystemInformation info;
-
   unsigned long systemLoad = 0;
   size_t spareLoad = 0;
   if (this->TestLoad > 0) {
-    // Activate possible wait.
-    allTestsFailedTestLoadCheck = true;
-
     // Check for a fake load average value used in testing.
     if (this->FakeLoadForTesting > 0) {
       systemLoad = this->FakeLoadForTesting;
@@ -529,6 +540,7 @@ void cmCTestMultiProcessHandler::StartNextTests()
     }
     // If it's not set, look up the true load average.
     else {
+      cmsys::SystemInformation info;
       systemLoad = static_cast<unsigned long>(ceil(info.GetLoadAverage()));
     }
     spareLoad =
@@ -540,15 +552,27 @@ void cmCTestMultiProcessHandler::StartNextTests()
     }
   }
 
-  TestList copy = this->SortedTests;
-  for (auto const& test : copy) {
+  // Take ready tests in order of priority.  Tests that cannot start now
+  // are queued again afterwards, except those that wait for a lock or
+  // for all other tests to finish.  Tests whose dependencies finish
+  // while starting others are queued as we go.
+  TestList deferred;
+  while (!this->ReadyTests.empty()) {
     // Take a nap if we're currently performing a RUN_SERIAL test.
     if (this->SerialTestRunning) {
       break;
     }
+    int const test = this->ReadyTests.top().second;
+    this->ReadyTests.pop();
+
     // We can only start a RUN_SERIAL test if no other tests are also
     // running.
     if (this->Properties[test]->RunSerial && this->RunningCount > 0) {
+      this->SerialWaitingTests.push_back(test);
+      continue;
+    }
+
+    if (this->WaitForLockedResources(test)) {
       continue;
     }
 
@@ -560,8 +584,9 @@ void cmCTestMultiProcessHandler::StartNextTests()
                    "OK to run " << GetName(test) << ", it requires "
                                 << processors << " procs & system load is: "
                                 << systemLoad << std::endl);
-        allTestsFailedTestLoadCheck = false;
+        anyTestPassedTestLoadCheck = true;
       } else {
+        anyTestFailedTestLoadCheck = true;
         testLoadOk = false;
       }
     }
@@ -573,17 +598,26 @@ void cmCTestMultiProcessHandler::StartNextTests()
 
     if (testLoadOk && processors <= numToStart && this->StartTest(test)) {
       numToStart -= processors;
-    } else if (numToStart == 0) {
+      continue;
+    }
+    // A test that failed to start has finished already.
+    if (cm::contains(this->Tests, test)) {
+      deferred.push_back(test);
+    }
+    if (numToStart == 0) {
       break;
     }
   }
+  for (int test : deferred) {
+    this->PushReadyTest(test);
+  }
 
-  if (allTestsFailedTestLoadCheck) {
+  if (anyTestFailedTestLoadCheck && !anyTestPassedTestLoadCheck) {
     // Find out whether there are any non RUN_SERIAL tests left, so that the
     // correct warning may be displayed.
     bool onlyRunSerialTestsLeft = true;
-    for (auto const& test : copy) {
-      if (!this->Properties[test]->RunSerial) {
+    for (auto const& test : this->Tests) {
+      if (!this->Properties[test.first]->RunSerial) {
         onlyRunSerialTestsLeft = false;
       }
     }
@@ -651,8 +685,13 @@ void cmCTestMultiProcessHandler::FinishTestProcess(
     this->Failed->push_back(properties->Name);
   }
 
-  for (auto& t : this->Tests) {
-    t.second.erase(test);
+  // Queue the dependent tests that were waiting only for this one.
+  for (int dependent : this->Dependents[test]) {
+    auto it = this->Tests.find(dependent);
+    if (it != this->Tests.end() && it->second.erase(test) &&
+        it->second.empty()) {
+      this->PushReadyTest(dependent);
+    }
   }
 
   this->TestFinishMap[test] = true;
@@ -661,6 +700,12 @@ void cmCTestMultiProcessHandler::FinishTestProcess(
   this->DeallocateResources(test);
   this->UnlockResources(test);
   this->RunningCount -= GetProcessorsUsed(test);
+  if (this->RunningCount == 0) {
+    for (int serialTest : this->SerialWaitingTests) {
+      this->PushReadyTest(serialTest);
+    }
+    this->SerialWaitingTests.clear();
+  }
 
   for (auto p : properties->Affinity) {
     this->ProcessorsAvailable.insert(p);
@@ -681,38 +726,24 @@ void cmCTestMultiProcessHandler::UpdateCostData()
   fout.open(tmpout.c_str());
 
   PropertiesMap temp = this->Properties;
+  std::unordered_map<std::string, int> const indexByName =
+    this->MapTestsByName();
 
   if (cmSystemTools::FileExists(fname)) {
-    cmsys::ifstream fin;
-    fin.open(fname.c_str());
-
-    std::string line;
-    while (std::getline(fin, line)) {
-      if (line == "---") {
-        break;
-      }
-      std::vector<std::string> parts = cmSystemTools::SplitString(line, ' ');
-      // Format: <name> <previous_runs> <avg_cost>
-      if (parts.size() < 3) {
-        break;
-      }
-
-      std::string name = parts[0];
-      int prev = atoi(parts[1].c_str());
-      float cost = static_cast<float>(atof(parts[2].c_str()));
-
-      int index = this->SearchByName(name);
-      if (index == -1) {
+    for (CostData::Entry const& entry : ReadCostDataFile(fname).Tests) {
+      auto found = indexByName.find(entry.Name);
+      if (found == indexByName.end()) {
         // This test is not in memory. We just rewrite the entry
-        fout << name << " " << prev << " " << cost << "\n";
+        fout << entry.Name << " " << entry.PreviousRuns << " " << entry.Cost
+             << "\n";
       } else {
+        int index = found->second;
         // Update with our new average cost
-        fout << name << " " << this->Properties[index]->PreviousRuns << " "
-             << this->Properties[index]->Cost << "\n";
+        fout << entry.Name << " " << this->Properties[index]->PreviousRuns
+             << " " << this->Properties[index]->Cost << "\n";
         temp.erase(index);
       }
     }
-    fin.close();
     cmSystemTools::RemoveFile(fname);
   }
 
@@ -731,68 +762,82 @@ void cmCTestMultiProcessHandler::UpdateCostData()
   cmSystemTools::RenameFile(tmpout, fname);
 }
 
-void cmCTestMultiProcessHandler::ReadCostData()
+cmCTestMultiProcessHandler::CostData
+cmCTestMultiProcessHandler::ReadCostDataFile(std::string const& fname)
 {
-  std::string fname = this->CTest->GetCostDataFile();
+  CostData data;
+  cmsys::ifstream fin(fname.c_str());
+  if (!fin) {
+    return data;
+  }
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (line == "---") {
+      break;
+    }
 
-  if (cmSystemTools::FileExists(fname, true)) {
-    cmsys::ifstream fin;
-    fin.open(fname.c_str());
-    std::string line;
-    while (std::getline(fin, line)) {
-      if (line == "---") {
-        break;
-      }
+    // Format: <name> <previous_runs> <avg_cost>
+    std::vector<std::string> parts = cmSystemTools::SplitString(line, ' ');
 
-      std::vector<std::string> parts = cmSystemTools::SplitString(line, ' ');
+    // Probably an older version of the file, will be fixed next run
+    if (parts.size() < 3) {
+      return data;
+    }
 
-      // Probably an older version of the file, will be fixed next run
-      if (parts.size() < 3) {
-        fin.close();
-        return;
-      }
+    data.Tests.push_back({ parts[0], atoi(parts[1].c_str()),
+                           static_cast<float>(atof(parts[2].c_str())) });
+  }
+  // Next part of the file is the failed tests
+  while (std::getline(fin, line)) {
+    if (!line.empty()) {
+      data.Failed.push_back(line);
+    }
+  }
+  return data;
+}
 
-      std::string name = parts[0];
-      int prev = atoi(parts[1].c_str());
-      float cost = static_cast<float>(atof(parts[2].c_str()));
+void cmCTestMultiProcessHandler::ReadCostData()
+{
+  std::string fname = this->CTest->GetCostDataFile();
 
-      int index = this->SearchByName(name);
-      if (index == -1) {
+  if (cmSystemTools::FileExists(fname, true)) {
+    std::unordered_map<std::string, int> const indexByName =
+      this->MapTestsByName();
+    CostData data = ReadCostDataFile(fname);
+    for (CostData::Entry const& entry : data.Tests) {
+      auto found = indexByName.find(entry.Name);
+      if (found == indexByName.end()) {
         continue;
       }
+      int index = found->second;
 
-      this->Properties[index]->PreviousRuns = prev;
+      this->Properties[index]->PreviousRuns = entry.PreviousRuns;
       // When not running in parallel mode, don't use cost data
       if (this->ParallelLevel > 1 && this->Properties[index] &&
           this->Properties[index]->Cost == 0) {
-        this->Properties[index]->Cost = cost;
-      }
-    }
-    // Next part of the file is the failed tests
-    while (std::getline(fin, line)) {
-      if (!line.empty()) {
-        this->LastTestsFailed.push_back(line);
+        this->Properties[index]->Cost = entry.Cost;
       }
     }
-    fin.close();
+    this->LastTestsFailed = std::move(data.Failed);
   }
 }
 
-int cmCTestMultiProcessHandler::SearchByName(std::string const& name)
+std::unordered_map<std::string, int>
+cmCTestMultiProcessHandler::MapTestsByName() const
 {
-  int index = -1;
-
+  std::unordered_map<std::string, int> indexByName;
   for (auto const& p : this->Properties) {
-    if (p.second->Name == name) {
-      index = p.first;
-    }
+    indexByName[p.second->Name] = p.first;
   }
-  return index;
+  return indexByName;
 }
 
 void cmCTestMultiProcessHandler::CreateTestCostList()
 {
-  if (this->ParallelLevel > 1) {
+  if (this->ParallelLevel > 1 &&
+      this->CTest->GetScheduleType() == "CriticalPath") {
+    CreateCriticalPathTestCostList();
+  } else if (this->ParallelLevel > 1) {
     CreateParallelTestCostList();
   } else {
     CreateSerialTestCostList();
@@ -857,6 +902,105 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
   }
 }
 
+void cmCTestMultiProcessHandler::InitializeReadyQueue()
+{
+  for (size_t i = 0; i < this->SortedTests.size(); ++i) {
+    this->TestRanks[this->SortedTests[i]] = i;
+  }
+  for (auto& t : this->Tests) {
+    for (auto d = t.second.begin(); d != t.second.end();) {
+      if (cm::contains(this->Tests, *d)) {
+        this->Dependents[*d].insert(t.first);
+        ++d;
+      } else {
+        // The dependency finished in an interrupted run we resume.
+        d = t.second.erase(d);
+      }
+    }
+    if (t.second.empty()) {
+      this->PushReadyTest(t.first);
+    }
+  }
+}
+
+void cmCTestMultiProcessHandler::PushReadyTest(int test)
+{
+  auto rank = this->TestRanks.find(test);
+  this->ReadyTests.emplace(rank != this->TestRanks.end()
+                             ? rank->second
+                             : this->SortedTests.size(),
+                           test);
+}
+
+void cmCTestMultiProcessHandler::CreateCriticalPathTestCostList()
+{
+  // Tests without cost data are assumed to take the average time of
+  // the tests with cost data.
+  float knownCost = 0;
+  size_t numKnown = 0;
+  for (auto const& t : this->Tests) {
+    float cost = this->Properties[t.first]->Cost;
+    if (cost > 0) {
+      knownCost += cost;
+      ++numKnown;
+    }
+  }
+  float const defaultCost =
+    numKnown > 0 ? knownCost / static_cast<float>(numKnown) : 1;
+  auto weight = [this, defaultCost](int test) -> float {
+    float cost = this->Properties[test]->Cost;
+    return cost > 0 ? cost : defaultCost;
+  };
+
+  // Compute the longest path from each test through the tests that
+  // depend on it, visiting every test after all of its dependents.
+  std::map<int, size_t> numDependents;
+  for (auto const& t : this->Tests) {
+    for (int d : t.second) {
+      ++numDependents[d];
+    }
+  }
+  std::map<int, float> criticalPath;
+  TestList visit;
+  for (auto const& t : this->Tests) {
+    if (numDependents[t.first] == 0) {
+      visit.push_back(t.first);
+    }
+  }
+  while (!visit.empty()) {
+    int test = visit.back();
+    visit.pop_back();
+    float const path = criticalPath[test] + weight(test);
+    criticalPath[test] = path;
+    for (int d : this->Tests[test]) {
+      if (!cm::contains(this->Tests, d)) {
+        continue;
+      }
+      criticalPath[d] = std::max(criticalPath[d], path);
+      if (--numDependents[d] == 0) {
+        visit.push_back(d);
+      }
+    }
+  }
+
+  // Previously failed tests still run first.  Then start the tests with
+  // the longest remaining path first.  A test always has a longer path
+  // than the tests depending on it, so dependencies come first.
+  TestList sortedCopy;
+  for (auto const& t : this->Tests) {
+    if (cm::contains(this->LastTestsFailed, this->Properties[t.first]->Name)) {
+      this->SortedTests.push_back(t.first);
+    } else {
+      sortedCopy.push_back(t.first);
+    }
+  }
+  std::stable_sort(sortedCopy.begin(), sortedCopy.end(),
+                   [&criticalPath](int l, int r) {
+                     return criticalPath[l] > criticalPath[r];
+                   });
+  cm::append(this->SortedTests, sortedCopy);
+}
+
 void cmCTestMultiProcessHandler::GetAllTestDependencies(int test,
                                                         TestList& dependencies)
 {
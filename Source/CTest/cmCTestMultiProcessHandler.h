@@ -5,10 +5,14 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <functional>
 #include <map>
 #include <memory>
+#include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <cm3p/uv.h>
@@ -52,6 +56,25 @@ public:
     std::string Id;
     unsigned int Slots;
   };
+  /** The content of the cost data file written after each run.  */
+  struct CostData
+  {
+    struct Entry
+    {
+      std::string Name;
+      int PreviousRuns;
+      float Cost;
+    };
+    // The tests in the order of the file
+    std::vector<Entry> Tests;
+    // The tests that failed in the last run
+    std::vector<std::string> Failed;
+  };
+
+  /** Read a cost data file.  A file that does not exist or was written
+      in an older format yields no data, or only the tests before the
+      first entry that does not parse.  */
+  static CostData ReadCostDataFile(std::string const& fname);
 
   cmCTestMultiProcessHandler();
   virtual ~cmCTestMultiProcessHandler();
@@ -111,8 +134,8 @@ protected:
 
   void UpdateCostData();
   void ReadCostData();
-  // Return index of a test based on its name
-  int SearchByName(std::string const& name);
+  // Return a map from the name of each test to its index
+  std::unordered_map<std::string, int> MapTestsByName() const;
 
   void CreateTestCostList();
 
@@ -120,6 +143,13 @@ protected:
   void CreateSerialTestCostList();
 
   void CreateParallelTestCostList();
+  void CreateCriticalPathTestCostList();
+
+  // Queue the tests whose dependencies are satisfied
+  void InitializeReadyQueue();
+  void PushReadyTest(int test);
+  // Park a test on the wait list of a RESOURCE_LOCK held by another test
+  bool WaitForLockedResources(int test);
 
   // Removes the checkpoint file
   void MarkFinished();
@@ -163,6 +193,18 @@ protected:
   // map from test number to set of depend tests
   TestMap Tests;
   TestList SortedTests;
+  // Tests ready to start, keyed on their position in SortedTests
+  using ReadyEntry = std::pair<size_t, int>;
+  std::priority_queue<ReadyEntry, std::vector<ReadyEntry>,
+                      std::greater<ReadyEntry>>
+    ReadyTests;
+  std::map<int, size_t> TestRanks;
+  // map from test number to the tests that depend on it
+  TestMap Dependents;
+  // Ready tests waiting for a RESOURCE_LOCK or for RUN_SERIAL to be
+  // possible
+  std::map<std::string, TestList> LockWaitingTests;
+  TestList SerialWaitingTests;
   // Total number of tests we'll be running
   size_t Total;
   // Number of tests that are complete
@@ -2,6 +2,8 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmCTestRunTest.h"
 
+#include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <cstddef> // IWYU pragma: keep
 #include <cstdint>
@@ -14,6 +16,7 @@
 
 #include <cm/memory>
 
+#include "cmsys/FStream.hxx"
 #include "cmsys/RegularExpression.hxx"
 
 #include "cmCTest.h"
@@ -24,6 +27,37 @@
 #include "cmSystemTools.h"
 #include "cmWorkingDirectory.h"
 
+namespace {
+std::string const* FindRegularExpression(
+  std::vector<std::pair<cmsys::RegularExpression, std::string>>& regexes,
+  std::string const& output)
+{
+  for (auto& reg : regexes) {
+    if (reg.first.find(output)) {
+      return &reg.second;
+    }
+  }
+  return nullptr;
+}
+
+// End the lines of the kept output as cmProcess does when it splits the
+// output into lines.
+std::string EndStreamedLines(std::string output)
+{
+  std::replace(output.begin(), output.end(), '\0', '\n');
+  std::string::size_type pos = 0;
+  while ((pos = output.find("\r\n", pos)) != std::string::npos) {
+    std::string::size_type start = pos;
+    while (start > 0 && output[start - 1] == '\r') {
+      --start;
+    }
+    output.erase(start, pos + 1 - start);
+    pos = start + 1;
+  }
+  return output;
+}
+}
+
 cmCTestRunTest::cmCTestRunTest(cmCTestMultiProcessHandler& multiHandler)
   : MultiTestHandler(multiHandler)
 {
@@ -44,29 +78,181 @@ void cmCTestRunTest::CheckOutput(std::string const& line)
   this->ProcessOutput += "\n";
 
   // Check for TIMEOUT_AFTER_MATCH property.
+  this->CheckTimeoutAfterMatch(this->ProcessOutput);
+}
+
+void cmCTestRunTest::CheckOutputData(char const* data, size_t length)
+{
+  this->StreamOutputData(data, length);
+  if (this->StreamLog) {
+    this->StreamLog.write(data, static_cast<std::streamsize>(length));
+  }
+
+  // Split the lines as cmProcess does, keeping at most the stream limit
+  // of each line for the regular expressions.
+  char const* const end = data + length;
+  while (data != end) {
+    char const* eol = std::find_if(
+      data, end, [](char c) { return c == '\n' || c == '\0'; });
+    size_t n = static_cast<size_t>(eol - data);
+    if (this->StreamLimit != 0) {
+      n = std::min(n, this->StreamLimit - this->StreamLine.size());
+    }
+    this->StreamLine.append(data, n);
+    if (eol == end) {
+      break;
+    }
+    this->CheckStreamLine();
+    data = eol + 1;
+  }
+}
+
+void cmCTestRunTest::EndOutputData()
+{
+  // Look for a partial last line.
+  if (!this->StreamLine.empty()) {
+    this->CheckStreamLine();
+  }
+}
+
+void cmCTestRunTest::CheckStreamLine()
+{
+  std::string& line = this->StreamLine;
+  while (!line.empty() && line.back() == '\r') {
+    line.pop_back();
+  }
+  cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+             this->GetIndex() << ": " << line << std::endl);
+
+  // Match the regular expressions against each line as it arrives
+  // because the full output is not kept in memory.
+  if (!this->RequiredMatch) {
+    this->RequiredMatch = FindRegularExpression(
+      this->TestProperties->RequiredRegularExpressions, line);
+  }
+  if (!this->ErrorMatch) {
+    this->ErrorMatch = FindRegularExpression(
+      this->TestProperties->ErrorRegularExpressions, line);
+  }
+  if (!this->SkipMatch) {
+    this->SkipMatch = FindRegularExpression(
+      this->TestProperties->SkipRegularExpressions, line);
+  }
+  this->CheckTimeoutAfterMatch(line);
+  line.clear();
+}
+
+void cmCTestRunTest::CheckTimeoutAfterMatch(std::string const& output)
+{
   if (!this->TestProperties->TimeoutRegularExpressions.empty()) {
-    for (auto& reg : this->TestProperties->TimeoutRegularExpressions) {
-      if (reg.first.find(this->ProcessOutput)) {
-        cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                   this->GetIndex()
-                     << ": "
-                     << "Test timeout changed to "
-                     << std::chrono::duration_cast<std::chrono::seconds>(
-                          this->TestProperties->AlternateTimeout)
-                          .count()
-                     << std::endl);
-        this->TestProcess->ResetStartTime();
-        this->TestProcess->ChangeTimeout(
-          this->TestProperties->AlternateTimeout);
-        this->TestProperties->TimeoutRegularExpressions.clear();
-        break;
-      }
+    if (FindRegularExpression(this->TestProperties->TimeoutRegularExpressions,
+                              output)) {
+      cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                 this->GetIndex()
+                   << ": "
+                   << "Test timeout changed to "
+                   << std::chrono::duration_cast<std::chrono::seconds>(
+                        this->TestProperties->AlternateTimeout)
+                        .count()
+                   << std::endl);
+      this->TestProcess->ResetStartTime();
+      this->TestProcess->ChangeTimeout(this->TestProperties->AlternateTimeout);
+      this->TestProperties->TimeoutRegularExpressions.clear();
     }
   }
 }
 
+void cmCTestRunTest::StreamOutputData(char const* data, size_t length)
+{
+  this->StreamTotal += length;
+  size_t const limit = this->StreamLimit;
+  if (limit == 0) {
+    this->StreamHead.append(data, length);
+    return;
+  }
+
+  // Keep the first bytes of the output.
+  if (this->StreamHead.size() < limit) {
+    size_t const n = std::min(length, limit - this->StreamHead.size());
+    this->StreamHead.append(data, n);
+    data += n;
+    length -= n;
+  }
+  if (length == 0) {
+    return;
+  }
+
+  // Keep the last bytes of the output in a ring buffer.
+  if (length >= limit) {
+    this->StreamTail.assign(data + length - limit, limit);
+    this->StreamTailPos = 0;
+    return;
+  }
+  if (this->StreamTail.size() < limit) {
+    size_t const n = std::min(length, limit - this->StreamTail.size());
+    this->StreamTail.append(data, n);
+    data += n;
+    length -= n;
+  }
+  while (length > 0) {
+    size_t const n = std::min(length, limit - this->StreamTailPos);
+    this->StreamTail.replace(this->StreamTailPos, n, data, n);
+    this->StreamTailPos = (this->StreamTailPos + n) % limit;
+    data += n;
+    length -= n;
+  }
+}
+
+std::string cmCTestRunTest::GetStreamedOutput(size_t length) const
+{
+  std::string const& head = this->StreamHead;
+  if (this->StreamLimit != 0 && (length == 0 || length > this->StreamLimit)) {
+    length = this->StreamLimit;
+  }
+
+  std::string tail = this->StreamTail.substr(this->StreamTailPos);
+  tail.append(this->StreamTail, 0, this->StreamTailPos);
+  if (length == 0 || this->StreamTotal <= length) {
+    return EndStreamedLines(head + tail);
+  }
+  // If no output was dropped, the buffers hold the output in one piece,
+  // and the end of the output to report may lie in the head buffer.
+  if (head.size() + tail.size() == this->StreamTotal) {
+    tail.insert(0, head);
+  }
+
+  // Keep half of the allowed length from each end of the output without
+  // breaking a multi-byte UTF-8 encoding.
+  size_t const tailLength = std::min(tail.size(), length / 2);
+  size_t const headLength =
+    cmCTestTestHandler::TruncatedOutputLength(head, length - tailLength);
+  size_t tailStart = tail.size() - tailLength;
+  while (tailStart < tail.size() &&
+         (static_cast<unsigned char>(tail[tailStart]) & 0xC0) == 0x80) {
+    ++tailStart;
+  }
+
+  std::ostringstream msg;
+  msg << head.substr(0, headLength)
+      << "...\n"
+         "Removed "
+      << this->StreamTotal - headLength - (tail.size() - tailStart)
+      << " bytes of test output since it exceeds the threshold of " << length
+      << " bytes.\n";
+  if (!this->StreamLogFile.empty()) {
+    msg << "The full output was written to " << this->StreamLogFile
+        << "\n";
+  }
+  msg << "...\n" << tail.substr(tailStart);
+  return EndStreamedLines(msg.str());
+}
+
 bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
 {
+  if (this->StreamOutput) {
+    this->StreamLog.close();
+    this->ProcessOutput = this->GetStreamedOutput(0);
+  }
   this->WriteLogOutputTop(completed, total);
   std::string reason;
   bool passed = true;
@@ -80,18 +266,20 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   bool forceSkip = false;
   bool skipped = false;
   bool outputTestErrorsToConsole = false;
+  if (!this->StreamOutput) {
+    this->RequiredMatch = FindRegularExpression(
+      this->TestProperties->RequiredRegularExpressions, this->ProcessOutput);
+    this->ErrorMatch = FindRegularExpression(
+      this->TestProperties->ErrorRegularExpressions, this->ProcessOutput);
+    this->SkipMatch = FindRegularExpression(
+      this->TestProperties->SkipRegularExpressions, this->ProcessOutput);
+  }
   if (!this->TestProperties->RequiredRegularExpressions.empty() &&
       this->FailedDependencies.empty()) {
-    bool found = false;
-    for (auto& pass : this->TestProperties->RequiredRegularExpressions) {
-      if (pass.first.find(this->ProcessOutput)) {
-        found = true;
-        reason = cmStrCat("Required regular expression found. Regex=[",
-                          pass.second, ']');
-        break;
-      }
-    }
-    if (!found) {
+    if (this->RequiredMatch) {
+      reason = cmStrCat("Required regular expression found. Regex=[",
+                        *this->RequiredMatch, ']');
+    } else {
       reason = "Required regular expression not found. Regex=[";
       for (auto& pass : this->TestProperties->RequiredRegularExpressions) {
         reason += pass.second;
@@ -101,27 +289,15 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
       forceFail = true;
     }
   }
-  if (!this->TestProperties->ErrorRegularExpressions.empty() &&
-      this->FailedDependencies.empty()) {
-    for (auto& fail : this->TestProperties->ErrorRegularExpressions) {
-      if (fail.first.find(this->ProcessOutput)) {
-        reason = cmStrCat("Error regular expression found in output. Regex=[",
-                          fail.second, ']');
-        forceFail = true;
-        break;
-      }
-    }
+  if (this->ErrorMatch && this->FailedDependencies.empty()) {
+    reason = cmStrCat("Error regular expression found in output. Regex=[",
+                      *this->ErrorMatch, ']');
+    forceFail = true;
   }
-  if (!this->TestProperties->SkipRegularExpressions.empty() &&
-      this->FailedDependencies.empty()) {
-    for (auto& skip : this->TestProperties->SkipRegularExpressions) {
-      if (skip.first.find(this->ProcessOutput)) {
-        reason = cmStrCat("Skip regular expression found in output. Regex=[",
-                          skip.second, ']');
-        forceSkip = true;
-        break;
-      }
-    }
+  if (this->SkipMatch && this->FailedDependencies.empty()) {
+    reason = cmStrCat("Skip regular expression found in output. Regex=[",
+                      *this->SkipMatch, ']');
+    forceSkip = true;
   }
   std::ostringstream outputStream;
   if (res == cmProcess::State::Exited) {
@@ -228,17 +404,20 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     *this->TestHandler->LogFile << "Test time = " << buf << std::endl;
   }
 
+  size_t const outputSize = static_cast<size_t>(
+    this->TestResult.Status == cmCTestTestHandler::COMPLETED
+      ? this->TestHandler->CustomMaximumPassedTestOutputSize
+      : this->TestHandler->CustomMaximumFailedTestOutputSize);
+  if (this->StreamOutput && started) {
+    this->ProcessOutput = this->GetStreamedOutput(outputSize);
+  }
+
   this->DartProcessing();
 
   // if this is doing MemCheck then all the output needs to be put into
   // Output since that is what is parsed by cmCTestMemCheckHandler
-  if (!this->TestHandler->MemCheck && started) {
-    this->TestHandler->CleanTestOutput(
-      this->ProcessOutput,
-      static_cast<size_t>(
-        this->TestResult.Status == cmCTestTestHandler::COMPLETED
-          ? this->TestHandler->CustomMaximumPassedTestOutputSize
-          : this->TestHandler->CustomMaximumFailedTestOutputSize));
+  if (!this->TestHandler->MemCheck && !this->StreamOutput && started) {
+    this->TestHandler->CleanTestOutput(this->ProcessOutput, outputSize);
   }
   this->TestResult.Reason = reason;
   if (this->TestHandler->LogFile) {
@@ -418,6 +597,7 @@ void cmCTestRunTest::StartFailure(std::string const& output,
   }
 
   this->ProcessOutput.clear();
+  this->ResetOutputStream();
   if (!output.empty()) {
     *this->TestHandler->LogFile << output << std::endl;
     cmCTestLog(this->CTest, ERROR_MESSAGE, output << std::endl);
@@ -437,6 +617,56 @@ void cmCTestRunTest::StartFailure(std::string const& output,
   this->TestResult.Environment.clear();
 }
 
+void cmCTestRunTest::ResetOutputStream()
+{
+  this->StreamOutput = false;
+  this->StreamLimit = 0;
+  this->StreamTotal = 0;
+  this->StreamHead.clear();
+  this->StreamTail.clear();
+  this->StreamTailPos = 0;
+  this->StreamLine.clear();
+  this->StreamLog.close();
+  this->StreamLogFile.clear();
+  this->RequiredMatch = nullptr;
+  this->ErrorMatch = nullptr;
+  this->SkipMatch = nullptr;
+}
+
+void cmCTestRunTest::StartOutputStream()
+{
+  this->StreamOutput = true;
+  // Keep enough of each end of the output to report either outcome.  A
+  // limit of zero does not limit the output of its outcome, so then keep
+  // the whole output, as the limit of zero does without streaming.
+  int const passedSize = this->TestHandler->CustomMaximumPassedTestOutputSize;
+  int const failedSize = this->TestHandler->CustomMaximumFailedTestOutputSize;
+  this->StreamLimit = passedSize > 0 && failedSize > 0
+    ? static_cast<size_t>(std::max(passedSize, failedSize))
+    : 0;
+
+  std::string const& dir = this->TestHandler->TestOutputLogDirectory;
+  if (dir.empty()) {
+    return;
+  }
+  std::string name = this->TestProperties->Name;
+  for (char& c : name) {
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.') {
+      c = '_';
+    }
+  }
+  this->StreamLogFile =
+    cmStrCat(dir, '/', this->GetIndex(), '-', name, ".log");
+  this->StreamLog.open(this->StreamLogFile.c_str(),
+                       std::ios::out | std::ios::binary);
+  if (!this->StreamLog) {
+    cmCTestLog(this->CTest, WARNING,
+               "Cannot write test output to " << this->StreamLogFile
+                                              << std::endl);
+    this->StreamLogFile.clear();
+  }
+}
+
 std::string cmCTestRunTest::GetTestPrefix(size_t completed, size_t total) const
 {
   std::ostringstream outputStream;
@@ -491,6 +721,7 @@ bool cmCTestRunTest::StartTest(size_t completed, size_t total)
   }
 
   this->ProcessOutput.clear();
+  this->ResetOutputStream();
 
   this->TestResult.Properties = this->TestProperties;
   this->TestResult.ExecutionTime = cmDuration::zero();
@@ -604,6 +835,10 @@ bool cmCTestRunTest::StartTest(size_t completed, size_t total)
     }
   }
 
+  if (this->TestHandler->TestOutputStream && !this->TestHandler->MemCheck) {
+    this->StartOutputStream();
+  }
+
   return this->ForkProcess(timeout, this->TestProperties->ExplicitTimeout,
                            &this->TestProperties->Environment,
                            &this->TestProperties->Affinity);
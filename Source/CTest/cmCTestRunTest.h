@@ -13,6 +13,8 @@
 
 #include <stddef.h>
 
+#include "cmsys/FStream.hxx"
+
 #include "cmCTest.h"
 #include "cmCTestMultiProcessHandler.h"
 #include "cmCTestTestHandler.h"
@@ -65,6 +67,13 @@ public:
   // Read and store output.  Returns true if it must be called again.
   void CheckOutput(std::string const& line);
 
+  // Whether the output is passed to CheckOutputData instead of being
+  // split into lines for CheckOutput
+  bool IsOutputStreamed() const { return this->StreamOutput; }
+  // Read the output in chunks as it arrives, and its partial last line
+  void CheckOutputData(char const* data, size_t length);
+  void EndOutputData();
+
   static bool StartTest(std::unique_ptr<cmCTestRunTest> runner,
                         size_t completed, size_t total);
   static bool StartAgain(std::unique_ptr<cmCTestRunTest> runner,
@@ -121,6 +130,16 @@ private:
 
   void SetupResourcesEnvironment(std::vector<std::string>* log = nullptr);
 
+  // Bounded capture of the output with --test-output-stream
+  void ResetOutputStream();
+  void StartOutputStream();
+  void StreamOutputData(char const* data, size_t length);
+  void CheckStreamLine();
+  void CheckTimeoutAfterMatch(std::string const& output);
+  // Returns the kept head and tail of the output within length bytes,
+  // or all of the kept output if length is zero
+  std::string GetStreamedOutput(size_t length) const;
+
   // Returns "completed/total Test #Index: "
   std::string GetTestPrefix(size_t completed, size_t total) const;
 
@@ -131,6 +150,19 @@ private:
   cmCTest* CTest;
   std::unique_ptr<cmProcess> TestProcess;
   std::string ProcessOutput;
+  bool StreamOutput = false;
+  size_t StreamLimit = 0;
+  size_t StreamTotal = 0;
+  std::string StreamHead;
+  std::string StreamTail; // ring buffer starting at StreamTailPos
+  size_t StreamTailPos = 0;
+  std::string StreamLine; // the line being read, bounded by StreamLimit
+  cmsys::ofstream StreamLog;
+  std::string StreamLogFile;
+  // The first regular expressions of each kind matching the output
+  std::string const* RequiredMatch = nullptr;
+  std::string const* ErrorMatch = nullptr;
+  std::string const* SkipMatch = nullptr;
   // The test results
   cmCTestTestHandler::cmCTestTestResult TestResult;
   cmCTestMultiProcessHandler& MultiTestHandler;
@@ -31,6 +31,7 @@ void cmCTestTestCommand::BindArguments()
   this->Bind("PARALLEL_LEVEL"_s, this->ParallelLevel);
   this->Bind("REPEAT"_s, this->Repeat);
   this->Bind("SCHEDULE_RANDOM"_s, this->ScheduleRandom);
+  this->Bind("SCHEDULE_CRITICAL_PATH"_s, this->ScheduleCriticalPath);
   this->Bind("STOP_TIME"_s, this->StopTime);
   this->Bind("TEST_LOAD"_s, this->TestLoad);
   this->Bind("RESOURCE_SPEC_FILE"_s, this->ResourceSpecFile);
@@ -103,6 +104,10 @@ cmCTestGenericHandler* cmCTestTestCommand::InitializeHandler()
   if (!this->ScheduleRandom.empty()) {
     handler->SetOption("ScheduleRandom", this->ScheduleRandom.c_str());
   }
+  if (!this->ScheduleCriticalPath.empty()) {
+    handler->SetOption("ScheduleCriticalPath",
+                       this->ScheduleCriticalPath.c_str());
+  }
   if (!this->ResourceSpecFile.empty()) {
     handler->SetOption("ResourceSpecFile", this->ResourceSpecFile.c_str());
   }
@@ -57,6 +57,7 @@ protected:
   std::string ParallelLevel;
   std::string Repeat;
   std::string ScheduleRandom;
+  std::string ScheduleCriticalPath;
   std::string StopTime;
   std::string TestLoad;
   std::string ResourceSpecFile;
@@ -486,6 +486,9 @@ bool cmCTestTestHandler::ProcessOptions()
   if (cmIsOn(this->GetOption("ScheduleRandom"))) {
     this->CTest->SetScheduleType("Random");
   }
+  if (cmIsOn(this->GetOption("ScheduleCriticalPath"))) {
+    this->CTest->SetScheduleType("CriticalPath");
+  }
   if (const char* repeat = this->GetOption("Repeat")) {
     cmsys::RegularExpression repeatRegex(
       "^(UNTIL_FAIL|UNTIL_PASS|AFTER_TIMEOUT):([0-9]+)$");
@@ -557,6 +560,46 @@ bool cmCTestTestHandler::ProcessOptions()
   }
   this->SetRerunFailed(cmIsOn(this->GetOption("RerunFailed")));
 
+  this->TestOutputStream = cmIsOn(this->GetOption("TestOutputStream"));
+  this->TestOutputLogDirectory.clear();
+  val = this->GetOption("TestOutputLogDirectory");
+  if (val) {
+    this->TestOutputStream = true;
+    this->TestOutputLogDirectory =
+      cmSystemTools::CollapseFullPath(val, this->CTest->GetBinaryDir());
+    if (!cmSystemTools::MakeDirectory(this->TestOutputLogDirectory)) {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Cannot create test output log directory "
+                   << this->TestOutputLogDirectory << std::endl);
+      return false;
+    }
+  }
+
+  this->ShardIndex = 0;
+  this->ShardCount = 0;
+  const char* shardIndex = this->GetOption("ShardIndex");
+  const char* shardCount = this->GetOption("ShardCount");
+  if (shardIndex || shardCount) {
+    if (!shardIndex || !shardCount ||
+        !cmStrToULong(shardIndex, &this->ShardIndex) ||
+        !cmStrToULong(shardCount, &this->ShardCount) ||
+        this->ShardCount == 0 || this->ShardIndex >= this->ShardCount) {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Sharding requires both --shard-index and --shard-count, "
+                 "with 0 <= index < count."
+                   << std::endl);
+      return false;
+    }
+    // The failed tests differ from one machine to another, so their
+    // shards would not cover every failed test exactly once.
+    if (this->RerunFailed) {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Sharding cannot be combined with --rerun-failed."
+                   << std::endl);
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -874,6 +917,7 @@ void cmCTestTestHandler::ComputeTestList()
     finalList.push_back(tp);
   }
 
+  this->SelectShard(finalList);
   UpdateForFixtures(finalList);
 
   // Save the total number of tests before exclusions
@@ -913,6 +957,127 @@ void cmCTestTestHandler::ComputeTestListForRerunFailed()
   this->UpdateMaxTestNameWidth();
 }
 
+void cmCTestTestHandler::SelectShard(ListOfTests& tests) const
+{
+  if (this->ShardCount == 0) {
+    return;
+  }
+
+  // Look up the cost of every test as the parallel scheduler does.
+  // Every machine must see the same costs to compute the same shards.
+  std::map<std::string, float> costData;
+  std::string const costFile = this->CTest->GetCostDataFile();
+  if (cmSystemTools::FileExists(costFile, true)) {
+    for (auto const& entry :
+         cmCTestMultiProcessHandler::ReadCostDataFile(costFile).Tests) {
+      costData[entry.Name] = entry.Cost;
+    }
+  }
+  std::vector<float> costs(tests.size(), 0);
+  float knownCost = 0;
+  size_t numKnown = 0;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    costs[i] = tests[i].Cost;
+    if (costs[i] <= 0) {
+      auto it = costData.find(tests[i].Name);
+      costs[i] = it != costData.end() ? it->second : 0;
+    }
+    if (costs[i] > 0) {
+      knownCost += costs[i];
+      ++numKnown;
+    }
+  }
+  float const defaultCost =
+    numKnown > 0 ? knownCost / static_cast<float>(numKnown) : 1;
+
+  // Setup and cleanup tests of fixtures required by other tests are left
+  // to UpdateForFixtures, which adds them to every shard that needs them.
+  std::set<std::string> requiredFixtures;
+  for (cmCTestTestProperties const& p : tests) {
+    requiredFixtures.insert(p.FixturesRequired.begin(),
+                            p.FixturesRequired.end());
+  }
+  auto isFixtureTest = [&requiredFixtures](cmCTestTestProperties const& p) {
+    if (p.FixturesSetup.empty() && p.FixturesCleanup.empty()) {
+      return false;
+    }
+    auto required = [&requiredFixtures](std::string const& f) {
+      return cm::contains(requiredFixtures, f);
+    };
+    return std::all_of(p.FixturesSetup.begin(), p.FixturesSetup.end(),
+                       required) &&
+      std::all_of(p.FixturesCleanup.begin(), p.FixturesCleanup.end(),
+                  required);
+  };
+
+  // Tests connected by DEPENDS form one unit that goes to one shard.
+  std::map<std::string, size_t> indexByName;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    indexByName[tests[i].Name] = i;
+  }
+  std::vector<size_t> unitOf(tests.size());
+  for (size_t i = 0; i < tests.size(); ++i) {
+    unitOf[i] = i;
+  }
+  auto findUnit = [&unitOf](size_t i) {
+    while (unitOf[i] != i) {
+      i = unitOf[i] = unitOf[unitOf[i]];
+    }
+    return i;
+  };
+  for (size_t i = 0; i < tests.size(); ++i) {
+    for (std::string const& dep : tests[i].Depends) {
+      auto it = indexByName.find(dep);
+      if (it != indexByName.end()) {
+        size_t a = findUnit(i);
+        size_t b = findUnit(it->second);
+        // The unit is named by its first test to keep it deterministic.
+        unitOf[std::max(a, b)] = std::min(a, b);
+      }
+    }
+  }
+  std::map<size_t, float> unitCosts;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    float& unitCost = unitCosts[findUnit(i)];
+    if (!isFixtureTest(tests[i])) {
+      unitCost += costs[i] > 0 ? costs[i] : defaultCost;
+    }
+  }
+
+  // Assign the most expensive units first, each to the shard with the
+  // least cost so far.
+  std::vector<std::pair<size_t, float>> units(unitCosts.begin(),
+                                              unitCosts.end());
+  std::stable_sort(units.begin(), units.end(),
+                   [](std::pair<size_t, float> const& l,
+                      std::pair<size_t, float> const& r) {
+                     return l.second > r.second;
+                   });
+  std::vector<double> shardCosts(this->ShardCount, 0);
+  std::map<size_t, size_t> shardOfUnit;
+  for (auto const& unit : units) {
+    auto shard = std::min_element(shardCosts.begin(), shardCosts.end());
+    *shard += unit.second;
+    shardOfUnit[unit.first] =
+      static_cast<size_t>(std::distance(shardCosts.begin(), shard));
+  }
+
+  ListOfTests shardTests;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    if (shardOfUnit[findUnit(i)] == this->ShardIndex &&
+        !isFixtureTest(tests[i])) {
+      shardTests.push_back(tests[i]);
+    }
+  }
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     "Selected " << shardTests.size() << " of "
+                                 << tests.size() << " tests for shard "
+                                 << this->ShardIndex << " of "
+                                 << this->ShardCount << std::endl,
+                     this->Quiet);
+  tests = std::move(shardTests);
+}
+
 void cmCTestTestHandler::UpdateForFixtures(ListOfTests& tests) const
 {
   cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
@@ -2110,11 +2275,11 @@ void cmCTestTestHandler::SetTestsToRunInformation(const char* in)
   }
 }
 
-void cmCTestTestHandler::CleanTestOutput(std::string& output, size_t length)
+size_t cmCTestTestHandler::TruncatedOutputLength(std::string const& output,
+                                                 size_t length)
 {
-  if (!length || length >= output.size() ||
-      output.find("CTEST_FULL_OUTPUT") != std::string::npos) {
-    return;
+  if (length >= output.size()) {
+    return output.size();
   }
 
   // Truncate at given length but do not break in the middle of a multi-byte
@@ -2135,7 +2300,17 @@ void cmCTestTestHandler::CleanTestOutput(std::string& output, size_t length)
       ++current;
     }
   }
-  output.erase(current - begin);
+  return static_cast<size_t>(current - begin);
+}
+
+void cmCTestTestHandler::CleanTestOutput(std::string& output, size_t length)
+{
+  if (!length || length >= output.size() ||
+      output.find("CTEST_FULL_OUTPUT") != std::string::npos) {
+    return;
+  }
+
+  output.erase(TruncatedOutputLength(output, length));
 
   // Append truncation message.
   std::ostringstream msg;
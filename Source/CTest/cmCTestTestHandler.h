@@ -237,6 +237,10 @@ protected:
 
   //! Clean test output to specified length
   void CleanTestOutput(std::string& output, size_t length);
+  //! Length of the output prefix that fits in the given number of bytes
+  //! without breaking a multi-byte UTF-8 encoding
+  static size_t TruncatedOutputLength(std::string const& output,
+                                      size_t length);
 
   cmDuration ElapsedTestingTime;
 
@@ -294,6 +298,10 @@ private:
   // based on LastTestFailed.log
   void ComputeTestListForRerunFailed();
 
+  // keep only the tests of the selected shard, splitting the tests
+  // into shards of similar cost that keep dependent tests together
+  void SelectShard(ListOfTests& tests) const;
+
   // add required setup/cleanup tests not already in the
   // list of tests to be run and update dependencies between
   // tests to account for fixture setup/cleanup
@@ -358,6 +366,10 @@ private:
   cmCTest::Repeat RepeatMode = cmCTest::Repeat::Never;
   int RepeatCount = 1;
   bool RerunFailed;
+  unsigned long ShardIndex = 0;
+  unsigned long ShardCount = 0;
+  bool TestOutputStream = false;
+  std::string TestOutputLogDirectory;
 };
 
 #endif
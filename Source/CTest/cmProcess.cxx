@@ -219,6 +219,12 @@ void cmProcess::OnRead(ssize_t nread, const uv_buf_t* buf)
   if (nread > 0) {
     std::string strdata;
     this->Conv.DecodeText(buf->base, static_cast<size_t>(nread), strdata);
+    if (this->Runner->IsOutputStreamed()) {
+      // The runner keeps a bounded part of the output, so do not buffer
+      // a line of unbounded length here.
+      this->Runner->CheckOutputData(strdata.data(), strdata.size());
+      return;
+    }
     cm::append(this->Output, strdata);
 
     while (this->Output.GetLine(line)) {
@@ -241,7 +247,9 @@ void cmProcess::OnRead(ssize_t nread, const uv_buf_t* buf)
   }
 
   // Look for partial last lines.
-  if (this->Output.GetLast(line)) {
+  if (this->Runner->IsOutputStreamed()) {
+    this->Runner->EndOutputData();
+  } else if (this->Output.GetLast(line)) {
     this->Runner->CheckOutput(line);
   }
 
@@ -0,0 +1,183 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmBitSet_h
+#define cmBitSet_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/** \class cmBitSet
+ * \brief A set of small non-negative integers stored as a bit vector.
+ *
+ * Unions and intersections work on whole words, and iteration yields
+ * the elements in increasing order like a std::set<std::size_t>.  The
+ * storage grows to hold the largest element inserted.
+ */
+class cmBitSet
+{
+  using Word = std::uint64_t;
+  static constexpr std::size_t WordBits = 64;
+
+public:
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::size_t const*;
+    using reference = std::size_t const&;
+
+    const_iterator(std::vector<Word> const* words, std::size_t pos)
+      : Words(words)
+      , Pos(pos)
+    {
+      this->SatisfyPredicate();
+    }
+
+    reference operator*() const { return this->Pos; }
+    pointer operator->() const { return &this->Pos; }
+
+    const_iterator& operator++()
+    {
+      ++this->Pos;
+      this->SatisfyPredicate();
+      return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+      const_iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const_iterator const& other) const
+    {
+      return this->Pos == other.Pos;
+    }
+
+    bool operator!=(const_iterator const& other) const
+    {
+      return this->Pos != other.Pos;
+    }
+
+  private:
+    // Advance to the next element, skipping empty words entirely.
+    void SatisfyPredicate()
+    {
+      std::size_t const end = this->Words->size() * WordBits;
+      while (this->Pos < end) {
+        Word const w = (*this->Words)[this->Pos / WordBits] >>
+          (this->Pos % WordBits);
+        if (w == 0) {
+          this->Pos = (this->Pos / WordBits + 1) * WordBits;
+          continue;
+        }
+        if (w & 1) {
+          return;
+        }
+        ++this->Pos;
+      }
+      this->Pos = end;
+    }
+
+    std::vector<Word> const* Words;
+    std::size_t Pos;
+  };
+
+  const_iterator begin() const { return { &this->Words, 0 }; }
+  const_iterator end() const
+  {
+    return { &this->Words, this->Words.size() * WordBits };
+  }
+
+  bool empty() const
+  {
+    return std::all_of(this->Words.begin(), this->Words.end(),
+                       [](Word w) { return w == 0; });
+  }
+
+  std::size_t size() const
+  {
+    std::size_t n = 0;
+    for (Word w : this->Words) {
+      for (; w != 0; w &= w - 1) {
+        ++n;
+      }
+    }
+    return n;
+  }
+
+  void clear() { this->Words.clear(); }
+
+  bool contains(std::size_t i) const
+  {
+    std::size_t const w = i / WordBits;
+    return w < this->Words.size() &&
+      (this->Words[w] & (Word(1) << (i % WordBits))) != 0;
+  }
+
+  /** Insert @a i and return whether it was not yet in the set.  */
+  bool insert(std::size_t i)
+  {
+    std::size_t const w = i / WordBits;
+    if (w >= this->Words.size()) {
+      this->Words.resize(w + 1);
+    }
+    Word const bit = Word(1) << (i % WordBits);
+    if (this->Words[w] & bit) {
+      return false;
+    }
+    this->Words[w] |= bit;
+    return true;
+  }
+
+  cmBitSet& operator|=(cmBitSet const& other)
+  {
+    if (other.Words.size() > this->Words.size()) {
+      this->Words.resize(other.Words.size());
+    }
+    std::transform(other.Words.begin(), other.Words.end(),
+                   this->Words.begin(), this->Words.begin(),
+                   [](Word a, Word b) { return a | b; });
+    return *this;
+  }
+
+  cmBitSet& operator&=(cmBitSet const& other)
+  {
+    if (this->Words.size() > other.Words.size()) {
+      this->Words.resize(other.Words.size());
+    }
+    std::transform(this->Words.begin(), this->Words.end(),
+                   other.Words.begin(), this->Words.begin(),
+                   [](Word a, Word b) { return a & b; });
+    return *this;
+  }
+
+  friend bool operator==(cmBitSet const& l, cmBitSet const& r)
+  {
+    std::vector<Word> const& s = l.Words.size() < r.Words.size() ? l.Words
+                                                                 : r.Words;
+    std::vector<Word> const& g = l.Words.size() < r.Words.size() ? r.Words
+                                                                 : l.Words;
+    return std::equal(s.begin(), s.end(), g.begin()) &&
+      std::all_of(g.begin() + s.size(), g.end(),
+                  [](Word w) { return w == 0; });
+  }
+
+  friend bool operator!=(cmBitSet const& l, cmBitSet const& r)
+  {
+    return !(l == r);
+  }
+
+private:
+  std::vector<Word> Words;
+};
+
+#endif
@@ -2146,6 +2146,39 @@ bool cmCTest::HandleCommandLineArguments(size_t& i,
     this->GetTestHandler()->SetPersistentOption("RerunFailed", "true");
     this->GetMemCheckHandler()->SetPersistentOption("RerunFailed", "true");
   }
+
+  else if (this->CheckArgument(arg, "--test-output-stream"_s)) {
+    this->GetTestHandler()->SetPersistentOption("TestOutputStream", "true");
+    this->GetMemCheckHandler()->SetPersistentOption("TestOutputStream",
+                                                    "true");
+  }
+
+  else if (this->CheckArgument(arg, "--test-output-log-dir"_s) &&
+           i < args.size() - 1) {
+    i++;
+    this->GetTestHandler()->SetPersistentOption("TestOutputLogDirectory",
+                                                args[i].c_str());
+    this->GetMemCheckHandler()->SetPersistentOption("TestOutputLogDirectory",
+                                                    args[i].c_str());
+  }
+
+  else if (this->CheckArgument(arg, "--shard-index"_s) &&
+           i < args.size() - 1) {
+    i++;
+    this->GetTestHandler()->SetPersistentOption("ShardIndex",
+                                                args[i].c_str());
+    this->GetMemCheckHandler()->SetPersistentOption("ShardIndex",
+                                                    args[i].c_str());
+  }
+
+  else if (this->CheckArgument(arg, "--shard-count"_s) &&
+           i < args.size() - 1) {
+    i++;
+    this->GetTestHandler()->SetPersistentOption("ShardCount",
+                                                args[i].c_str());
+    this->GetMemCheckHandler()->SetPersistentOption("ShardCount",
+                                                    args[i].c_str());
+  }
   return true;
 }
 
@@ -2321,6 +2354,11 @@ int cmCTest::Run(std::vector<std::string>& args, std::string* output)
       this->Impl->ScheduleType = "Random";
     }
 
+    // --schedule-critical-path
+    if (this->CheckArgument(arg, "--schedule-critical-path"_s)) {
+      this->Impl->ScheduleType = "CriticalPath";
+    }
+
     // pass the argument to all the handlers as well, but i may no longer be
     // set to what it was originally so I'm not sure this is working as
     // intended
@@ -95,7 +95,9 @@ const char* cmCommandArgumentParserHelper::ExpandVariable(const char* var)
   }
   const char* value = this->Makefile->GetDefinition(var);
   if (!value) {
-    this->Makefile->MaybeWarnUninitialized(var, this->FileName);
+    if (this->WarnUninitialized) {
+      this->Makefile->MaybeWarnUninitialized(var, this->FileName);
+    }
     if (!this->RemoveEmpty) {
       return nullptr;
     }
@@ -236,6 +238,344 @@ int cmCommandArgumentParserHelper::ParseString(const char* str, int verb)
   return 1;
 }
 
+namespace {
+enum class Token
+{
+  End,
+  Error,
+  Name,
+  Symbol,
+  At,
+  Dollar,
+  LCurly,
+  RCurly,
+  BSlash,
+  EnvCurly,
+  NCurly,
+  DCurly,
+  AtName
+};
+
+// Nesting of variable references beyond which ExpandString leaves the
+// string to the generated parser.
+int const MaxExpandDepth = 1000;
+
+bool IsNameChar(char c)
+{
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+    (c >= '0' && c <= '9') || c == '/' || c == '_' || c == '.' || c == '+' ||
+    c == '-';
+}
+
+bool IsSymbolChar(char c)
+{
+  return c != '$' && c != '{' && c != '}' && c != '\\' && c != '@';
+}
+}
+
+// One token of the lexer in cmCommandArgumentLexer.in.l.  The text is
+// the value the lexer gives the token: the key of $KEY{, the name of
+// @NAME@, the replacement of an escape sequence, or the input matched.
+struct cmCommandArgumentParserHelper::Lexeme
+{
+  Token Kind = Token::End;
+  const char* Text = nullptr;
+  size_t Length = 0;
+};
+
+void cmCommandArgumentParserHelper::Scan(Lexeme& lex)
+{
+  const char* in = this->ScanPos;
+  const char* const end = this->ScanEnd;
+  lex.Text = in;
+  lex.Length = 1;
+  if (in == end) {
+    lex.Kind = Token::End;
+    lex.Length = 0;
+    return;
+  }
+  const char* next = in + 1;
+  switch (*in) {
+    case '$': {
+      while (next != end && IsNameChar(*next)) {
+        ++next;
+      }
+      if (next != in + 1 && next != end && *next == '{') {
+        lex.Text = in + 1;
+        lex.Length = next - lex.Text;
+        lex.Kind = (lex.Length == 3 && strncmp(lex.Text, "ENV", 3) == 0)
+          ? Token::EnvCurly
+          : Token::NCurly;
+        next = next + 1;
+      } else if (in + 1 != end && in[1] == '{') {
+        lex.Kind = Token::DCurly;
+        next = in + 2;
+      } else {
+        lex.Kind = Token::Dollar;
+        next = in + 1;
+      }
+    } break;
+    case '@': {
+      while (next != end && IsNameChar(*next)) {
+        ++next;
+      }
+      if (next != in + 1 && next != end && *next == '@') {
+        lex.Kind = Token::AtName;
+        lex.Text = in + 1;
+        lex.Length = next - lex.Text;
+        next = next + 1;
+      } else {
+        lex.Kind = Token::At;
+        next = in + 1;
+      }
+    } break;
+    case '{':
+      lex.Kind = Token::LCurly;
+      break;
+    case '}':
+      lex.Kind = Token::RCurly;
+      break;
+    case '\\':
+      if (this->NoEscapeMode) {
+        lex.Kind = Token::Symbol;
+      } else if (next == end || *next == '\n') {
+        lex.Kind = Token::BSlash;
+      } else {
+        // Mirror HandleEscapeSymbol.
+        lex.Kind = Token::Symbol;
+        switch (*next) {
+          case '\\':
+          case '"':
+          case ' ':
+          case '#':
+          case '(':
+          case ')':
+          case '$':
+          case '@':
+          case '^':
+            lex.Text = next;
+            break;
+          case ';':
+            lex.Length = 2;
+            break;
+          case 't':
+            lex.Text = "\t";
+            break;
+          case 'n':
+            lex.Text = "\n";
+            break;
+          case 'r':
+            lex.Text = "\r";
+            break;
+          case '0':
+            lex.Length = 0;
+            break;
+          default:
+            lex.Kind = Token::Error;
+            break;
+        }
+        ++next;
+      }
+      break;
+    default: {
+      // The longest match wins, and a name wins a tie with a symbol.
+      while (next != end && IsNameChar(*next)) {
+        ++next;
+      }
+      const char* const nameEnd = IsNameChar(*in) ? next : in;
+      while (next != end && IsSymbolChar(*next)) {
+        ++next;
+      }
+      lex.Kind = next == nameEnd ? Token::Name : Token::Symbol;
+      lex.Length = next - in;
+    } break;
+  }
+  this->ScanPos = next;
+}
+
+bool cmCommandArgumentParserHelper::ExpandString(const char* str)
+{
+  this->Result.clear();
+  if (!str) {
+    return false;
+  }
+  this->ScanPos = str;
+  this->ScanEnd = str + strlen(str);
+
+  // Goal: (OuterText | Variable)* followed by an optional backslash.
+  Lexeme lex;
+  for (this->Scan(lex); lex.Kind != Token::End; this->Scan(lex)) {
+    switch (lex.Kind) {
+      case Token::Name:
+      case Token::Symbol:
+      case Token::At:
+      case Token::Dollar:
+      case Token::LCurly:
+      case Token::RCurly:
+        this->Result.append(lex.Text, lex.Length);
+        break;
+      case Token::EnvCurly:
+      case Token::NCurly:
+      case Token::DCurly:
+      case Token::AtName:
+        if (this->ExpandReference(lex, this->Result, 0) == Piece::Error) {
+          return false;
+        }
+        break;
+      case Token::BSlash:
+        this->Result += '\\';
+        this->Scan(lex);
+        return lex.Kind == Token::End;
+      case Token::End:
+      case Token::Error:
+        return false;
+    }
+  }
+  return true;
+}
+
+cmCommandArgumentParserHelper::Piece
+cmCommandArgumentParserHelper::ExpandReference(Lexeme const& open,
+                                               std::string& out, int depth)
+{
+  if (open.Kind == Token::AtName) {
+    std::string const var(open.Text, open.Length);
+    if (this->ReplaceAtSyntax &&
+        this->AppendVariable(var, out) == Piece::Present) {
+      return Piece::Present;
+    }
+    out += '@';
+    out += var;
+    out += '@';
+    return Piece::Present;
+  }
+  if (depth > MaxExpandDepth) {
+    return Piece::Error;
+  }
+
+  // The name is MultipleIds, except that $ENV{} also takes symbols of
+  // which the generated parser keeps only the first.
+  std::string var;
+  Piece varPiece;
+  Lexeme lex;
+  this->Scan(lex);
+  if (open.Kind == Token::EnvCurly && lex.Kind == Token::Symbol) {
+    var.assign(lex.Text, lex.Length);
+    varPiece = Piece::Present;
+    do {
+      this->Scan(lex);
+    } while (lex.Kind == Token::Symbol);
+    std::string ignored;
+    if (this->ExpandNames(lex, ignored, depth) == Piece::Error) {
+      return Piece::Error;
+    }
+  } else {
+    varPiece = this->ExpandNames(lex, var, depth);
+  }
+  if (varPiece == Piece::Error || lex.Kind != Token::RCurly) {
+    return Piece::Error;
+  }
+
+  if (open.Kind == Token::DCurly) {
+    if (varPiece == Piece::Missing) {
+      return Piece::Missing;
+    }
+    return this->AppendVariable(var, out);
+  }
+  return this->AppendSpecialVariable(std::string(open.Text, open.Length),
+                                     varPiece, var, out);
+}
+
+cmCommandArgumentParserHelper::Piece
+cmCommandArgumentParserHelper::ExpandNames(Lexeme& lex, std::string& out,
+                                           int depth)
+{
+  Piece result = Piece::Missing;
+  for (;; this->Scan(lex)) {
+    switch (lex.Kind) {
+      case Token::Name:
+        out.append(lex.Text, lex.Length);
+        result = Piece::Present;
+        break;
+      case Token::EnvCurly:
+      case Token::NCurly:
+      case Token::DCurly:
+      case Token::AtName:
+        switch (this->ExpandReference(lex, out, depth + 1)) {
+          case Piece::Missing:
+            break;
+          case Piece::Present:
+            result = Piece::Present;
+            break;
+          case Piece::Error:
+            return Piece::Error;
+        }
+        break;
+      default:
+        return result;
+    }
+  }
+}
+
+cmCommandArgumentParserHelper::Piece
+cmCommandArgumentParserHelper::AppendVariable(std::string const& var,
+                                              std::string& out)
+{
+  if (this->FileLine >= 0 && var == "CMAKE_CURRENT_LIST_LINE") {
+    out += std::to_string(this->FileLine);
+    return Piece::Present;
+  }
+  const char* value = this->Makefile->GetDefinition(var);
+  if (!value) {
+    if (this->WarnUninitialized) {
+      this->Makefile->MaybeWarnUninitialized(var, this->FileName);
+    }
+    return this->RemoveEmpty ? Piece::Present : Piece::Missing;
+  }
+  this->AppendValue(value, out);
+  return Piece::Present;
+}
+
+cmCommandArgumentParserHelper::Piece
+cmCommandArgumentParserHelper::AppendSpecialVariable(std::string const& key,
+                                                     Piece varPiece,
+                                                     std::string const& var,
+                                                     std::string& out)
+{
+  if (varPiece == Piece::Missing) {
+    return Piece::Present;
+  }
+  if (key == "ENV") {
+    std::string str;
+    if (cmSystemTools::GetEnv(var, str)) {
+      this->AppendValue(str.c_str(), out);
+    }
+    return Piece::Present;
+  }
+  if (key == "CACHE") {
+    if (cmProp c = this->Makefile->GetState()->GetInitializedCacheValue(var)) {
+      this->AppendValue(c->c_str(), out);
+    }
+    return Piece::Present;
+  }
+  return Piece::Error;
+}
+
+void cmCommandArgumentParserHelper::AppendValue(const char* value,
+                                                std::string& out) const
+{
+  if (!this->EscapeQuotes) {
+    out += value;
+    return;
+  }
+  for (; *value; ++value) {
+    if (*value == '"') {
+      out += '\\';
+    }
+    out += *value;
+  }
+}
+
 void cmCommandArgumentParserHelper::CleanupParser()
 {
   this->Variables.clear();
@@ -28,6 +28,10 @@ public:
 
   int ParseString(const char* str, int verb);
 
+  // Expand a string without the generated parser.  Returns false if the
+  // string has an error, which ParseString must then be used to report.
+  bool ExpandString(const char* str);
+
   // For the lexer:
   void AllocateParserType(cmCommandArgumentParserHelper::ParserType* pt,
                           const char* str, int len = 0);
@@ -54,6 +58,7 @@ public:
   void SetNoEscapeMode(bool b) { this->NoEscapeMode = b; }
   void SetReplaceAtSyntax(bool b) { this->ReplaceAtSyntax = b; }
   void SetRemoveEmpty(bool b) { this->RemoveEmpty = b; }
+  void SetWarnUninitialized(bool b) { this->WarnUninitialized = b; }
 
   const char* GetError() { return this->ErrorString.c_str(); }
 
@@ -70,6 +75,25 @@ private:
   void CleanupParser();
   void SetError(std::string const& msg);
 
+  // The hand-written expander behind ExpandString.  A missing piece is
+  // one for which the generated parser would produce a null string.
+  enum class Piece
+  {
+    Missing,
+    Present,
+    Error
+  };
+  struct Lexeme;
+  void Scan(Lexeme& lex);
+  Piece ExpandReference(Lexeme const& open, std::string& out, int depth);
+  Piece ExpandNames(Lexeme& lex, std::string& out, int depth);
+  Piece AppendVariable(std::string const& var, std::string& out);
+  Piece AppendSpecialVariable(std::string const& key, Piece varPiece,
+                              std::string const& var, std::string& out);
+  void AppendValue(const char* value, std::string& out) const;
+  const char* ScanPos = nullptr;
+  const char* ScanEnd = nullptr;
+
   std::vector<std::unique_ptr<char[]>> Variables;
   const cmMakefile* Makefile;
   std::string Result;
@@ -82,6 +106,7 @@ private:
   bool NoEscapeMode;
   bool ReplaceAtSyntax;
   bool RemoveEmpty;
+  bool WarnUninitialized = true;
 };
 
 #define YYSTYPE cmCommandArgumentParserHelper::ParserType
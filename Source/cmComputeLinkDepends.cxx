@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdio>
 #include <cstring>
 #include <iterator>
@@ -577,17 +578,15 @@ void cmComputeLinkDepends::InferDependencies()
     // Intersect the sets for this item.
     DependSet common = sets.front();
     for (DependSet const& i : cmMakeRange(sets).advance(1)) {
-      DependSet intersection;
-      std::set_intersection(common.begin(), common.end(), i.begin(), i.end(),
-                            std::inserter(intersection, intersection.begin()));
-      common = intersection;
+      common &= i;
     }
 
     // Add the inferred dependencies to the graph.
     cmGraphEdgeList& edges = this->EntryConstraintGraph[depender_index];
     edges.reserve(edges.size() + common.size());
-    for (auto const& c : common) {
-      edges.emplace_back(c, true, false, cmListFileBacktrace());
+    for (std::size_t const c : common) {
+      edges.emplace_back(static_cast<int>(c), true, false,
+                         cmListFileBacktrace());
     }
   }
 }
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "cmBitSet.h"
 #include "cmGraphAdjacencyList.h"
 #include "cmLinkItem.h"
 #include "cmListFileCache.h"
@@ -102,7 +103,7 @@ private:
   void HandleSharedDependency(SharedDepEntry const& dep);
 
   // Dependency inferral for each link item.
-  struct DependSet : public std::set<int>
+  struct DependSet : public cmBitSet
   {
   };
   struct DependSetList : public std::vector<DependSet>
@@ -2,15 +2,23 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmCoreTryCompile.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <memory>
 #include <set>
 #include <sstream>
+#include <thread>
 #include <utility>
 
+#include <cm/memory>
 #include <cmext/string_view>
 
 #include "cmsys/Directory.hxx"
+#include "cmsys/FStream.hxx"
+#include "cmsys/RegularExpression.hxx"
 
 #include "cmExportTryCompileFileGenerator.h"
 #include "cmGlobalGenerator.h"
@@ -26,6 +34,10 @@
 #include "cmVersion.h"
 #include "cmake.h"
 
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmCryptoHash.h"
+#endif
+
 namespace {
 class LanguageStandardState
 {
@@ -213,6 +225,8 @@ std::string const kCMAKE_POSITION_INDEPENDENT_CODE =
 std::string const kCMAKE_SYSROOT = "CMAKE_SYSROOT";
 std::string const kCMAKE_SYSROOT_COMPILE = "CMAKE_SYSROOT_COMPILE";
 std::string const kCMAKE_SYSROOT_LINK = "CMAKE_SYSROOT_LINK";
+std::string const kCMAKE_TRY_COMPILE_CACHE_DIR =
+  "CMAKE_TRY_COMPILE_CACHE_DIR";
 std::string const kCMAKE_TRY_COMPILE_OSX_ARCHITECTURES =
   "CMAKE_TRY_COMPILE_OSX_ARCHITECTURES";
 std::string const kCMAKE_TRY_COMPILE_PLATFORM_VARIABLES =
@@ -225,6 +239,323 @@ std::set<std::string> const ghs_platform_vars{
   "GHS_OS_ROOT",         "GHS_OS_DIR",         "GHS_BSP_NAME",
   "GHS_OS_DIR_OPTION"
 };
+
+#if !defined(CMAKE_BOOTSTRAP)
+/* Environment variables consulted by compilers and linkers that are not
+   captured by the platform information files.  */
+std::vector<std::string> const resultCacheEnvironment{ "INCLUDE", "LIB",
+                                                       "SDKROOT" };
+
+/* Environment variables adding include or library directories of the
+   user to those of the compiler.  */
+std::vector<std::string> const resultCacheUserPathEnvironment{
+  "CPATH", "C_INCLUDE_PATH", "CPLUS_INCLUDE_PATH", "OBJC_INCLUDE_PATH",
+  "LIBRARY_PATH"
+};
+
+/** Return whether a test project may read headers or libraries other than
+    its sources and those of the compiler, which the result cache key does
+    not cover: through include or link directories given by the caller or
+    the environment, or through libraries named by path or flag.  */
+bool UsesUserFiles(std::string const& project,
+                   std::vector<std::string> const& cmakeFlags,
+                   std::vector<std::string> const& linkLibraries)
+{
+  for (std::string const& var : resultCacheUserPathEnvironment) {
+    std::string value;
+    if (cmSystemTools::GetEnv(var, value) && !value.empty()) {
+      return true;
+    }
+  }
+
+  // Compiler and linker flags naming directories or forced includes,
+  // anywhere in the generated project or the forwarded CMAKE_FLAGS.
+  cmsys::RegularExpression pathFlag(
+    "(^|[][ \"'=;])(-I|-isystem|-iquote|-idirafter|-imacros|-include|-L|-F|"
+    "-Wl,-L|/I[^A-Z]|/FI|[-/]LIBPATH:)");
+  if (pathFlag.find(project)) {
+    return true;
+  }
+  cmsys::RegularExpression plainLibrary("^(-l)?[A-Za-z0-9_.+-]+$");
+  auto isPlainLibrary = [&plainLibrary](std::string const& lib) {
+    return plainLibrary.find(lib);
+  };
+  for (std::string const& flag : cmakeFlags) {
+    if (pathFlag.find(flag)) {
+      return true;
+    }
+    std::string::size_type const eq = flag.find('=');
+    if (eq == std::string::npos || !cmHasLiteralPrefix(flag, "-D")) {
+      continue;
+    }
+    // The definition is -D<name>[:<type>]=<value>.
+    std::string name = flag.substr(2, eq - 2);
+    name = name.substr(0, name.find(':'));
+    std::vector<std::string> const values =
+      cmExpandedList(flag.substr(eq + 1));
+    if (((name == "INCLUDE_DIRECTORIES" || name == "LINK_DIRECTORIES") &&
+         !values.empty()) ||
+        (name == "LINK_LIBRARIES" &&
+         !std::all_of(values.begin(), values.end(), isPlainLibrary))) {
+      return true;
+    }
+  }
+  return !std::all_of(linkLibraries.begin(), linkLibraries.end(),
+                      isPlainLibrary);
+}
+
+bool ReadFileContent(std::string const& path, std::string& content)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>(fin),
+                 std::istreambuf_iterator<char>());
+  return !fin.bad();
+}
+
+/** Stores the outcome of source file signature try_compile calls in a
+    directory shared between build trees.  Entries are keyed by a hash of
+    the generated test project, the sources, the compiler information and
+    the environment.  The random target name and the binary directory are
+    replaced by placeholders so that equal tests from different build
+    trees map to the same entry.  */
+class TryCompileResultCache
+{
+public:
+  TryCompileResultCache(std::string directory, std::string binaryDirectory,
+                        std::string targetName)
+    : Directory(std::move(directory))
+    , BinaryDirectory(std::move(binaryDirectory))
+    , TargetName(std::move(targetName))
+    , Hasher(cmCryptoHash::AlgoSHA256)
+  {
+    this->Hasher.Initialize();
+  }
+
+  void AddKey(std::string const& text)
+  {
+    std::string const normalized = this->Normalize(text);
+    this->Hasher.Append(cmStrCat(normalized.size(), ':'));
+    this->Hasher.Append(normalized);
+  }
+
+  bool AddKeyFile(std::string const& path)
+  {
+    std::string content;
+    if (!ReadFileContent(path, content)) {
+      return false;
+    }
+    this->AddKey(content);
+    return true;
+  }
+
+  /** Load a cached successful outcome and restore the built file into
+      the binary directory.  */
+  bool Load(int& result, std::string& output)
+  {
+    std::string const entry = this->GetEntryDirectory();
+    std::string content;
+    if (!ReadFileContent(cmStrCat(entry, "/result.txt"), content)) {
+      return false;
+    }
+    std::istringstream in(content);
+    std::string header;
+    std::string code;
+    std::string outputFile;
+    if (!std::getline(in, header) || header != kEntryHeader ||
+        !std::getline(in, code) || !std::getline(in, outputFile)) {
+      return false;
+    }
+    if (code != "0" || outputFile.empty()) {
+      return false;
+    }
+    std::string const dest =
+      cmStrCat(this->BinaryDirectory, '/', this->Restore(outputFile));
+    cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(dest));
+    if (!cmSystemTools::CopyFileAlways(cmStrCat(entry, "/output"), dest)) {
+      return false;
+    }
+    result = 0;
+    output = this->Restore(content.substr(static_cast<size_t>(in.tellg())));
+    return true;
+  }
+
+  /** Store a successful outcome.  Failures are not stored because they
+      may come from a transient problem, such as a full disk or a killed
+      compiler, that must not outlive the build tree that saw it.
+      Concurrent configure runs may store the same entry, so each one
+      writes a private directory and renames it.  */
+  void Store(std::string const& output, std::string const& outputFile)
+  {
+    std::string const prefix =
+      cmStrCat(cmSystemTools::CollapseFullPath(this->BinaryDirectory), '/');
+    if (!cmHasPrefix(outputFile, prefix)) {
+      return;
+    }
+    std::string const relativeOutputFile = outputFile.substr(prefix.size());
+
+    std::string const entry = this->GetEntryDirectory();
+    std::string const tmp = cmStrCat(entry, ".tmp",
+                                     cmSystemTools::RandomSeed() & 0xFFFFF);
+    if (!cmSystemTools::MakeDirectory(tmp)) {
+      return;
+    }
+    bool ok =
+      cmSystemTools::CopyFileAlways(outputFile, cmStrCat(tmp, "/output"));
+    if (ok) {
+      cmsys::ofstream fout(cmStrCat(tmp, "/result.txt").c_str(),
+                           std::ios::out | std::ios::binary);
+      fout << kEntryHeader << '\n'
+           << "0\n"
+           << this->Normalize(relativeOutputFile) << '\n'
+           << this->Normalize(output);
+      fout.close();
+      ok = static_cast<bool>(fout);
+    }
+    if (!ok || !cmSystemTools::RenameFile(tmp, entry)) {
+      cmSystemTools::RemoveADirectory(tmp);
+    }
+  }
+
+private:
+  std::string GetEntryDirectory()
+  {
+    if (this->Entry.empty()) {
+      std::string const hash = this->Hasher.FinalizeHex();
+      this->Entry = cmStrCat(this->Directory, '/', hash.substr(0, 2), '/',
+                             hash.substr(2));
+      cmSystemTools::MakeDirectory(cmStrCat(this->Directory, '/',
+                                            hash.substr(0, 2)));
+    }
+    return this->Entry;
+  }
+
+  std::string Normalize(std::string text) const
+  {
+    cmSystemTools::ReplaceString(text, this->BinaryDirectory,
+                                 kBinaryDirectoryPlaceholder);
+    cmSystemTools::ReplaceString(text, this->TargetName,
+                                 kTargetNamePlaceholder);
+    return text;
+  }
+
+  std::string Restore(std::string text) const
+  {
+    cmSystemTools::ReplaceString(text, kBinaryDirectoryPlaceholder,
+                                 this->BinaryDirectory);
+    cmSystemTools::ReplaceString(text, kTargetNamePlaceholder,
+                                 this->TargetName);
+    return text;
+  }
+
+  static char const* const kEntryHeader;
+  static char const* const kBinaryDirectoryPlaceholder;
+  static char const* const kTargetNamePlaceholder;
+
+  std::string Directory;
+  std::string BinaryDirectory;
+  std::string TargetName;
+  std::string Entry;
+  cmCryptoHash Hasher;
+};
+
+char const* const TryCompileResultCache::kEntryHeader =
+  "cmake-try-compile-result 1";
+char const* const TryCompileResultCache::kBinaryDirectoryPlaceholder =
+  "@CMAKE_TRY_COMPILE_BINARY_DIR@";
+char const* const TryCompileResultCache::kTargetNamePlaceholder =
+  "@CMAKE_TRY_COMPILE_TARGET@";
+
+/** Create the result cache lookup for a source file signature test project
+    that has been written to the binary directory, or return null if the
+    cache is not enabled or the project cannot be hashed.  */
+std::unique_ptr<TryCompileResultCache> CreateResultCache(
+  cmMakefile* mf, std::string const& binaryDirectory,
+  std::string const& targetName, cmStateEnums::TargetType targetType,
+  std::vector<std::string> const& sources,
+  std::set<std::string> const& testLangs,
+  std::vector<std::string> const& cmakeFlags,
+  std::vector<std::string> const& linkLibraries, bool hasImportedTargets)
+{
+  std::string directory = mf->GetSafeDefinition(kCMAKE_TRY_COMPILE_CACHE_DIR);
+  if (directory.empty()) {
+    cmSystemTools::GetEnv(kCMAKE_TRY_COMPILE_CACHE_DIR, directory);
+  }
+  if (directory.empty() || mf->GetCMakeInstance()->GetDebugTryCompile()) {
+    return nullptr;
+  }
+  directory = cmSystemTools::CollapseFullPath(directory);
+  if (!cmSystemTools::MakeDirectory(directory)) {
+    return nullptr;
+  }
+
+  // Imported targets name their files by location.
+  std::string project;
+  if (hasImportedTargets ||
+      !ReadFileContent(cmStrCat(binaryDirectory, "/CMakeLists.txt"),
+                       project) ||
+      UsesUserFiles(project, cmakeFlags, linkLibraries)) {
+    return nullptr;
+  }
+
+  auto cache = cm::make_unique<TryCompileResultCache>(
+    directory, binaryDirectory, targetName);
+  cmGlobalGenerator* gg = mf->GetGlobalGenerator();
+  cache->AddKey(cmVersion::GetCMakeVersion());
+  cache->AddKey(gg->GetName());
+  cache->AddKey(mf->GetSafeDefinition("CMAKE_GENERATOR_PLATFORM"));
+  cache->AddKey(mf->GetSafeDefinition("CMAKE_GENERATOR_TOOLSET"));
+  cache->AddKey(cmState::GetTargetTypeName(targetType));
+  cache->AddKey(mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION"));
+  cache->AddKey(project);
+  for (std::string const& flag : cmakeFlags) {
+    cache->AddKey(flag);
+  }
+  for (std::string const& source : sources) {
+    if (!cache->AddKeyFile(source)) {
+      return nullptr;
+    }
+  }
+
+  // The platform information files identify the compiler.  Also hash
+  // the compiler time stamp to notice in-place upgrades.
+  std::string const platformInfoDir =
+    mf->GetSafeDefinition("CMAKE_PLATFORM_INFO_DIR");
+  for (std::string const& lang : testLangs) {
+    if (!cache->AddKeyFile(
+          cmStrCat(platformInfoDir, "/CMake", lang, "Compiler.cmake"))) {
+      return nullptr;
+    }
+    std::string const compiler =
+      mf->GetSafeDefinition(cmStrCat("CMAKE_", lang, "_COMPILER"));
+    cache->AddKey(std::to_string(cmSystemTools::ModifiedTime(compiler)));
+  }
+  for (std::string const& var : resultCacheEnvironment) {
+    std::string value;
+    cmSystemTools::GetEnv(var, value);
+    cache->AddKey(cmStrCat(var, '=', value));
+  }
+  return cache;
+}
+#endif
+
+/** Return the number of jobs to build a batch of checks with.  Like
+    "cmake --build", honor the CMAKE_BUILD_PARALLEL_LEVEL environment
+    variable, but default to the number of processors and never run more
+    jobs than there are checks.  */
+int GetBatchBuildJobs(size_t checks)
+{
+  unsigned long jobs = std::max(1u, std::thread::hardware_concurrency());
+  std::string parallel;
+  unsigned long level = 0;
+  if (cmSystemTools::GetEnv("CMAKE_BUILD_PARALLEL_LEVEL", parallel) &&
+      cmStrToULong(parallel, &level) && level > 0) {
+    jobs = level;
+  }
+  return static_cast<int>(std::min<unsigned long>(jobs, checks));
+}
 }
 
 int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
@@ -272,6 +603,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   LanguageStandardState objcxxState("OBJCXX");
   std::vector<std::string> targets;
   std::vector<std::string> linkOptions;
+  std::vector<std::string> linkLibraries;
   std::string libsToLink = " ";
   bool useOldLinkLibs = true;
   char targetNameBuf[64];
@@ -279,7 +611,12 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   bool didCopyFile = false;
   bool didCopyFileError = false;
   bool useSources = argv[2] == "SOURCES";
+  bool useBatch = argv[2] == "BATCH";
   std::vector<std::string> sources;
+  std::vector<std::string> batchArgs;
+  std::vector<std::string> batchTargets;
+  std::vector<std::pair<std::string, std::vector<std::string>>> tcTargets;
+  std::set<std::string> testLangs;
 
   enum Doing
   {
@@ -292,9 +629,12 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     DoingCopyFile,
     DoingCopyFileError,
     DoingSources,
+    DoingBatch,
     DoingCMakeInternal
   };
-  Doing doing = useSources ? DoingSources : DoingNone;
+  Doing doing = useSources ? DoingSources
+                           : useBatch ? DoingBatch
+                                      : DoingNone;
   for (size_t i = 3; i < argv.size(); ++i) {
     if (argv[i] == "CMAKE_FLAGS") {
       doing = DoingCMakeFlags;
@@ -330,6 +670,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       linkOptions.push_back(argv[i]);
     } else if (doing == DoingLinkLibraries) {
       libsToLink += "\"" + cmTrimWhitespace(argv[i]) + "\" ";
+      linkLibraries.push_back(cmTrimWhitespace(argv[i]));
       if (cmTarget* tgt = this->Makefile->FindTargetToUse(argv[i])) {
         switch (tgt->GetType()) {
           case cmStateEnums::SHARED_LIBRARY:
@@ -366,6 +707,8 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       doing = DoingNone;
     } else if (doing == DoingSources) {
       sources.push_back(argv[i]);
+    } else if (doing == DoingBatch) {
+      batchArgs.push_back(argv[i]);
     } else if (doing == DoingCMakeInternal) {
       cmakeInternal = argv[i];
       doing = DoingNone;
@@ -415,6 +758,26 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     return -1;
   }
 
+  if (useBatch) {
+    if (isTryRun) {
+      this->Makefile->IssueMessage(MessageType::FATAL_ERROR,
+                                   "BATCH may not be used with try_run");
+      return -1;
+    }
+    if (batchArgs.empty() || batchArgs.size() % 2 != 0) {
+      this->Makefile->IssueMessage(
+        MessageType::FATAL_ERROR,
+        "BATCH must be followed by pairs of a result variable and a "
+        "source file");
+      return -1;
+    }
+    if (didCopyFile) {
+      this->Makefile->IssueMessage(MessageType::FATAL_ERROR,
+                                   "COPY_FILE may not be used with BATCH");
+      return -1;
+    }
+  }
+
   if (!this->SrcFileSignature) {
     if (!cState.Validate(this->Makefile)) {
       return -1;
@@ -472,13 +835,16 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     cmSystemTools::RemoveFile(ccFile);
 
     // Choose sources.
-    if (!useSources) {
+    if (useBatch) {
+      for (size_t i = 1; i < batchArgs.size(); i += 2) {
+        sources.push_back(batchArgs[i]);
+      }
+    } else if (!useSources) {
       sources.push_back(argv[2]);
     }
 
     // Detect languages to enable.
     cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
-    std::set<std::string> testLangs;
     for (std::string const& si : sources) {
       std::string ext = cmSystemTools::GetFilenameLastExtension(si);
       std::string lang = gg->GetLanguageFromExtension(ext.c_str());
@@ -668,6 +1034,18 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     sprintf(targetNameBuf, "cmTC_%05x", cmSystemTools::RandomSeed() & 0xFFFFF);
     targetName = targetNameBuf;
 
+    // A batch builds one target per check; otherwise a single target
+    // builds all the sources.
+    if (useBatch) {
+      for (size_t i = 0; i < batchArgs.size(); i += 2) {
+        batchTargets.push_back(cmStrCat(targetName, '_', i / 2));
+        tcTargets.emplace_back(batchTargets.back(),
+                               std::vector<std::string>{ batchArgs[i + 1] });
+      }
+    } else {
+      tcTargets.emplace_back(targetName, sources);
+    }
+
     if (!targets.empty()) {
       std::string fname = "/" + std::string(targetName) + "Targets.cmake";
       cmExportTryCompileFileGenerator tcfg(gg, targets, this->Makefile,
@@ -788,25 +1166,31 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       /* Put the executable at a known location (for COPY_FILE).  */
       fprintf(fout, "set(CMAKE_RUNTIME_OUTPUT_DIRECTORY \"%s\")\n",
               this->BinaryDirectory.c_str());
-      /* Create the actual executable.  */
-      fprintf(fout, "add_executable(%s", targetName.c_str());
     } else // if (targetType == cmStateEnums::STATIC_LIBRARY)
     {
       /* Put the static library at a known location (for COPY_FILE).  */
       fprintf(fout, "set(CMAKE_ARCHIVE_OUTPUT_DIRECTORY \"%s\")\n",
               this->BinaryDirectory.c_str());
-      /* Create the actual static library.  */
-      fprintf(fout, "add_library(%s STATIC", targetName.c_str());
     }
-    for (std::string const& si : sources) {
-      fprintf(fout, " \"%s\"", si.c_str());
+    for (auto const& tcTarget : tcTargets) {
+      if (targetType == cmStateEnums::EXECUTABLE) {
+        /* Create the actual executable.  */
+        fprintf(fout, "add_executable(%s", tcTarget.first.c_str());
+      } else // if (targetType == cmStateEnums::STATIC_LIBRARY)
+      {
+        /* Create the actual static library.  */
+        fprintf(fout, "add_library(%s STATIC", tcTarget.first.c_str());
+      }
+      for (std::string const& si : tcTarget.second) {
+        fprintf(fout, " \"%s\"", si.c_str());
 
-      // Add dependencies on any non-temporary sources.
-      if (si.find("CMakeTmp") == std::string::npos) {
-        this->Makefile->AddCMakeDependFile(si);
+        // Add dependencies on any non-temporary sources.
+        if (si.find("CMakeTmp") == std::string::npos) {
+          this->Makefile->AddCMakeDependFile(si);
+        }
       }
+      fprintf(fout, ")\n");
     }
-    fprintf(fout, ")\n");
 
     cState.Enabled(testLangs.find("C") != testLangs.end());
     cxxState.Enabled(testLangs.find("CXX") != testLangs.end());
@@ -867,36 +1251,40 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       this->Makefile->IssueMessage(MessageType::AUTHOR_WARNING, w.str());
     }
 
-    cState.WriteProperties(fout, targetName);
-    cxxState.WriteProperties(fout, targetName);
-    cudaState.WriteProperties(fout, targetName);
-    objcState.WriteProperties(fout, targetName);
-    objcxxState.WriteProperties(fout, targetName);
+    std::vector<std::string> options;
+    options.reserve(linkOptions.size());
+    for (const auto& option : linkOptions) {
+      options.emplace_back(cmOutputConverter::EscapeForCMake(option));
+    }
+
+    for (auto const& tcTarget : tcTargets) {
+      std::string const& tcName = tcTarget.first;
+      cState.WriteProperties(fout, tcName);
+      cxxState.WriteProperties(fout, tcName);
+      cudaState.WriteProperties(fout, tcName);
+      objcState.WriteProperties(fout, tcName);
+      objcxxState.WriteProperties(fout, tcName);
 
-    if (!linkOptions.empty()) {
-      std::vector<std::string> options;
-      options.reserve(linkOptions.size());
-      for (const auto& option : linkOptions) {
-        options.emplace_back(cmOutputConverter::EscapeForCMake(option));
+      if (!options.empty()) {
+        if (targetType == cmStateEnums::STATIC_LIBRARY) {
+          fprintf(
+            fout,
+            "set_property(TARGET %s PROPERTY STATIC_LIBRARY_OPTIONS %s)\n",
+            tcName.c_str(), cmJoin(options, " ").c_str());
+        } else {
+          fprintf(fout, "target_link_options(%s PRIVATE %s)\n",
+                  tcName.c_str(), cmJoin(options, " ").c_str());
+        }
       }
 
-      if (targetType == cmStateEnums::STATIC_LIBRARY) {
-        fprintf(fout,
-                "set_property(TARGET %s PROPERTY STATIC_LIBRARY_OPTIONS %s)\n",
-                targetName.c_str(), cmJoin(options, " ").c_str());
+      if (useOldLinkLibs) {
+        fprintf(fout, "target_link_libraries(%s ${LINK_LIBRARIES})\n",
+                tcName.c_str());
       } else {
-        fprintf(fout, "target_link_options(%s PRIVATE %s)\n",
-                targetName.c_str(), cmJoin(options, " ").c_str());
+        fprintf(fout, "target_link_libraries(%s %s)\n", tcName.c_str(),
+                libsToLink.c_str());
       }
     }
-
-    if (useOldLinkLibs) {
-      fprintf(fout, "target_link_libraries(%s ${LINK_LIBRARIES})\n",
-              targetName.c_str());
-    } else {
-      fprintf(fout, "target_link_libraries(%s %s)\n", targetName.c_str(),
-              libsToLink.c_str());
-    }
     fclose(fout);
     projectName = "CMAKE_TRY_COMPILE";
   }
@@ -911,16 +1299,44 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     }
   }
 
-  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
-  cmSystemTools::ResetErrorOccuredFlag();
   std::string output;
-  // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(
-    sourceDirectory, this->BinaryDirectory, projectName, targetName,
-    this->SrcFileSignature, cmake::NO_BUILD_PARALLEL_LEVEL, &cmakeFlags,
-    output);
-  if (erroroc) {
-    cmSystemTools::SetErrorOccured();
+  int res = -1;
+#if !defined(CMAKE_BOOTSTRAP)
+  std::unique_ptr<TryCompileResultCache> resultCache;
+  if (this->SrcFileSignature && cmakeInternal.empty() && !useBatch) {
+    resultCache =
+      CreateResultCache(this->Makefile, this->BinaryDirectory, targetName,
+                        targetType, sources, testLangs, cmakeFlags,
+                        linkLibraries, !targets.empty());
+  }
+  bool const cached = resultCache && resultCache->Load(res, output);
+#else
+  bool const cached = false;
+#endif
+
+  if (!cached) {
+    bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+    cmSystemTools::ResetErrorOccuredFlag();
+    // actually do the try compile now that everything is setup.  The
+    // checks of a batch are independent, so build them in parallel and
+    // do not let one failed check stop the others.
+    std::vector<std::string> buildTargets = batchTargets;
+    int jobs = cmake::NO_BUILD_PARALLEL_LEVEL;
+    if (useBatch) {
+      jobs = GetBatchBuildJobs(batchTargets.size());
+    } else if (!targetName.empty()) {
+      buildTargets.push_back(targetName);
+    }
+    res = this->Makefile->TryCompile(
+      sourceDirectory, this->BinaryDirectory, projectName, buildTargets,
+      this->SrcFileSignature, jobs, &cmakeFlags, output, useBatch);
+    if (useBatch) {
+      res = this->EvaluateBatch(batchArgs, batchTargets, targetType,
+                                sourceDirectory, projectName, res, output);
+    }
+    if (erroroc) {
+      cmSystemTools::SetErrorOccured();
+    }
   }
 
   // set the result var to the return value to indicate success or failure
@@ -936,6 +1352,12 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     std::string copyFileErrorMessage;
     this->FindOutputFile(targetName, targetType);
 
+#if !defined(CMAKE_BOOTSTRAP)
+    if (resultCache && !cached && res == 0 && !this->OutputFile.empty()) {
+      resultCache->Store(output, this->OutputFile);
+    }
+#endif
+
     if ((res == 0) && !copyFile.empty()) {
       if (this->OutputFile.empty() ||
           !cmSystemTools::CopyFileAlways(this->OutputFile, copyFile)) {
@@ -964,6 +1386,43 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   return res;
 }
 
+int cmCoreTryCompile::EvaluateBatch(
+  std::vector<std::string> const& batchArgs,
+  std::vector<std::string> const& batchTargets,
+  cmStateEnums::TargetType targetType, std::string const& sourceDirectory,
+  std::string const& projectName, int res, std::string& output)
+{
+  // The checks whose output exists did build.  If the native build tool
+  // cannot keep going, a failed check stops the build of the whole batch
+  // and some checks may not have been built at all, so build each
+  // remaining check on its own to find its result.
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+  bool const keptGoing = !gg->GetKeepGoingBuildOptions().empty();
+  bool allPassed = true;
+  for (size_t i = 0; i < batchTargets.size(); ++i) {
+    bool passed = res == 0;
+    if (!passed) {
+      this->FindOutputFile(batchTargets[i], targetType);
+      passed = !this->OutputFile.empty();
+    }
+    if (!passed && !keptGoing && !cmSystemTools::GetFatalErrorOccured()) {
+      std::string checkOutput;
+      passed = gg->TryCompile(cmake::NO_BUILD_PARALLEL_LEVEL, sourceDirectory,
+                              this->BinaryDirectory, projectName,
+                              { batchTargets[i] }, true, checkOutput,
+                              this->Makefile) == 0;
+      output += checkOutput;
+    }
+    this->Makefile->AddCacheDefinition(batchArgs[2 * i],
+                                       passed ? "TRUE" : "FALSE",
+                                       "Result of TRY_COMPILE",
+                                       cmStateEnums::INTERNAL);
+    allPassed = allPassed && passed;
+  }
+  this->OutputFile.clear();
+  return allPassed ? 0 : 1;
+}
+
 void cmCoreTryCompile::CleanupFiles(std::string const& binDir)
 {
   if (binDir.empty()) {
@@ -28,6 +28,18 @@ protected:
    */
   int TryCompileCode(std::vector<std::string> const& argv, bool isTryRun);
 
+  /**
+   * Set the result variable of each check in a BATCH from the outcome
+   * of building the test project, building checks individually where
+   * the outcome is not known.  Returns zero if all checks passed.
+   */
+  int EvaluateBatch(std::vector<std::string> const& batchArgs,
+                    std::vector<std::string> const& batchTargets,
+                    cmStateEnums::TargetType targetType,
+                    std::string const& sourceDirectory,
+                    std::string const& projectName, int res,
+                    std::string& output);
+
   /**
    * This deletes all the files created by TryCompileCode.
    * This way we do not have to rely on the timing and
@@ -3,24 +3,84 @@
 #include "cmDefinitions.h"
 
 #include <cassert>
+#include <deque>
 #include <functional>
-#include <unordered_set>
+#include <limits>
+#include <unordered_map>
 #include <utility>
 
 #include <cm/string_view>
 
+#include "cmMemoryUsage.h"
+
+namespace {
+class cmDefinitionsSymbolTable
+{
+public:
+  cmDefinitions::Symbol Find(cm::string_view name) const
+  {
+    auto i = this->Symbols.find(name);
+    return i != this->Symbols.end() ? i->second : cmDefinitions::NoSymbol;
+  }
+
+  cmDefinitions::Symbol Intern(cm::string_view name)
+  {
+    auto i = this->Symbols.find(name);
+    if (i != this->Symbols.end()) {
+      return i->second;
+    }
+    auto const symbol = static_cast<cmDefinitions::Symbol>(this->Names.size());
+    assert(symbol != cmDefinitions::NoSymbol);
+    // The deque never moves its elements, so the key views stay valid.
+    this->Names.emplace_back(name);
+    this->Symbols.emplace(this->Names.back(), symbol);
+    return symbol;
+  }
+
+  std::string const& GetName(cmDefinitions::Symbol symbol) const
+  {
+    return this->Names[symbol];
+  }
+
+private:
+  std::unordered_map<cm::string_view, cmDefinitions::Symbol> Symbols;
+  std::deque<std::string> Names;
+};
+
+cmDefinitionsSymbolTable& GetSymbolTable()
+{
+  static cmDefinitionsSymbolTable table;
+  return table;
+}
+}
+
 cmDefinitions::Def cmDefinitions::NoDef;
 
-cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
+const cmDefinitions::Symbol cmDefinitions::NoSymbol =
+  std::numeric_limits<cmDefinitions::Symbol>::max();
+
+cmDefinitions::Symbol cmDefinitions::Intern(cm::string_view name)
+{
+  return GetSymbolTable().Intern(name);
+}
+
+cmDefinitions::Symbol cmDefinitions::Lookup(cm::string_view name)
+{
+  return GetSymbolTable().Find(name);
+}
+
+std::string const& cmDefinitions::GetName(Symbol symbol)
+{
+  return GetSymbolTable().GetName(symbol);
+}
+
+cmDefinitions::Def const& cmDefinitions::GetInternal(Symbol key,
                                                      StackIter begin,
                                                      StackIter end, bool raise)
 {
   assert(begin != end);
-  {
-    auto it = begin->Map.find(cm::String::borrow(key));
-    if (it != begin->Map.end()) {
-      return it->second;
-    }
+  if (Def const* def = begin->Map.Find(key)) {
+    return *def;
   }
   StackIter it = begin;
   ++it;
@@ -31,27 +91,36 @@ cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
   if (!raise) {
     return def;
   }
-  return begin->Map.emplace(key, def).first->second;
+  begin->Map.Set(key, def);
+  return *begin->Map.Find(key);
 }
 
 const std::string* cmDefinitions::Get(const std::string& key, StackIter begin,
                                       StackIter end)
 {
-  Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
+  Symbol const symbol = cmDefinitions::Lookup(key);
+  if (symbol == NoSymbol) {
+    return nullptr;
+  }
+  Def const& def = cmDefinitions::GetInternal(symbol, begin, end, false);
   return def.Value ? def.Value.str_if_stable() : nullptr;
 }
 
 void cmDefinitions::Raise(const std::string& key, StackIter begin,
                           StackIter end)
 {
-  cmDefinitions::GetInternal(key, begin, end, true);
+  cmDefinitions::GetInternal(cmDefinitions::Intern(key), begin, end, true);
 }
 
 bool cmDefinitions::HasKey(const std::string& key, StackIter begin,
                            StackIter end)
 {
+  Symbol const symbol = cmDefinitions::Lookup(key);
+  if (symbol == NoSymbol) {
+    return false;
+  }
   for (StackIter it = begin; it != end; ++it) {
-    if (it->Map.find(cm::String::borrow(key)) != it->Map.end()) {
+    if (it->Map.Find(symbol)) {
       return true;
     }
   }
@@ -60,50 +129,66 @@ bool cmDefinitions::HasKey(const std::string& key, StackIter begin,
 
 cmDefinitions cmDefinitions::MakeClosure(StackIter begin, StackIter end)
 {
-  cmDefinitions closure;
-  std::unordered_set<cm::string_view> undefined;
+  std::vector<cmDefinitions const*> scopes;
   for (StackIter it = begin; it != end; ++it) {
-    // Consider local definitions.
-    for (auto const& mi : it->Map) {
-      // Use this key if it is not already set or unset.
-      if (closure.Map.find(mi.first) == closure.Map.end() &&
-          undefined.find(mi.first.view()) == undefined.end()) {
-        if (mi.second.Value) {
-          closure.Map.insert(mi);
-        } else {
-          undefined.emplace(mi.first.view());
-        }
-      }
-    }
+    scopes.push_back(&*it);
+  }
+
+  cmDefinitions closure;
+  if (scopes.empty()) {
+    return closure;
+  }
+
+  // Share the bottom scope, which is usually the directory scope holding
+  // most definitions, and apply the scopes above it from the bottom up
+  // so the innermost definition of each key wins.
+  closure.Map = scopes.back()->Map;
+  for (auto si = scopes.rbegin() + 1; si != scopes.rend(); ++si) {
+    (*si)->Map.ForEach([&closure](Symbol key, Def const& def) {
+      closure.Map.Set(key, def);
+    });
   }
+
+  // The closure is the bottom of a new stack, so unset entries no
+  // longer hide anything.  Drop them.
+  closure.Map.EraseTombstones();
   return closure;
 }
 
 std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
                                                     StackIter end)
 {
-  std::vector<std::string> defined;
-  std::unordered_set<cm::string_view> bound;
-
-  for (StackIter it = begin; it != end; ++it) {
-    defined.reserve(defined.size() + it->Map.size());
-    for (auto const& mi : it->Map) {
-      // Use this key if it is not already set or unset.
-      if (bound.emplace(mi.first.view()).second && mi.second.Value) {
-        defined.push_back(*mi.first.str_if_stable());
-      }
-    }
-  }
+  cmDefinitions const closure = cmDefinitions::MakeClosure(begin, end);
 
+  std::vector<std::string> defined;
+  defined.reserve(closure.Map.GetSize());
+  closure.Map.ForEach([&defined](Symbol key, Def const&) {
+    defined.push_back(cmDefinitions::GetName(key));
+  });
   return defined;
 }
 
 void cmDefinitions::Set(const std::string& key, cm::string_view value)
 {
-  this->Map[key] = Def(value);
+  this->Map.Set(cmDefinitions::Intern(key), Def(value));
 }
 
 void cmDefinitions::Unset(const std::string& key)
 {
-  this->Map[key] = Def();
+  this->Map.Set(cmDefinitions::Intern(key), Def());
+}
+
+std::size_t cmDefinitions::GetAllocatedBytes(
+  std::unordered_set<void const*>& counted) const
+{
+  return this->Map.GetAllocatedBytes(
+    counted, [&counted](Def const& def) -> std::size_t {
+      // Values copied between scopes share one string.
+      std::string const* value =
+        def.Value.data() ? def.Value.str_if_stable() : nullptr;
+      if (!value || !counted.insert(value).second) {
+        return 0;
+      }
+      return sizeof(std::string) + 2 * sizeof(void*) + cmHeapBytes(*value);
+    });
 }
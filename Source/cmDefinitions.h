@@ -5,14 +5,15 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
-#include <functional>
+#include <cstddef>
 #include <string>
-#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <cm/string_view>
 
 #include "cmLinkedTree.h"
+#include "cmPersistentMap.h"
 #include "cmString.hxx"
 
 /** \class cmDefinitions
@@ -21,6 +22,14 @@
  * This stores the state of variable definitions (set or unset) for
  * one scope.  Sets are always local.  Gets search parent scopes
  * transitively and save results locally.
+ *
+ * Variable names are interned in a process-wide symbol table so that
+ * each scope is keyed by a small integer.  A lookup hashes the name
+ * once and then probes each scope of the stack with the integer.
+ *
+ * Each scope stores its definitions in a persistent map, so a closure
+ * shares structure with the scopes it was made from and costs memory
+ * and time proportional to the definitions that differ from them.
  */
 class cmDefinitions
 {
@@ -48,6 +57,38 @@ public:
   /** Unset a definition.  */
   void Unset(const std::string& key);
 
+  /** Number of set and unset definitions in this scope.  */
+  std::size_t GetSize() const { return this->Map.GetSize(); }
+
+  /** Estimate the heap memory held by this scope.  Structure and values
+      shared with a scope already in 'counted' are not counted again.  */
+  std::size_t GetAllocatedBytes(
+    std::unordered_set<void const*>& counted) const;
+
+  // -- Symbols
+
+  /** Interned variable name.  The symbol table is global to the process
+      and keeps every interned name until exit, so its size is bounded
+      by the number of distinct variable names used.  It is not
+      synchronized: Intern may be called only while no other thread
+      uses the symbol table.  */
+  using Symbol = unsigned int;
+
+  /** Symbol of a name that has never been interned.  No scope can hold
+      a definition for such a name.  */
+  static const Symbol NoSymbol;
+
+  /** Get the symbol of a name, interning it if necessary.  */
+  static Symbol Intern(cm::string_view name);
+
+  /** Get the symbol of a name without interning it.  Does not modify
+      the symbol table, so it may be called concurrently with other
+      lookups.  */
+  static Symbol Lookup(cm::string_view name);
+
+  /** Get the name of an interned symbol.  */
+  static std::string const& GetName(Symbol symbol);
+
 private:
   /** String with existence boolean.  */
   struct Def
@@ -58,14 +99,16 @@ private:
       : Value(value)
     {
     }
+    /** Whether the definition is set rather than unset.  */
+    explicit operator bool() const { return static_cast<bool>(this->Value); }
     cm::String Value;
   };
   static Def NoDef;
 
-  std::unordered_map<cm::String, Def> Map;
+  cmPersistentMap<Def> Map;
 
-  static Def const& GetInternal(const std::string& key, StackIter begin,
-                                StackIter end, bool raise);
+  static Def const& GetInternal(Symbol key, StackIter begin, StackIter end,
+                                bool raise);
 };
 
 #endif
@@ -2,16 +2,24 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmDependsC.h"
 
+#include <cstdlib>
 #include <utility>
 
 #include "cmsys/FStream.hxx"
 
 #include "cmFileTime.h"
+#include "cmGeneratedFileStream.h"
 #include "cmLocalUnixMakefileGenerator3.h"
 #include "cmMakefile.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
+#ifndef CMAKE_BOOTSTRAP
+#  include "cmCryptoHash.h"
+#  include "cmFileLock.h"
+#  include "cmFileLockResult.h"
+#endif
+
 #define INCLUDE_REGEX_LINE                                                    \
   "^[ \t]*[#%][ \t]*(include|import)[ \t]*[<\"]([^\">]+)([\">])"
 
@@ -62,12 +70,26 @@ cmDependsC::cmDependsC(cmLocalUnixMakefileGenerator3* lg,
   this->CacheFileName =
     cmStrCat(this->TargetDirectory, '/', lang, ".includecache");
 
+#ifndef CMAKE_BOOTSTRAP
+  // Headers scanned with the same regular expressions have the same
+  // include lines no matter which target includes them.
+  cmCryptoHash md5(cmCryptoHash::AlgoMD5);
+  this->SharedCacheFileName = cmStrCat(
+    lg->GetBinaryDirectory(), "/CMakeFiles/CMakeIncludeCache/",
+    md5.HashString(cmStrCat(
+      this->IncludeRegexLineString, '\n', this->IncludeRegexScanString, '\n',
+      this->IncludeRegexComplainString, '\n',
+      this->IncludeRegexTransformString)),
+    ".includecache");
+#endif
+
   this->ReadCacheFile();
 }
 
 cmDependsC::~cmDependsC()
 {
   this->WriteCacheFile();
+  this->WriteSharedCacheFile();
 }
 
 bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
@@ -171,6 +193,9 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
 
         // Check whether this file is already in the cache
         auto fileIt = this->FileCache.find(fullName);
+        if (fileIt == this->FileCache.end()) {
+          fileIt = this->FindSharedCacheEntry(fullName);
+        }
         if (fileIt != this->FileCache.end()) {
           fileIt->second.Used = true;
           dependencies.insert(fullName);
@@ -184,7 +209,11 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
         } else {
 
           // Try to scan the file.  Just leave it out if we cannot find
-          // it.
+          // it.  Take the modification time first so that a change made
+          // while scanning invalidates the shared cache entry.
+          cmFileTime fileTime;
+          bool const haveFileTime = !this->SharedCacheFileName.empty() &&
+            fileTime.Load(fullName);
           cmsys::ifstream fin(fullName.c_str());
           if (fin) {
             cmsys::FStream::BOM bom = cmsys::FStream::ReadBOM(fin);
@@ -197,6 +226,13 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
               // containing the file to handle double-quote includes.
               std::string dir = cmSystemTools::GetFilenamePath(fullName);
               this->Scan(fin, dir, fullName);
+              if (haveFileTime) {
+                cmSharedIncludeLines& shared =
+                  this->SharedFileCacheAdded[fullName];
+                shared.Time = fileTime.GetNS();
+                shared.UnscannedEntries =
+                  this->FileCache[fullName].UnscannedEntries;
+              }
             } else {
               // Skip file with encoding we do not implement.
             }
@@ -328,6 +364,143 @@ void cmDependsC::WriteCacheFile() const
   }
 }
 
+std::map<std::string, cmDependsC::cmIncludeLines>::iterator
+cmDependsC::FindSharedCacheEntry(std::string const& fullName)
+{
+  if (this->SharedCacheFileName.empty()) {
+    return this->FileCache.end();
+  }
+  // Load the shared cache only once the cache of this target misses.
+  if (!this->SharedCacheLoaded) {
+    this->SharedCacheLoaded = true;
+    this->ReadSharedCacheFile(this->SharedFileCache);
+  }
+  auto const sharedIt = this->SharedFileCache.find(fullName);
+  if (sharedIt == this->SharedFileCache.end()) {
+    return this->FileCache.end();
+  }
+  cmFileTime fileTime;
+  if (!fileTime.Load(fullName) ||
+      fileTime.GetNS() != sharedIt->second.Time) {
+    return this->FileCache.end();
+  }
+  cmIncludeLines& lines = this->FileCache[fullName];
+  lines.UnscannedEntries = std::move(sharedIt->second.UnscannedEntries);
+  lines.Used = true;
+  this->SharedFileCache.erase(sharedIt);
+  return this->FileCache.find(fullName);
+}
+
+void cmDependsC::ReadSharedCacheFile(SharedFileCacheType& cache) const
+{
+  cmsys::ifstream fin(this->SharedCacheFileName.c_str());
+  if (!fin) {
+    return;
+  }
+
+  // The file name encodes the regular expressions, but check them to be
+  // safe against collisions.
+  std::string line;
+  for (std::string const* expected :
+       { &this->IncludeRegexLineString, &this->IncludeRegexScanString,
+         &this->IncludeRegexComplainString,
+         &this->IncludeRegexTransformString }) {
+    if (!cmSystemTools::GetLineFromStream(fin, line) || line != *expected ||
+        !cmSystemTools::GetLineFromStream(fin, line) || !line.empty()) {
+      return;
+    }
+  }
+
+  // Each entry is the name of the scanned file, its modification time,
+  // and a pair of lines for each include line.
+  cmSharedIncludeLines* cacheEntry = nullptr;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty()) {
+      cacheEntry = nullptr;
+      continue;
+    }
+    if (!cacheEntry) {
+      std::string time;
+      if (!cmSystemTools::GetLineFromStream(fin, time)) {
+        break;
+      }
+      cacheEntry = &cache[line];
+      cacheEntry->Time = std::strtoll(time.c_str(), nullptr, 10);
+      cacheEntry->UnscannedEntries.clear();
+      continue;
+    }
+    UnscannedEntry entry;
+    entry.FileName = line;
+    if (cmSystemTools::GetLineFromStream(fin, line)) {
+      if (line != "-") {
+        entry.QuotedLocation = line;
+      }
+      cacheEntry->UnscannedEntries.push_back(std::move(entry));
+    }
+  }
+}
+
+void cmDependsC::WriteSharedCacheFile()
+{
+  if (this->SharedCacheFileName.empty() ||
+      this->SharedFileCacheAdded.empty()) {
+    return;
+  }
+#ifndef CMAKE_BOOTSTRAP
+  cmSystemTools::MakeDirectory(
+    cmSystemTools::GetFilenamePath(this->SharedCacheFileName));
+
+  // Other targets may be scanned concurrently by a parallel build.  Merge
+  // the entries they wrote since this instance read the file.  The cache
+  // is only an optimization, so give up rather than wait too long.
+  std::string const lockFile = cmStrCat(this->SharedCacheFileName, ".lock");
+  cmFileLock lock;
+  if (!cmSystemTools::Touch(lockFile, true) ||
+      !lock.Lock(lockFile, 60).IsOk()) {
+    return;
+  }
+  // Rewrite the file only if this target adds entries that are not
+  // there yet, e.g. because another target scanned the same files.
+  SharedFileCacheType cache;
+  this->ReadSharedCacheFile(cache);
+  bool changed = false;
+  for (auto const& added : this->SharedFileCacheAdded) {
+    cmSharedIncludeLines& entry = cache[added.first];
+    if (entry.Time != added.second.Time) {
+      entry = added.second;
+      changed = true;
+    }
+  }
+  if (!changed) {
+    return;
+  }
+
+  // Readers do not take the lock, so replace the file in one step.
+  cmGeneratedFileStream cacheOut(this->SharedCacheFileName);
+  if (!cacheOut) {
+    return;
+  }
+  cacheOut << this->IncludeRegexLineString << "\n\n";
+  cacheOut << this->IncludeRegexScanString << "\n\n";
+  cacheOut << this->IncludeRegexComplainString << "\n\n";
+  cacheOut << this->IncludeRegexTransformString << "\n\n";
+  for (auto const& fileIt : cache) {
+    cacheOut << fileIt.first << '\n' << fileIt.second.Time << '\n';
+    for (UnscannedEntry const& inc : fileIt.second.UnscannedEntries) {
+      cacheOut << inc.FileName << '\n';
+      if (inc.QuotedLocation.empty()) {
+        cacheOut << '-' << '\n';
+      } else {
+        cacheOut << inc.QuotedLocation << '\n';
+      }
+    }
+    cacheOut << '\n';
+  }
+  cacheOut.Close();
+  lock.Release();
+#endif
+}
+
 void cmDependsC::Scan(std::istream& is, const std::string& directory,
                       const std::string& fullName)
 {
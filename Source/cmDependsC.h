@@ -15,6 +15,7 @@
 #include "cmsys/RegularExpression.hxx"
 
 #include "cmDepends.h"
+#include "cmFileTime.h"
 
 class cmLocalUnixMakefileGenerator3;
 
@@ -92,6 +93,25 @@ protected:
 
   void WriteCacheFile() const;
   void ReadCacheFile();
+
+  // Include lines shared by all targets of the build tree that scan with
+  // the same regular expressions, with the modification time each file
+  // had when it was scanned.
+  struct cmSharedIncludeLines
+  {
+    cmFileTime::NSC Time = 0;
+    std::vector<UnscannedEntry> UnscannedEntries;
+  };
+  using SharedFileCacheType = std::map<std::string, cmSharedIncludeLines>;
+  SharedFileCacheType SharedFileCache;
+  SharedFileCacheType SharedFileCacheAdded;
+  std::string SharedCacheFileName;
+  bool SharedCacheLoaded = false;
+
+  std::map<std::string, cmIncludeLines>::iterator FindSharedCacheEntry(
+    std::string const& fullName);
+  void WriteSharedCacheFile();
+  void ReadSharedCacheFile(SharedFileCacheType& cache) const;
 };
 
 #endif
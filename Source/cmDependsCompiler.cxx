@@ -0,0 +1,149 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmDependsCompiler.h"
+
+#include <map>
+#include <set>
+#include <utility>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmFileTime.h"
+#include "cmFileTimeCache.h"
+#include "cmGccDepfileReader.h"
+#include "cmGccDepfileReaderTypes.h"
+#include "cmGeneratedFileStream.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalUnixMakefileGenerator3.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+cmDependsCompiler::cmDependsCompiler(cmLocalUnixMakefileGenerator3* lg,
+                                     std::string targetDir)
+  : LocalGenerator(lg)
+  , TargetDirectory(std::move(targetDir))
+{
+}
+
+bool cmDependsCompiler::Update(std::vector<std::string> const& dependencyFiles,
+                               bool& changed)
+{
+  changed = false;
+
+  std::string const internalDependFile =
+    cmStrCat(this->TargetDirectory, "/compiler_depend.internal");
+  std::string const dependFile =
+    cmStrCat(this->TargetDirectory, "/compiler_depend.make");
+  std::string const& binDir = this->LocalGenerator->GetBinaryDirectory();
+  std::string const& curBinDir =
+    this->LocalGenerator->GetCurrentBinaryDirectory();
+
+  // Load the dependencies merged by the previous build.  They are still
+  // valid for every object whose depfile is not newer than the database.
+  std::map<std::string, std::vector<std::string>> database;
+  cmFileTime internalDependTime;
+  bool const haveDatabase =
+    this->FileTimeCache->Load(internalDependFile, internalDependTime);
+  if (haveDatabase) {
+    cmsys::ifstream fin(internalDependFile.c_str());
+    std::vector<std::string>* deps = nullptr;
+    std::string line;
+    while (cmSystemTools::GetLineFromStream(fin, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      if (line[0] == ' ') {
+        if (deps) {
+          deps->emplace_back(line.substr(1));
+        }
+      } else {
+        deps = &database[line];
+      }
+    }
+  }
+
+  std::map<std::string, std::vector<std::string>> merged;
+  for (auto pi = dependencyFiles.begin();
+       pi != dependencyFiles.end() && (pi + 1) != dependencyFiles.end();) {
+    std::string const& obj = *pi++;
+    std::string const& depFile = *pi++;
+    std::string const obj_i =
+      this->LocalGenerator->MaybeConvertToRelativePath(binDir, obj);
+
+    cmFileTime depFileTime;
+    bool const haveDepFile = this->FileTimeCache->Load(depFile, depFileTime);
+    auto const di = database.find(obj_i);
+    if (haveDepFile &&
+        (di == database.end() || !depFileTime.Older(internalDependTime))) {
+      if (this->Verbose) {
+        cmSystemTools::Stdout(cmStrCat("Dependee \"", depFile,
+                                       "\" is newer than depender \"",
+                                       internalDependFile, "\".\n"));
+      }
+      // The compiler names dependencies relative to the directory in
+      // which it ran.
+      std::set<std::string> paths;
+      for (cmGccStyleDependency const& dep :
+           cmReadGccDepfile(depFile.c_str())) {
+        for (std::string const& path : dep.paths) {
+          paths.insert(cmSystemTools::CollapseFullPath(path, curBinDir));
+        }
+      }
+      merged[obj_i].assign(paths.begin(), paths.end());
+      changed = true;
+    } else if (di != database.end()) {
+      // The object has not been compiled since the last merge, or its
+      // depfile is gone along with the object itself.
+      merged[obj_i] = std::move(di->second);
+    }
+  }
+
+  // Objects dropped from the target no longer need their dependencies.
+  if (!changed && merged.size() == database.size()) {
+    return true;
+  }
+  changed = true;
+
+  // The make tool reloads the dependencies only if they actually changed.
+  cmGlobalGenerator* gg = this->LocalGenerator->GetGlobalGenerator();
+  cmGeneratedFileStream ruleFileStream(dependFile, false,
+                                       gg->GetMakefileEncoding());
+  ruleFileStream.SetCopyIfDifferent(true);
+  if (!ruleFileStream) {
+    return false;
+  }
+  // The database is always written so that its time stamp records the
+  // time of this merge.
+  cmGeneratedFileStream internalRuleFileStream(internalDependFile, false,
+                                               gg->GetMakefileEncoding());
+  if (!internalRuleFileStream) {
+    return false;
+  }
+  this->LocalGenerator->WriteDisclaimer(ruleFileStream);
+  this->LocalGenerator->WriteDisclaimer(internalRuleFileStream);
+
+  // Give every dependency an empty rule, as 'gcc -MP' does, so that the
+  // make tool considers a header that no longer exists out of date
+  // instead of failing to find a rule to make it.
+  std::set<std::string> phonyDeps;
+  for (auto const& m : merged) {
+    std::string const obj_m =
+      this->LocalGenerator->ConvertToMakefilePath(m.first);
+    internalRuleFileStream << m.first << '\n';
+    for (std::string const& dep : m.second) {
+      std::string dep_m = this->LocalGenerator->ConvertToMakefilePath(
+        this->LocalGenerator->MaybeConvertToRelativePath(binDir, dep));
+      ruleFileStream << obj_m << ": " << dep_m << '\n';
+      internalRuleFileStream << ' ' << dep << '\n';
+      phonyDeps.insert(std::move(dep_m));
+    }
+    ruleFileStream << '\n';
+  }
+  for (std::string const& dep : phonyDeps) {
+    ruleFileStream << dep << ":\n";
+  }
+
+  // Do not let the time of the old database survive in the cache.
+  this->FileTimeCache->Remove(internalDependFile);
+  return true;
+}
@@ -0,0 +1,49 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmDependsCompiler_h
+#define cmDependsCompiler_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <vector>
+
+class cmFileTimeCache;
+class cmLocalUnixMakefileGenerator3;
+
+/** \class cmDependsCompiler
+ * \brief Merge the dependency files written by the compiler.
+ *
+ * When the compiler writes a gcc-style depfile next to each object file,
+ * no sources need to be scanned.  This class merges the depfiles written
+ * since the last build into a per-target database, compiler_depend.internal,
+ * and writes the make rules of the merged dependencies to
+ * compiler_depend.make.
+ */
+class cmDependsCompiler
+{
+public:
+  cmDependsCompiler(cmLocalUnixMakefileGenerator3* lg, std::string targetDir);
+
+  cmDependsCompiler(cmDependsCompiler const&) = delete;
+  cmDependsCompiler& operator=(cmDependsCompiler const&) = delete;
+
+  /** should this be verbose in its output */
+  void SetVerbose(bool verb) { this->Verbose = verb; }
+
+  /** Set the file comparison object */
+  void SetFileTimeCache(cmFileTimeCache* fc) { this->FileTimeCache = fc; }
+
+  /** Bring the dependencies up to date with the given list of pairs of
+      object file and depfile.  Sets changed if any depfile was merged.
+      Returns false if the dependency files could not be written.  */
+  bool Update(std::vector<std::string> const& dependencyFiles, bool& changed);
+
+private:
+  cmLocalUnixMakefileGenerator3* LocalGenerator;
+  std::string TargetDirectory;
+  bool Verbose = false;
+  cmFileTimeCache* FileTimeCache = nullptr;
+};
+
+#endif
@@ -46,7 +46,8 @@ public:
   std::vector<cmListFileFunction> Functions;
   cmPolicies::PolicyMap Policies;
   std::string FilePath;
-  long Line;
+  std::string FileDir;
+  std::string LineString;
 };
 
 bool cmFunctionHelperCommand::operator()(
@@ -101,11 +102,9 @@ bool cmFunctionHelperCommand::operator()(
   makefile.MarkVariableAsUsed(CMAKE_CURRENT_FUNCTION);
   makefile.AddDefinition(CMAKE_CURRENT_FUNCTION_LIST_FILE, this->FilePath);
   makefile.MarkVariableAsUsed(CMAKE_CURRENT_FUNCTION_LIST_FILE);
-  makefile.AddDefinition(CMAKE_CURRENT_FUNCTION_LIST_DIR,
-                         cmSystemTools::GetFilenamePath(this->FilePath));
+  makefile.AddDefinition(CMAKE_CURRENT_FUNCTION_LIST_DIR, this->FileDir);
   makefile.MarkVariableAsUsed(CMAKE_CURRENT_FUNCTION_LIST_DIR);
-  makefile.AddDefinition(CMAKE_CURRENT_FUNCTION_LIST_LINE,
-                         std::to_string(this->Line));
+  makefile.AddDefinition(CMAKE_CURRENT_FUNCTION_LIST_LINE, this->LineString);
   makefile.MarkVariableAsUsed(CMAKE_CURRENT_FUNCTION_LIST_LINE);
 
   // Invoke all the functions that were collected in the block.
@@ -162,7 +161,8 @@ bool cmFunctionFunctionBlocker::Replay(
   f.Args = this->Args;
   f.Functions = std::move(functions);
   f.FilePath = this->GetStartingContext().FilePath;
-  f.Line = this->GetStartingContext().Line;
+  f.FileDir = cmSystemTools::GetFilenamePath(f.FilePath);
+  f.LineString = std::to_string(this->GetStartingContext().Line);
   mf.RecordPolicies(f.Policies);
   mf.GetState()->AddScriptedCommand(this->Args.front(), std::move(f));
   return true;
@@ -2,10 +2,14 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmGeneratorExpression.h"
 
+#include <atomic>
 #include <cassert>
 #include <memory>
+#include <tuple>
 #include <utility>
 
+#include <cm/optional>
+
 #include "cmsys/RegularExpression.hxx"
 
 #include "cmGeneratorExpressionContext.h"
@@ -13,6 +17,7 @@
 #include "cmGeneratorExpressionEvaluator.h"
 #include "cmGeneratorExpressionLexer.h"
 #include "cmGeneratorExpressionParser.h"
+#include "cmGeneratorTarget.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
@@ -46,18 +51,128 @@ std::string cmGeneratorExpression::Evaluate(
   return input;
 }
 
+namespace {
+std::atomic<unsigned long long> CacheEvaluations(0);
+std::atomic<unsigned long long> CacheHits(0);
+std::atomic<unsigned long long> CacheUncacheable(0);
+std::atomic<unsigned long long> CacheGeneration(0);
+}
+
+bool cmCompiledGeneratorExpression::CacheKey::operator<(
+  CacheKey const& other) const
+{
+  return std::tie(this->LG, this->Config, this->Language, this->HeadTarget,
+                  this->CurrentTarget, this->TopTarget, this->TopProperty,
+                  this->HasDAGChecker, this->TransitivePropertiesOnly,
+                  this->DeviceLink) <
+    std::tie(other.LG, other.Config, other.Language, other.HeadTarget,
+             other.CurrentTarget, other.TopTarget, other.TopProperty,
+             other.HasDAGChecker, other.TransitivePropertiesOnly,
+             other.DeviceLink);
+}
+
+cmCompiledGeneratorExpression::CacheStatistics
+cmCompiledGeneratorExpression::GetCacheStatistics()
+{
+  CacheStatistics stats;
+  stats.Evaluations = CacheEvaluations.load(std::memory_order_relaxed);
+  stats.Hits = CacheHits.load(std::memory_order_relaxed);
+  stats.Uncacheable = CacheUncacheable.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void cmCompiledGeneratorExpression::InvalidateEvaluationCaches()
+{
+  CacheGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
 const std::string& cmCompiledGeneratorExpression::Evaluate(
   cmLocalGenerator* lg, const std::string& config,
   const cmGeneratorTarget* headTarget,
   cmGeneratorExpressionDAGChecker* dagChecker,
   const cmGeneratorTarget* currentTarget, std::string const& language) const
 {
+  if (!this->NeedsEvaluation) {
+    return this->Input;
+  }
+  CacheEvaluations.fetch_add(1, std::memory_order_relaxed);
+
+  if (!currentTarget) {
+    currentTarget = headTarget;
+  }
+
+  unsigned long long const generation =
+    CacheGeneration.load(std::memory_order_relaxed);
+  if (generation != this->EvaluationCacheGeneration) {
+    this->EvaluationCache.clear();
+    this->EvaluationCacheGeneration = generation;
+  }
+
+  // Most expressions are evaluated once.  Start remembering results only
+  // when one is evaluated again, so that those pay nothing for the cache.
+  cm::optional<CacheKey> key;
+  if (this->Evaluated) {
+    static std::string const noProperty;
+    key.emplace();
+    key->LG = lg;
+    key->Config = config;
+    key->Language = language;
+    key->HeadTarget = headTarget;
+    key->CurrentTarget = currentTarget;
+    key->TopTarget = dagChecker ? dagChecker->TopTarget() : nullptr;
+    key->TopProperty = dagChecker ? dagChecker->TopProperty() : noProperty;
+    key->HasDAGChecker = dagChecker != nullptr;
+    key->TransitivePropertiesOnly =
+      dagChecker && dagChecker->GetTransitivePropertiesOnly();
+    key->DeviceLink = headTarget && headTarget->IsDeviceLink();
+
+    auto const it = this->EvaluationCache.find(*key);
+    if (it != this->EvaluationCache.end()) {
+      CacheHits.fetch_add(1, std::memory_order_relaxed);
+      CacheEntry const& entry = it->second;
+      this->DependTargets = entry.DependTargets;
+      this->AllTargetsSeen = entry.AllTargetsSeen;
+      this->SourceSensitiveTargets = entry.SourceSensitiveTargets;
+      this->MaxLanguageStandard = entry.MaxLanguageStandard;
+      this->HadContextSensitiveCondition = entry.HadContextSensitiveCondition;
+      this->HadHeadSensitiveCondition = entry.HadHeadSensitiveCondition;
+      this->HadLinkLanguageSensitiveCondition =
+        entry.HadLinkLanguageSensitiveCondition;
+      return entry.Output;
+    }
+  }
+  this->Evaluated = true;
+
   cmGeneratorExpressionContext context(
-    lg, config, this->Quiet, headTarget,
-    currentTarget ? currentTarget : headTarget, this->EvaluateForBuildsystem,
-    this->Backtrace, language);
+    lg, config, this->Quiet, headTarget, currentTarget,
+    this->EvaluateForBuildsystem, this->Backtrace, language);
+
+  std::string const& output = this->EvaluateWithContext(context, dagChecker);
+
+  // A result that depends on the state of the dependency graph walk, or
+  // that reported an error, must be computed again next time.
+  if (context.HadError || context.HadDAGSensitiveCondition) {
+    CacheUncacheable.fetch_add(1, std::memory_order_relaxed);
+    return output;
+  }
+  // Nor can one that saw a target property change while it ran.
+  if (!key ||
+      CacheGeneration.load(std::memory_order_relaxed) != generation) {
+    return output;
+  }
 
-  return this->EvaluateWithContext(context, dagChecker);
+  CacheEntry entry;
+  entry.Output = output;
+  entry.DependTargets = this->DependTargets;
+  entry.AllTargetsSeen = this->AllTargetsSeen;
+  entry.SourceSensitiveTargets = this->SourceSensitiveTargets;
+  entry.MaxLanguageStandard = this->MaxLanguageStandard;
+  entry.HadContextSensitiveCondition = this->HadContextSensitiveCondition;
+  entry.HadHeadSensitiveCondition = this->HadHeadSensitiveCondition;
+  entry.HadLinkLanguageSensitiveCondition =
+    this->HadLinkLanguageSensitiveCondition;
+  return this->EvaluationCache.emplace(std::move(*key), std::move(entry))
+    .first->second.Output;
 }
 
 const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
@@ -68,18 +183,21 @@ const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
     return this->Input;
   }
 
-  this->Output.clear();
+  // Evaluating the parts may evaluate this expression again for another
+  // target, so assemble the result locally.
+  std::string output;
 
   for (const auto& it : this->Evaluators) {
-    this->Output += it->Evaluate(&context, dagChecker);
+    output += it->Evaluate(&context, dagChecker);
 
     this->SeenTargetProperties.insert(context.SeenTargetProperties.cbegin(),
                                       context.SeenTargetProperties.cend());
     if (context.HadError) {
-      this->Output.clear();
+      output.clear();
       break;
     }
   }
+  this->Output = std::move(output);
 
   this->MaxLanguageStandard = context.MaxLanguageStandard;
 
@@ -105,6 +223,8 @@ cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
   , HadContextSensitiveCondition(false)
   , HadHeadSensitiveCondition(false)
   , HadLinkLanguageSensitiveCondition(false)
+  , Evaluated(false)
+  , EvaluationCacheGeneration(0)
 {
   cmGeneratorExpressionLexer l;
   std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(this->Input);
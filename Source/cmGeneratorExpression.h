@@ -121,6 +121,11 @@ public:
   std::string const& GetInput() const { return this->Input; }
 
   cmListFileBacktrace GetBacktrace() const { return this->Backtrace; }
+  // Errors found by later evaluations are reported with this backtrace.
+  void SetBacktrace(cmListFileBacktrace backtrace)
+  {
+    this->Backtrace = std::move(backtrace);
+  }
   bool GetHadContextSensitiveCondition() const
   {
     return this->HadContextSensitiveCondition;
@@ -140,15 +145,73 @@ public:
 
   void SetEvaluateForBuildsystem(bool eval)
   {
+    if (eval != this->EvaluateForBuildsystem) {
+      this->EvaluationCache.clear();
+    }
     this->EvaluateForBuildsystem = eval;
   }
 
-  void SetQuiet(bool quiet) { this->Quiet = quiet; }
+  void SetQuiet(bool quiet)
+  {
+    if (quiet != this->Quiet) {
+      this->EvaluationCache.clear();
+    }
+    this->Quiet = quiet;
+  }
 
   void GetMaxLanguageStandard(cmGeneratorTarget const* tgt,
                               std::map<std::string, std::string>& mapping);
 
+  /** Counts of evaluations of all compiled expressions so far.  */
+  struct CacheStatistics
+  {
+    // Evaluations of expressions that contain a generator expression.
+    unsigned long long Evaluations = 0;
+    // Evaluations answered by an earlier one with the same context.
+    unsigned long long Hits = 0;
+    // Evaluations whose result cannot be reused, because they read target
+    // properties through the dependency graph or failed.
+    unsigned long long Uncacheable = 0;
+  };
+  static CacheStatistics GetCacheStatistics();
+
+  /** Forget the results of all earlier evaluations.  Called whenever a
+      target property changes, since an evaluation may have read it.  */
+  static void InvalidateEvaluationCaches();
+
 private:
+  // What an evaluation depends on besides the expression itself.
+  struct CacheKey
+  {
+    cmLocalGenerator* LG;
+    std::string Config;
+    std::string Language;
+    cmGeneratorTarget const* HeadTarget;
+    cmGeneratorTarget const* CurrentTarget;
+    // Nodes like $<LINK_ONLY> and $<COMPILE_LANGUAGE> look at the property
+    // being evaluated at the top of the dependency graph.
+    cmGeneratorTarget const* TopTarget;
+    std::string TopProperty;
+    bool HasDAGChecker;
+    bool TransitivePropertiesOnly;
+    bool DeviceLink;
+
+    bool operator<(CacheKey const& other) const;
+  };
+  // The result of an evaluation and what it recorded in its context.
+  struct CacheEntry
+  {
+    std::string Output;
+    std::set<cmGeneratorTarget*> DependTargets;
+    std::set<cmGeneratorTarget const*> AllTargetsSeen;
+    std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
+    std::map<cmGeneratorTarget const*, std::map<std::string, std::string>>
+      MaxLanguageStandard;
+    bool HadContextSensitiveCondition;
+    bool HadHeadSensitiveCondition;
+    bool HadLinkLanguageSensitiveCondition;
+  };
+
   const std::string& EvaluateWithContext(
     cmGeneratorExpressionContext& context,
     cmGeneratorExpressionDAGChecker* dagChecker) const;
@@ -176,6 +239,13 @@ private:
   mutable bool HadHeadSensitiveCondition;
   mutable bool HadLinkLanguageSensitiveCondition;
   mutable std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
+  mutable bool Evaluated;
+  // Like the rest of the evaluation state above, the cache is not
+  // synchronized: a compiled expression must be evaluated by one thread
+  // at a time, which generation guarantees by being single-threaded.
+  mutable std::map<CacheKey, CacheEntry> EvaluationCache;
+  // The value of the global invalidation counter the cache is valid for.
+  mutable unsigned long long EvaluationCacheGeneration;
 };
 
 class cmGeneratorExpressionInterpreter
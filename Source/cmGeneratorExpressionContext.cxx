@@ -20,6 +20,7 @@ cmGeneratorExpressionContext::cmGeneratorExpressionContext(
   , HadContextSensitiveCondition(false)
   , HadHeadSensitiveCondition(false)
   , HadLinkLanguageSensitiveCondition(false)
+  , HadDAGSensitiveCondition(false)
   , EvaluateForBuildsystem(evaluateForBuildsystem)
 {
 }
@@ -41,6 +41,9 @@ struct cmGeneratorExpressionContext
   bool HadContextSensitiveCondition;
   bool HadHeadSensitiveCondition;
   bool HadLinkLanguageSensitiveCondition;
+  // Whether evaluation walked the dependency graph of target properties,
+  // so that the result depends on where in the graph it was evaluated.
+  bool HadDAGSensitiveCondition;
   bool EvaluateForBuildsystem;
 };
 
@@ -85,6 +85,7 @@ struct cmGeneratorExpressionDAGChecker
 
   cmGeneratorExpressionDAGChecker const* Top() const;
   cmGeneratorTarget const* TopTarget() const;
+  std::string const& TopProperty() const;
 
 private:
   Result CheckGraph() const;
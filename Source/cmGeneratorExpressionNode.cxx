@@ -54,18 +54,29 @@ std::string cmGeneratorExpressionNode::EvaluateDependentExpression(
 {
   cmGeneratorExpression ge(context->Backtrace);
   std::unique_ptr<cmCompiledGeneratorExpression> cge = ge.Parse(prop);
-  cge->SetEvaluateForBuildsystem(context->EvaluateForBuildsystem);
-  cge->SetQuiet(context->Quiet);
+  return EvaluateDependentExpression(*cge, lg, context, headTarget, dagChecker,
+                                     currentTarget);
+}
+
+std::string cmGeneratorExpressionNode::EvaluateDependentExpression(
+  cmCompiledGeneratorExpression& cge, cmLocalGenerator* lg,
+  cmGeneratorExpressionContext* context, cmGeneratorTarget const* headTarget,
+  cmGeneratorExpressionDAGChecker* dagChecker,
+  cmGeneratorTarget const* currentTarget)
+{
+  cge.SetBacktrace(context->Backtrace);
+  cge.SetEvaluateForBuildsystem(context->EvaluateForBuildsystem);
+  cge.SetQuiet(context->Quiet);
   std::string result =
-    cge->Evaluate(lg, context->Config, headTarget, dagChecker, currentTarget,
-                  context->Language);
-  if (cge->GetHadContextSensitiveCondition()) {
+    cge.Evaluate(lg, context->Config, headTarget, dagChecker, currentTarget,
+                 context->Language);
+  if (cge.GetHadContextSensitiveCondition()) {
     context->HadContextSensitiveCondition = true;
   }
-  if (cge->GetHadHeadSensitiveCondition()) {
+  if (cge.GetHadHeadSensitiveCondition()) {
     context->HadHeadSensitiveCondition = true;
   }
-  if (cge->GetHadLinkLanguageSensitiveCondition()) {
+  if (cge.GetHadLinkLanguageSensitiveCondition()) {
     context->HadLinkLanguageSensitiveCondition = true;
   }
   return result;
@@ -532,6 +543,12 @@ static const struct TargetGenexEvalNode : public GenexEvaluator
       return expression;
     }
 
+    // The result depends on where in the dependency graph walk it is
+    // evaluated only if there is a walk in progress.
+    if (dagCheckerParent) {
+      context->HadDAGSensitiveCondition = true;
+    }
+
     cmGeneratorExpressionContext targetContext(
       context->LG, context->Config, context->Quiet, target, target,
       context->EvaluateForBuildsystem, context->Backtrace, context->Language);
@@ -560,6 +577,10 @@ static const struct GenexEvalNode : public GenexEvaluator
       return expression;
     }
 
+    if (dagCheckerParent) {
+      context->HadDAGSensitiveCondition = true;
+    }
+
     return this->EvaluateExpression("GENEX_EVAL", expression, context, content,
                                     dagCheckerParent);
   }
@@ -1416,6 +1437,12 @@ static const struct TargetPropertyNode : public cmGeneratorExpressionNode
 
     assert(target);
 
+    // Within a dependency graph walk the value depends on the properties
+    // already visited.  Otherwise this starts its own walk.
+    if (dagCheckerParent) {
+      context->HadDAGSensitiveCondition = true;
+    }
+
     if (propertyName == "LINKER_LANGUAGE") {
       if (target->LinkLanguagePropagatesToDependents() && dagCheckerParent &&
           (dagCheckerParent->EvaluatingLinkLibraries() ||
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+class cmCompiledGeneratorExpression;
 class cmGeneratorTarget;
 class cmLocalGenerator;
 struct GeneratorExpressionContent;
@@ -46,6 +47,12 @@ struct cmGeneratorExpressionNode
     cmGeneratorExpressionDAGChecker* dagChecker,
     const cmGeneratorTarget* currentTarget);
 
+  static std::string EvaluateDependentExpression(
+    cmCompiledGeneratorExpression& cge, cmLocalGenerator* lg,
+    cmGeneratorExpressionContext* context, const cmGeneratorTarget* headTarget,
+    cmGeneratorExpressionDAGChecker* dagChecker,
+    const cmGeneratorTarget* currentTarget);
+
   static const cmGeneratorExpressionNode* GetNode(
     const std::string& identifier);
 };
@@ -36,6 +36,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
+#include "cmMemoryUsage.h"
 #include "cmMessageType.h"
 #include "cmOutputConverter.h"
 #include "cmPropertyMap.h"
@@ -361,6 +362,50 @@ const std::string& cmGeneratorTarget::GetName() const
   return this->Target->GetName();
 }
 
+std::size_t cmGeneratorTarget::GetAllocatedBytes() const
+{
+  std::size_t bytes = cmHeapBytes(this->FortranModuleDirectory) +
+    cmHeapBytes(this->VisitedConfigsForObjects) + cmHeapBytes(this->Objects) +
+    cmHeapBytes(this->ExplicitObjectName) +
+    cmHeapBytes(this->SystemIncludesCache) + cmHeapBytes(this->ExportMacro) +
+    cmHeapBytes(this->SourceFlagsMap) +
+    cmHeapBytes(this->DebugCompatiblePropertiesDone) +
+    cmHeapBytes(this->LinkerLanguage) +
+    cmHeapBytes(this->MaybeInterfacePropertyExists) +
+    cmHeapBytes(this->LinkImplicitNullProperties) +
+    cmHeapBytes(this->PchHeaders) + cmHeapBytes(this->PchSources) +
+    cmHeapBytes(this->PchObjectFiles) + cmHeapBytes(this->PchFiles) +
+    cmHeapBytes(this->PchCreateCompileOptions) +
+    cmHeapBytes(this->PchUseCompileOptions) +
+    cmHeapBytes(this->UnityBatchedSourceFiles) +
+    cmHeapBytes(this->MaxLanguageStandards);
+  for (auto const& sd : this->SourceDepends) {
+    bytes += sizeof(sd) + cmMemoryUsageDetail::TreeNodeOverhead +
+      cmHeapBytes(sd.second.Depends);
+  }
+  for (auto const& ks : this->KindedSourcesMap) {
+    bytes += sizeof(ks) + cmMemoryUsageDetail::TreeNodeOverhead +
+      cmHeapBytes(ks.first) +
+      ks.second.Sources.capacity() * sizeof(SourceAndKind);
+  }
+  for (AllConfigSource const& source : this->AllConfigSources) {
+    bytes += sizeof(source) + cmHeapBytes(source.Configs);
+  }
+  // The entries of the usage requirement properties, not counting the
+  // compiled generator expressions they hold.
+  for (TargetPropertyEntryVector const* entries :
+       { &this->IncludeDirectoriesEntries, &this->CompileOptionsEntries,
+         &this->CompileFeaturesEntries, &this->CompileDefinitionsEntries,
+         &this->LinkOptionsEntries, &this->LinkDirectoriesEntries,
+         &this->PrecompileHeadersEntries, &this->SourceEntries }) {
+    bytes += entries->capacity() * sizeof(entries->front());
+    for (auto const& entry : *entries) {
+      bytes += sizeof(TargetPropertyEntry) + cmHeapBytes(entry->GetInput());
+    }
+  }
+  return bytes;
+}
+
 std::string cmGeneratorTarget::GetExportName() const
 {
   cmProp exportName = this->GetProperty("EXPORT_NAME");
@@ -1260,8 +1305,13 @@ std::string cmGeneratorTarget::EvaluateInterfaceProperty(
     context->HeadTarget ? context->HeadTarget : this;
 
   if (cmProp p = this->GetProperty(prop)) {
+    std::unique_ptr<cmCompiledGeneratorExpression>& cge =
+      this->InterfacePropertyExpressions[prop];
+    if (!cge || cge->GetInput() != *p) {
+      cge = cmGeneratorExpression(context->Backtrace).Parse(*p);
+    }
     result = cmGeneratorExpressionNode::EvaluateDependentExpression(
-      *p, context->LG, context, headTarget, &dagChecker, this);
+      *cge, context->LG, context, headTarget, &dagChecker, this);
   }
 
   if (cmLinkInterfaceLibraries const* iface = this->GetLinkInterfaceLibraries(
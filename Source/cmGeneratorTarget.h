@@ -21,6 +21,7 @@
 #include "cmProperty.h"
 #include "cmStateTypes.h"
 
+class cmCompiledGeneratorExpression;
 class cmComputeLinkInformation;
 class cmCustomCommand;
 class cmGlobalGenerator;
@@ -78,6 +79,9 @@ public:
   std::vector<std::string> GetPropertyKeys() const;
   //! Might return a nullptr if the property is not set or invalid
   cmProp GetProperty(const std::string& prop) const;
+
+  //! Estimate the heap memory held by the caches of this target
+  std::size_t GetAllocatedBytes() const;
   //! Always returns a valid pointer
   std::string const& GetSafeProperty(std::string const& prop) const;
   bool GetPropertyAsBool(const std::string& prop) const;
@@ -958,6 +962,11 @@ private:
   void ComputeAllConfigSources() const;
 
   mutable std::unordered_map<std::string, bool> MaybeInterfacePropertyExists;
+  // Compiled values of the interface properties evaluated for dependents,
+  // which keep their results for repeated evaluations.
+  mutable std::unordered_map<std::string,
+                             std::unique_ptr<cmCompiledGeneratorExpression>>
+    InterfacePropertyExpressions;
   bool MaybeHaveInterfaceProperty(std::string const& prop,
                                   cmGeneratorExpressionContext* context,
                                   bool usage_requirements_only) const;
@@ -48,6 +48,12 @@ public:
   bool AllowDeleteOnError() const override { return false; }
   bool CanEscapeOctothorpe() const override { return true; }
 
+  /** Borland make has no option to keep going after an error.  */
+  std::vector<std::string> GetKeepGoingBuildOptions() const override
+  {
+    return {};
+  }
+
 protected:
   std::vector<GeneratedMakeCommand> GenerateBuildCommand(
     const std::string& makeProgram, const std::string& projectName,
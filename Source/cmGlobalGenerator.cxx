@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -35,6 +36,7 @@
 #include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
 #include "cmInstallGenerator.h"
+#include "cmLinkItem.h"
 #include "cmLinkLineComputer.h"
 #include "cmListFileCache.h"
 #include "cmLocalGenerator.h"
@@ -48,6 +50,7 @@
 #include "cmState.h"
 #include "cmStateDirectory.h"
 #include "cmStateTypes.h"
+#include "cmStringAlgorithms.h"
 #include "cmVersion.h"
 #include "cmWorkingDirectory.h"
 #include "cmake.h"
@@ -1437,6 +1440,10 @@ bool cmGlobalGenerator::Compute()
     }
   }
 
+  // Share precompiled headers between targets that opted in, now that
+  // their effective compile flags are known.
+  this->AddAutomaticPchReuse();
+
   for (const auto& localGen : this->LocalGenerators) {
     cmMakefile* mf = localGen->GetMakefile();
     for (const auto& g : mf->GetInstallGenerators()) {
@@ -1590,6 +1597,175 @@ bool cmGlobalGenerator::QtAutoGen()
 #endif
 }
 
+namespace {
+bool IsPchAutoReuseCandidate(cmGeneratorTarget const* gt)
+{
+  return gt->GetPropertyAsBool("PRECOMPILE_HEADERS_AUTO_REUSE") &&
+    !gt->GetProperty("PRECOMPILE_HEADERS_REUSE_FROM") &&
+    !gt->GetPropertyAsBool("DISABLE_PRECOMPILE_HEADERS");
+}
+
+// Describe everything that goes into building the precompiled headers
+// of a target.  Two targets with the same non-empty fingerprint can use
+// the same PCH.
+std::string ComputePchFingerprint(cmGeneratorTarget* gt,
+                                  std::vector<std::string> const& configs)
+{
+  cmLocalGenerator* lg = gt->GetLocalGenerator();
+  std::string fingerprint;
+  for (std::string const& config : configs) {
+    std::vector<cmSourceFile*> sources;
+    gt->GetSourceFiles(sources, config);
+    for (const char* lang : { "C", "CXX", "OBJC", "OBJCXX" }) {
+      bool const hasSources = std::any_of(
+        sources.begin(), sources.end(), [&lang](cmSourceFile* sf) {
+          return lang == sf->GetLanguage() &&
+            !sf->GetProperty("SKIP_PRECOMPILE_HEADERS");
+        });
+      if (!hasSources) {
+        continue;
+      }
+      std::vector<BT<std::string>> const headers =
+        gt->GetPrecompileHeaders(config, lang);
+      if (headers.empty()) {
+        continue;
+      }
+
+      std::string flags;
+      lg->GetTargetCompileFlags(gt, config, lang, flags);
+      std::vector<std::string> archs;
+      gt->GetAppleArchs(config, archs);
+      std::set<std::string> defines;
+      lg->GetTargetDefines(gt, config, lang, defines);
+      std::vector<std::string> includes;
+      lg->GetIncludeDirectories(includes, gt, lang, config);
+
+      fingerprint += cmStrCat(config, '\n', lang, '\n', flags, '\n',
+                              cmJoin(archs, ";"), '\n',
+                              cmJoin(defines, ";"), '\n',
+                              cmJoin(includes, ";"), '\n');
+      for (BT<std::string> const& header : headers) {
+        fingerprint += cmStrCat(header.Value, '\n');
+      }
+    }
+  }
+  if (!fingerprint.empty()) {
+    cmMakefile* mf = gt->Makefile;
+    fingerprint += cmStrCat(mf->GetSafeDefinition("CMAKE_PCH_PROLOGUE"),
+                            '\n',
+                            mf->GetSafeDefinition("CMAKE_PCH_EPILOGUE"));
+  }
+  return fingerprint;
+}
+
+// Build-order dependencies between targets.  The custom commands are
+// inspected directly because their target-level dependencies are not
+// traced yet when precompiled headers are shared.
+class PchReuseGraph
+{
+public:
+  using Targets = std::vector<cmGeneratorTarget const*>;
+
+  // Record that 'from' now has to be built after 'to'.
+  void AddEdge(cmGeneratorTarget const* from, cmGeneratorTarget const* to)
+  {
+    this->GetDirectDependencies(from).push_back(to);
+  }
+
+  // Collect the targets that have to be built before 'from'.
+  std::set<cmGeneratorTarget const*> GetReachable(
+    cmGeneratorTarget const* from)
+  {
+    std::set<cmGeneratorTarget const*> reached;
+    Targets queue = this->GetDirectDependencies(from);
+    while (!queue.empty()) {
+      cmGeneratorTarget const* gt = queue.back();
+      queue.pop_back();
+      if (gt->IsImported() || !reached.insert(gt).second) {
+        continue;
+      }
+      Targets const& deps = this->GetDirectDependencies(gt);
+      queue.insert(queue.end(), deps.begin(), deps.end());
+    }
+    return reached;
+  }
+
+private:
+  Targets& GetDirectDependencies(cmGeneratorTarget const* gt)
+  {
+    auto const inserted = this->Direct.emplace(gt, Targets());
+    if (inserted.second) {
+      this->ComputeDirectDependencies(gt, inserted.first->second);
+    }
+    return inserted.first->second;
+  }
+
+  static void ComputeDirectDependencies(cmGeneratorTarget const* gt,
+                                        Targets& deps)
+  {
+    cmLocalGenerator* lg = gt->GetLocalGenerator();
+    auto addName = [lg, &deps](std::string const& name) {
+      if (cmGeneratorTarget* dep = lg->FindGeneratorTargetToUse(name)) {
+        deps.push_back(dep);
+      }
+    };
+    auto addCommand = [&addName](cmCustomCommand const& cc) {
+      for (std::string const& dep : cc.GetDepends()) {
+        addName(dep);
+      }
+      for (cmCustomCommandLine const& line : cc.GetCommandLines()) {
+        if (!line.empty()) {
+          addName(line[0]);
+        }
+      }
+    };
+
+    for (BT<std::pair<std::string, bool>> const& u : gt->GetUtilities()) {
+      addName(u.Value.first);
+    }
+    for (auto const* commands :
+         { &gt->GetPreBuildCommands(), &gt->GetPreLinkCommands(),
+           &gt->GetPostBuildCommands() }) {
+      for (cmCustomCommand const& cc : *commands) {
+        addCommand(cc);
+      }
+    }
+    bool const links = gt->GetType() != cmStateEnums::INTERFACE_LIBRARY &&
+      gt->GetType() != cmStateEnums::UTILITY &&
+      gt->GetType() != cmStateEnums::GLOBAL_TARGET;
+    for (std::string const& config : gt->Makefile->GetGeneratorConfigs(
+           cmMakefile::IncludeEmptyConfig)) {
+      std::vector<cmSourceFile const*> customCommands;
+      gt->GetCustomCommands(customCommands, config);
+      for (cmSourceFile const* sf : customCommands) {
+        addCommand(*sf->GetCustomCommand());
+      }
+      if (!links) {
+        continue;
+      }
+      std::vector<cmSourceFile const*> objects;
+      gt->GetExternalObjects(objects, config);
+      for (cmSourceFile const* sf : objects) {
+        std::string const objLib = sf->GetObjectLibrary();
+        if (!objLib.empty()) {
+          addName(objLib);
+        }
+      }
+      if (cmLinkImplementationLibraries const* impl =
+            gt->GetLinkImplementationLibraries(config)) {
+        for (cmLinkImplItem const& item : impl->Libraries) {
+          if (item.Target) {
+            deps.push_back(item.Target);
+          }
+        }
+      }
+    }
+  }
+
+  std::map<cmGeneratorTarget const*, Targets> Direct;
+};
+}
+
 bool cmGlobalGenerator::AddAutomaticSources()
 {
   for (const auto& lg : this->LocalGenerators) {
@@ -1601,8 +1777,10 @@ bool cmGlobalGenerator::AddAutomaticSources()
         continue;
       }
       lg->AddUnityBuild(gt.get());
-      // Targets that re-use a PCH are handled below.
-      if (!gt->GetProperty("PRECOMPILE_HEADERS_REUSE_FROM")) {
+      // Targets that re-use a PCH are handled below.  Targets that may
+      // share a PCH automatically are handled by AddAutomaticPchReuse.
+      if (!gt->GetProperty("PRECOMPILE_HEADERS_REUSE_FROM") &&
+          !IsPchAutoReuseCandidate(gt.get())) {
         lg->AddPchDependencies(gt.get());
       }
     }
@@ -1632,6 +1810,89 @@ bool cmGlobalGenerator::AddAutomaticSources()
   return true;
 }
 
+void cmGlobalGenerator::AddAutomaticPchReuse()
+{
+  // Group the candidates by what their precompiled headers are built from.
+  std::map<std::string, std::vector<cmGeneratorTarget*>> groups;
+  std::vector<cmGeneratorTarget*> owners;
+  for (const auto& lg : this->LocalGenerators) {
+    std::vector<std::string> const configs =
+      lg->GetMakefile()->GetGeneratorConfigs(cmMakefile::IncludeEmptyConfig);
+    for (const auto& gt : lg->GetGeneratorTargets()) {
+      if (gt->GetType() == cmStateEnums::INTERFACE_LIBRARY ||
+          gt->GetType() == cmStateEnums::UTILITY ||
+          gt->GetType() == cmStateEnums::GLOBAL_TARGET ||
+          !IsPchAutoReuseCandidate(gt.get())) {
+        continue;
+      }
+      std::string fingerprint = ComputePchFingerprint(gt.get(), configs);
+      if (fingerprint.empty()) {
+        owners.push_back(gt.get());
+      } else {
+        groups[std::move(fingerprint)].push_back(gt.get());
+      }
+    }
+  }
+
+  // Within a group, a target re-uses the PCH of the first owner that
+  // does not depend on it, and becomes an owner itself otherwise.
+  // Visit dependencies before their dependents so that the owners are
+  // the targets at the bottom of the dependency graph.  Target order
+  // within a directory is not stable, so break ties by name.
+  PchReuseGraph graph;
+  std::vector<cmGeneratorTarget*> reusers;
+  for (auto& group : groups) {
+    std::vector<cmGeneratorTarget*>& targets = group.second;
+    std::map<cmGeneratorTarget const*, std::size_t> depth;
+    for (cmGeneratorTarget const* gt : targets) {
+      depth[gt] = graph.GetReachable(gt).size();
+    }
+    std::sort(targets.begin(), targets.end(),
+              [&depth](cmGeneratorTarget const* l,
+                       cmGeneratorTarget const* r) {
+                if (depth[l] != depth[r]) {
+                  return depth[l] < depth[r];
+                }
+                return cmTarget::StrictTargetComparison()(l->Target,
+                                                          r->Target);
+              });
+
+    std::vector<cmGeneratorTarget*> groupOwners;
+    for (cmGeneratorTarget* gt : targets) {
+      auto const owner =
+        std::find_if(groupOwners.begin(), groupOwners.end(),
+                     [&graph, gt](cmGeneratorTarget const* o) {
+                       return graph.GetReachable(o).count(gt) == 0;
+                     });
+      if (owner == groupOwners.end()) {
+        groupOwners.push_back(gt);
+        continue;
+      }
+      gt->Target->SetProperty("PRECOMPILE_HEADERS", nullptr);
+      gt->Target->SetProperty("PRECOMPILE_HEADERS_REUSE_FROM",
+                              (*owner)->GetName());
+      graph.AddEdge(gt, *owner);
+      reusers.push_back(gt);
+    }
+    cm::append(owners, groupOwners);
+  }
+
+  // As in AddAutomaticSources, handle the targets that re-use a PCH
+  // after the targets they re-use it from.
+  for (cmGeneratorTarget* gt : owners) {
+    gt->GetLocalGenerator()->AddPchDependencies(gt);
+  }
+  for (cmGeneratorTarget* gt : reusers) {
+    gt->GetLocalGenerator()->AddPchDependencies(gt);
+  }
+  for (cmGeneratorTarget* gt : owners) {
+    gt->ClearSourcesCache();
+  }
+  for (cmGeneratorTarget* gt : reusers) {
+    gt->ClearSourcesCache();
+  }
+}
+
 std::unique_ptr<cmLinkLineComputer> cmGlobalGenerator::CreateLinkLineComputer(
   cmOutputConverter* outputConverter, cmStateDirectory const& stateDir) const
 {
@@ -1843,8 +2104,9 @@ void cmGlobalGenerator::CheckTargetProperties()
 int cmGlobalGenerator::TryCompile(int jobs, const std::string& srcdir,
                                   const std::string& bindir,
                                   const std::string& projectName,
-                                  const std::string& target, bool fast,
-                                  std::string& output, cmMakefile* mf)
+                                  std::vector<std::string> const& targetNames,
+                                  bool fast, std::string& output,
+                                  cmMakefile* mf, bool keepGoing)
 {
   // if this is not set, then this is a first time configure
   // and there is a good chance that the try compile stuff will
@@ -1864,14 +2126,15 @@ int cmGlobalGenerator::TryCompile(int jobs, const std::string& srcdir,
                                         this->FirstTimeProgress);
   }
 
-  std::vector<std::string> newTarget = {};
-  if (!target.empty()) {
-    newTarget = { target };
-  }
   std::string config =
     mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
-  return this->Build(jobs, srcdir, bindir, projectName, newTarget, output, "",
-                     config, false, fast, false, this->TryCompileTimeout);
+  std::vector<std::string> nativeOptions;
+  if (keepGoing) {
+    nativeOptions = this->GetKeepGoingBuildOptions();
+  }
+  return this->Build(jobs, srcdir, bindir, projectName, targetNames, output,
+                     "", config, false, fast, false, this->TryCompileTimeout,
+                     cmSystemTools::OUTPUT_NONE, nativeOptions);
 }
 
 std::vector<cmGlobalGenerator::GeneratedMakeCommand>
@@ -2947,12 +3210,8 @@ void cmGlobalGenerator::AddRuleHash(const std::vector<std::string>& outputs,
   }
 
   // Compute a hash of the rule.
-  RuleHash hash;
-  {
-    cmCryptoHash md5(cmCryptoHash::AlgoMD5);
-    std::string const md5_hex = md5.HashString(content);
-    memcpy(hash.Data, md5_hex.c_str(), 32);
-  }
+  cmCryptoHash md5(cmCryptoHash::AlgoMD5);
+  std::string const md5_hex = md5.HashString(content);
 
   // Shorten the output name (in expected use case).
   cmStateDirectory cmDir =
@@ -2961,13 +3220,23 @@ void cmGlobalGenerator::AddRuleHash(const std::vector<std::string>& outputs,
     this->GetMakefiles()[0]->GetState()->GetBinaryDirectory(), outputs[0]);
 
   // Associate the hash with this output.
-  this->RuleHashes[fname] = hash;
+  this->AddFileRuleHash(fname, md5_hex);
 #else
   (void)outputs;
   (void)content;
 #endif
 }
 
+void cmGlobalGenerator::AddFileRuleHash(std::string const& fname,
+                                        std::string const& hash)
+{
+  if (hash.size() != 32) {
+    return;
+  }
+  RuleHash& rh = this->RuleHashes[fname];
+  memcpy(rh.Data, hash.c_str(), 32);
+}
+
 void cmGlobalGenerator::CheckRuleHashes()
 {
 #if !defined(CMAKE_BOOTSTRAP)
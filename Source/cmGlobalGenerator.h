@@ -205,12 +205,14 @@ public:
 
   /**
    * Try running cmake and building a file. This is used for dynamically
-   * loaded commands, not as part of the usual build process.
+   * loaded commands, not as part of the usual build process.  With
+   * keepGoing the build continues past failed targets where the native
+   * build tool supports it.
    */
   int TryCompile(int jobs, const std::string& srcdir,
                  const std::string& bindir, const std::string& projectName,
-                 const std::string& targetName, bool fast, std::string& output,
-                 cmMakefile* mf);
+                 std::vector<std::string> const& targetNames, bool fast,
+                 std::string& output, cmMakefile* mf, bool keepGoing = false);
 
   /**
    * Build a file given the following information. This is a more direct call
@@ -413,6 +415,11 @@ public:
   void AddRuleHash(const std::vector<std::string>& outputs,
                    std::string const& content);
 
+  /** Add the 32-byte hex hash of the rule of a file named relative to the
+      top of the build tree, as AddRuleHash computes it.  */
+  virtual void AddFileRuleHash(std::string const& fname,
+                               std::string const& hash);
+
   /** Return whether the given binary directory is unused.  */
   bool BinaryDirectoryIsNew(const std::string& dir)
   {
@@ -450,6 +457,13 @@ public:
 
   virtual bool SupportsCustomCommandDepfile() const { return false; }
 
+  /** Return the options that make the native build tool keep building
+      other targets after one of them fails, if it has any.  */
+  virtual std::vector<std::string> GetKeepGoingBuildOptions() const
+  {
+    return {};
+  }
+
   std::string GetSharedLibFlagsForLanguage(std::string const& lang) const;
 
   /** Generate an <output>.rule file path for a given command output.  */
@@ -531,6 +545,7 @@ protected:
   bool QtAutoGen();
 
   bool AddAutomaticSources();
+  void AddAutomaticPchReuse();
 
   std::string SelectMakeProgram(const std::string& makeProgram,
                                 const std::string& makeDefault = "") const;
@@ -34,6 +34,11 @@ public:
   /** Get the documentation entry for this generator.  */
   static void GetDocumentation(cmDocumentationEntry& entry);
 
+  std::vector<std::string> GetKeepGoingBuildOptions() const override
+  {
+    return { "/K" };
+  }
+
   /**
    * Try to determine system information such as shared library
    * extension, pthreads, byte order etc.
@@ -9,6 +9,7 @@
 
 #include <cm/iterator>
 #include <cm/memory>
+#include <cm/string_view>
 #include <cmext/algorithm>
 #include <cmext/memory>
 
@@ -127,17 +128,80 @@ std::string cmGlobalNinjaGenerator::EncodeLiteral(const std::string& lit)
 
 std::string cmGlobalNinjaGenerator::EncodePath(const std::string& path)
 {
-  std::string result = path;
+  std::string result;
+  this->AppendEncodedPath(result, path);
+  return result;
+}
+
+void cmGlobalNinjaGenerator::AppendEncodedPath(std::string& out,
+                                               const std::string& path)
+{
+#ifndef _WIN32
+  // Most paths have nothing to escape.
+  if (path.find_first_of("$\n :") == std::string::npos) {
+    out += path;
+    return;
+  }
+#endif
+  // Encode in one pass what EncodeLiteral would, then spaces and colons.
+  cm::string_view const cfgIntDir =
+    this->IsMultiConfig() ? this->GetCMakeCFGIntDir() : "";
+  out.reserve(out.size() + path.size() + 8);
+  for (std::string::size_type i = 0; i < path.size(); ++i) {
+    char const c = path[i];
+    switch (c) {
+      case '$':
+        // The per-config directory placeholder is left for ninja.
+        if (!cfgIntDir.empty() &&
+            path.compare(i, cfgIntDir.size(), cfgIntDir.data(),
+                         cfgIntDir.size()) == 0) {
+          out.append(cfgIntDir.data(), cfgIntDir.size());
+          i += cfgIntDir.size() - 1;
+          continue;
+        }
+        out += "$$";
+        break;
+      case '\n':
+      case ' ':
+      case ':':
+        out += '$';
+        out += c;
+        break;
 #ifdef _WIN32
-  if (this->IsGCCOnWindows())
-    std::replace(result.begin(), result.end(), '\\', '/');
-  else
-    std::replace(result.begin(), result.end(), '/', '\\');
+      case '/':
+      case '\\':
+        out += this->IsGCCOnWindows() ? '/' : '\\';
+        break;
 #endif
-  result = EncodeLiteral(result);
-  cmSystemTools::ReplaceString(result, " ", "$ ");
-  cmSystemTools::ReplaceString(result, ":", "$:");
-  return result;
+      default:
+        out += c;
+        break;
+    }
+  }
+}
+
+namespace {
+void AppendVariable(std::string& out, const std::string& name,
+                    const std::string& value)
+{
+  // Do not add a variable if the value is empty.
+  auto start = value.begin();
+  auto stop = value.end();
+  while (start != stop && cmIsSpace(*start)) {
+    ++start;
+  }
+  while (start != stop && cmIsSpace(*(stop - 1))) {
+    --stop;
+  }
+  if (start == stop) {
+    return;
+  }
+  out += cmGlobalNinjaGenerator::INDENT;
+  out += name;
+  out += " = ";
+  out.append(start, stop);
+  out += '\n';
+}
 }
 
 void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
@@ -161,77 +225,78 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
 
   cmGlobalNinjaGenerator::WriteComment(os, build.Comment);
 
+  // Assemble the statement in a buffer kept across calls, so that writing
+  // a statement does not allocate once the buffer has grown.
+  std::string& buffer = this->BuildStatementBuffer;
+  buffer = "build";
+
   // Write output files.
-  std::string buildStr("build");
   {
     // Write explicit outputs
     for (std::string const& output : build.Outputs) {
-      buildStr += cmStrCat(' ', EncodePath(output));
+      buffer += ' ';
+      this->AppendEncodedPath(buffer, output);
       if (this->ComputingUnknownDependencies) {
         this->CombinedBuildOutputs.insert(output);
       }
     }
     // Write implicit outputs
     if (!build.ImplicitOuts.empty()) {
-      buildStr += " |";
+      buffer += " |";
       for (std::string const& implicitOut : build.ImplicitOuts) {
-        buildStr += cmStrCat(' ', EncodePath(implicitOut));
+        buffer += ' ';
+        this->AppendEncodedPath(buffer, implicitOut);
       }
     }
-    buildStr += ':';
+    buffer += ':';
 
     // Write the rule.
-    buildStr += cmStrCat(' ', build.Rule);
+    buffer += ' ';
+    buffer += build.Rule;
   }
 
-  std::string arguments;
   {
     // TODO: Better formatting for when there are multiple input/output files.
 
     // Write explicit dependencies.
     for (std::string const& explicitDep : build.ExplicitDeps) {
-      arguments += cmStrCat(' ', EncodePath(explicitDep));
+      buffer += ' ';
+      this->AppendEncodedPath(buffer, explicitDep);
     }
 
     // Write implicit dependencies.
     if (!build.ImplicitDeps.empty()) {
-      arguments += " |";
+      buffer += " |";
       for (std::string const& implicitDep : build.ImplicitDeps) {
-        arguments += cmStrCat(' ', EncodePath(implicitDep));
+        buffer += ' ';
+        this->AppendEncodedPath(buffer, implicitDep);
       }
     }
 
     // Write order-only dependencies.
     if (!build.OrderOnlyDeps.empty()) {
-      arguments += " ||";
+      buffer += " ||";
       for (std::string const& orderOnlyDep : build.OrderOnlyDeps) {
-        arguments += cmStrCat(' ', EncodePath(orderOnlyDep));
+        buffer += ' ';
+        this->AppendEncodedPath(buffer, orderOnlyDep);
       }
     }
 
-    arguments += '\n';
+    buffer += '\n';
   }
 
   // Write the variables bound to this build statement.
-  std::string assignments;
   {
-    std::ostringstream variable_assignments;
     for (auto const& variable : build.Variables) {
-      cmGlobalNinjaGenerator::WriteVariable(
-        variable_assignments, variable.first, variable.second, "", 1);
+      AppendVariable(buffer, variable.first, variable.second);
     }
 
     // check if a response file rule should be used
-    assignments = variable_assignments.str();
     bool useResponseFile = false;
     if (cmdLineLimit < 0 ||
         (cmdLineLimit > 0 &&
-         (arguments.size() + buildStr.size() + assignments.size() + 1000) >
-           static_cast<size_t>(cmdLineLimit))) {
-      variable_assignments.str(std::string());
-      cmGlobalNinjaGenerator::WriteVariable(variable_assignments, "RSP_FILE",
-                                            build.RspFile, "", 1);
-      assignments += variable_assignments.str();
+         (buffer.size() + 1000) > static_cast<size_t>(cmdLineLimit))) {
+      AppendVariable(buffer, "RSP_FILE", build.RspFile);
       useResponseFile = true;
     }
     if (usedResponseFile) {
@@ -239,7 +304,8 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
     }
   }
 
-  os << buildStr << arguments << assignments << "\n";
+  buffer += '\n';
+  os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
 }
 
 void cmGlobalNinjaGenerator::AddCustomCommandRule()
@@ -417,6 +483,14 @@ void cmGlobalNinjaGenerator::WriteInclude(std::ostream& os,
   os << "include " << filename << "\n";
 }
 
+void cmGlobalNinjaGenerator::WriteSubninja(std::ostream& os,
+                                           const std::string& filename,
+                                           const std::string& comment)
+{
+  cmGlobalNinjaGenerator::WriteComment(os, comment);
+  os << "subninja " << filename << "\n";
+}
+
 void cmGlobalNinjaGenerator::WriteDefault(std::ostream& os,
                                           const cmNinjaDeps& targets,
                                           const std::string& comment)
@@ -496,6 +570,10 @@ void cmGlobalNinjaGenerator::Generate()
   for (auto& it : this->Configs) {
     it.second.TargetDependsClosures.clear();
   }
+  this->TargetArtifactPaths.clear();
+
+  this->UseSubninja =
+    this->LocalGenerators[0]->GetMakefile()->IsOn("CMAKE_NINJA_SUBNINJA");
 
   this->InitOutputPathPrefix();
   this->TargetAll = this->NinjaOutputPath("all");
@@ -913,6 +991,79 @@ void cmGlobalNinjaGenerator::CloseBuildFileStreams()
   }
 }
 
+bool cmGlobalNinjaGenerator::OpenDirectoryFileStreams(
+  cmLocalGenerator const* lg)
+{
+  if (!this->UseSubninja) {
+    return true;
+  }
+
+  std::vector<std::string> const configs =
+    lg->GetMakefile()->GetGeneratorConfigs(cmMakefile::IncludeEmptyConfig);
+  std::vector<std::string> paths;
+  for (std::string const& config : configs) {
+    std::string path =
+      cmStrCat(lg->GetCurrentBinaryDirectory(), "/CMakeFiles/directory");
+    if (this->IsMultiConfig()) {
+      path += cmStrCat('-', config);
+    }
+    path += ".ninja";
+    cmGlobalNinjaGenerator::WriteSubninja(
+      *this->GetImplFileStream(config),
+      this->EncodePath(this->ConvertToNinjaPath(path)),
+      "Include the build statements of directory " +
+        lg->GetCurrentBinaryDirectory());
+    *this->GetImplFileStream(config) << "\n";
+    paths.push_back(std::move(path));
+  }
+
+  // Write the statements of the directory only after the subninja
+  // statements have been written to the main files.
+  for (std::size_t i = 0; i < configs.size(); ++i) {
+    std::unique_ptr<cmGeneratedFileStream>& stream =
+      this->DirectoryFileStreams[configs[i]];
+    stream = cm::make_unique<cmGeneratedFileStream>(
+      paths[i], false, this->GetMakefileEncoding());
+    if (!*stream) {
+      this->DirectoryFileStreams.clear();
+      return false;
+    }
+    // Unchanged directories keep their file.
+    stream->SetCopyIfDifferent(true);
+    this->WriteDisclaimer(*stream);
+    *stream << "# This file contains the build statements of directory\n"
+            << "# " << lg->GetCurrentBinaryDirectory() << "\n\n";
+  }
+  return true;
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryFileStreams()
+{
+  for (auto& stream : this->DirectoryFileStreams) {
+    if (cmSystemTools::GetErrorOccuredFlag()) {
+      stream.second->setstate(std::ios::failbit);
+    }
+  }
+  this->DirectoryFileStreams.clear();
+}
+
+cmGeneratedFileStream* cmGlobalNinjaGenerator::GetDirectoryFileStream(
+  const std::string& config) const
+{
+  if (this->DirectoryFileStreams.empty()) {
+    return nullptr;
+  }
+  // The single-configuration generator writes one file for any config.
+  if (!this->IsMultiConfig()) {
+    return this->DirectoryFileStreams.begin()->second.get();
+  }
+  auto const i = this->DirectoryFileStreams.find(config);
+  if (i == this->DirectoryFileStreams.end()) {
+    return nullptr;
+  }
+  return i->second.get();
+}
+
 bool cmGlobalNinjaGenerator::OpenRulesFileStream()
 {
   if (!this->OpenFileStream(this->RulesFileStream,
@@ -1081,8 +1232,18 @@ void cmGlobalNinjaGenerator::AppendTargetOutputs(
     }
     // FALLTHROUGH
     case cmStateEnums::EXECUTABLE: {
-      outputs.push_back(this->ConvertToNinjaPath(target->GetFullPath(
-        config, cmStateEnums::RuntimeBinaryArtifact, realname)));
+      // Every target depending on this one names its artifact.
+      auto const key = std::make_pair(target, config);
+      auto i = this->TargetArtifactPaths.find(key);
+      if (i == this->TargetArtifactPaths.end()) {
+        i = this->TargetArtifactPaths
+              .emplace(key,
+                       this->ConvertToNinjaPath(target->GetFullPath(
+                         config, cmStateEnums::RuntimeBinaryArtifact,
+                         realname)))
+              .first;
+      }
+      outputs.push_back(i->second);
       break;
     }
     case cmStateEnums::OBJECT_LIBRARY: {
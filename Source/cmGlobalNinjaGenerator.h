@@ -79,6 +79,7 @@ public:
   static std::string EncodeRuleName(std::string const& name);
   std::string EncodeLiteral(const std::string& lit);
   std::string EncodePath(const std::string& path);
+  void AppendEncodedPath(std::string& out, const std::string& path);
 
   std::unique_ptr<cmLinkLineComputer> CreateLinkLineComputer(
     cmOutputConverter* outputConverter,
@@ -144,6 +145,13 @@ public:
   static void WriteInclude(std::ostream& os, const std::string& filename,
                            const std::string& comment = "");
 
+  /**
+   * Write a subninja statement including @a filename in its own scope
+   * with an optional @a comment to the @a os stream.
+   */
+  static void WriteSubninja(std::ostream& os, const std::string& filename,
+                            const std::string& comment = "");
+
   /**
    * Write a default target statement specifying @a targets as
    * the default targets.
@@ -213,9 +221,17 @@ public:
 
   bool SupportsCustomCommandDepfile() const override { return true; }
 
+  std::vector<std::string> GetKeepGoingBuildOptions() const override
+  {
+    return { "-k", "0" };
+  }
+
   virtual cmGeneratedFileStream* GetImplFileStream(
-    const std::string& /*config*/) const
+    const std::string& config) const
   {
+    if (cmGeneratedFileStream* os = this->GetDirectoryFileStream(config)) {
+      return os;
+    }
     return this->BuildFileStream.get();
   }
 
@@ -240,6 +256,16 @@ public:
     return this->RulesFileStream.get();
   }
 
+  /**
+   * If CMAKE_NINJA_SUBNINJA is enabled, write a subninja statement for the
+   * build statements of the directory of @a lg and send the build
+   * statements written until CloseDirectoryFileStreams() to that file.
+   */
+  bool OpenDirectoryFileStreams(cmLocalGenerator const* lg);
+  void CloseDirectoryFileStreams();
+  cmGeneratedFileStream* GetDirectoryFileStream(
+    const std::string& config) const;
+
   std::string const& ConvertToNinjaPath(const std::string& path) const;
 
   struct MapToNinjaPathImpl
@@ -483,6 +509,11 @@ private:
   /// The file containing the rule statements. (The action attached to each
   /// edge of the compilation DAG).
   std::unique_ptr<cmGeneratedFileStream> RulesFileStream;
+  /// The files of the build statements of the directory being generated,
+  /// by configuration, if CMAKE_NINJA_SUBNINJA is enabled.
+  std::map<std::string, std::unique_ptr<cmGeneratedFileStream>>
+    DirectoryFileStreams;
+  bool UseSubninja = false;
   std::unique_ptr<cmGeneratedFileStream> CompileCommandsStream;
 
   /// The set of rules added to the generated build system.
@@ -523,6 +554,13 @@ private:
   /// the local cache for calls to ConvertToNinjaPath
   mutable std::unordered_map<std::string, std::string> ConvertToNinjaPathCache;
 
+  /// the Ninja paths of the artifacts of targets, by target and config
+  std::map<std::pair<cmGeneratorTarget const*, std::string>, std::string>
+    TargetArtifactPaths;
+
+  /// the text of the build statement being written by WriteBuild
+  std::string BuildStatementBuffer;
+
   std::string NinjaCommand;
   std::string NinjaVersion;
   bool NinjaSupportsConsolePool = false;
@@ -609,6 +647,9 @@ public:
   cmGeneratedFileStream* GetImplFileStream(
     const std::string& config) const override
   {
+    if (cmGeneratedFileStream* os = this->GetDirectoryFileStream(config)) {
+      return os;
+    }
     return this->ImplFileStreams.at(config).get();
   }
 
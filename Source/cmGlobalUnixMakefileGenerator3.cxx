@@ -11,6 +11,8 @@
 #include <cmext/algorithm>
 #include <cmext/memory>
 
+#include "cmsys/FStream.hxx"
+
 #include "cmDocumentationEntry.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorTarget.h"
@@ -27,6 +29,7 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmTargetDepend.h"
+#include "cmTargetFingerprints.h"
 #include "cmake.h"
 
 cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3(cmake* cm)
@@ -134,6 +137,17 @@ void cmGlobalUnixMakefileGenerator3::Configure()
 
 void cmGlobalUnixMakefileGenerator3::Generate()
 {
+  std::string const fingerprintsFile =
+    cmStrCat(this->GetCMakeInstance()->GetHomeOutputDirectory(),
+             "/CMakeFiles/CMakeTargetFingerprints.txt");
+#ifndef CMAKE_BOOTSTRAP
+  if (this->LocalGenerators[0]->GetMakefile()->IsOn(
+        "CMAKE_INCREMENTAL_GENERATE")) {
+    this->Fingerprints = cm::make_unique<cmTargetFingerprints>(this);
+    this->ReadTargetFingerprints(fingerprintsFile);
+  }
+#endif
+
   // first do superclass method
   this->cmGlobalGenerator::Generate();
 
@@ -169,6 +183,149 @@ void cmGlobalUnixMakefileGenerator3::Generate()
     *this->CommandDatabase << "\n]";
     this->CommandDatabase.reset();
   }
+
+  this->WriteTargetFingerprints(fingerprintsFile);
+  this->Fingerprints.reset();
+  this->PreviousTargetFingerprints.clear();
+  this->TargetFingerprints.clear();
+}
+
+void cmGlobalUnixMakefileGenerator3::ReadTargetFingerprints(
+  std::string const& fname)
+{
+  cmsys::ifstream fin(fname.c_str());
+  if (!fin) {
+    return;
+  }
+  // Each line holds a 32-byte hex hash, the number of progress actions,
+  // the set of rule files written and the full path to the target
+  // directory, separated by spaces.  It is followed by a line for each
+  // custom command rule of the target, with a space, the 32-byte hex hash
+  // of the rule, a space and the output named as in CMakeRuleHashes.txt.
+  std::string line;
+  TargetFingerprint* target = nullptr;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.size() > 34 && line[0] == ' ' && line[33] == ' ') {
+      if (target) {
+        target->RuleHashes[line.substr(34)] = line.substr(1, 32);
+      }
+      continue;
+    }
+    target = nullptr;
+    if (line.size() < 38 || line[0] == '#' || line[32] != ' ') {
+      continue;
+    }
+    std::string::size_type const pos = line.find(' ', 33);
+    std::string::size_type const end =
+      pos == std::string::npos ? pos : line.find(' ', pos + 1);
+    unsigned long actions = 0;
+    unsigned long files = 0;
+    if (end == std::string::npos ||
+        !cmStrToULong(line.substr(33, pos - 33), &actions) ||
+        !cmStrToULong(line.substr(pos + 1, end - pos - 1), &files)) {
+      continue;
+    }
+    TargetFingerprint& fp = this->PreviousTargetFingerprints[line.substr(
+      end + 1)];
+    fp.Hash = line.substr(0, 32);
+    fp.NumberOfActions = actions;
+    fp.RuleFiles = files;
+    target = &fp;
+  }
+}
+
+void cmGlobalUnixMakefileGenerator3::WriteTargetFingerprints(
+  std::string const& fname)
+{
+  if (this->TargetFingerprints.empty()) {
+    cmSystemTools::RemoveFile(fname);
+    return;
+  }
+  cmGeneratedFileStream fout(fname);
+  fout << "# Fingerprints of the inputs of target rule files.\n";
+  for (auto const& tf : this->TargetFingerprints) {
+    fout << tf.second.Hash << ' ' << tf.second.NumberOfActions << ' '
+         << tf.second.RuleFiles << ' ' << tf.first << '\n';
+    for (auto const& rh : tf.second.RuleHashes) {
+      fout << ' ' << rh.second << ' ' << rh.first << '\n';
+    }
+  }
+}
+
+namespace {
+// The files a cmMakefileTargetGenerator may write to the target directory.
+char const* const TargetRuleFiles[] = {
+  "/build.make",           "/cmake_clean.cmake", "/cmake_clean_target.cmake",
+  "/compiler_depend.make", "/depend.make",       "/DependInfo.cmake",
+  "/flags.make",           "/link.txt"
+};
+}
+
+unsigned long cmGlobalUnixMakefileGenerator3::GetTargetRuleFiles(
+  std::string const& dir)
+{
+  unsigned long files = 0;
+  unsigned long bit = 1;
+  for (char const* name : TargetRuleFiles) {
+    if (cmSystemTools::FileExists(cmStrCat(dir, name))) {
+      files |= bit;
+    }
+    bit <<= 1;
+  }
+  return files;
+}
+
+std::string cmGlobalUnixMakefileGenerator3::GetTargetDirectoryFull(
+  cmGeneratorTarget const* target) const
+{
+  cmLocalGenerator* lg = target->GetLocalGenerator();
+  return cmStrCat(lg->GetCurrentBinaryDirectory(), '/',
+                  lg->GetTargetDirectory(target));
+}
+
+bool cmGlobalUnixMakefileGenerator3::ReuseTargetRuleFiles(
+  cmMakefileTargetGenerator* tg)
+{
+#ifndef CMAKE_BOOTSTRAP
+  cmGeneratorTarget const* target = tg->GetGeneratorTarget();
+  // Targets adding to the compilation database must always be written.
+  if (!this->Fingerprints ||
+      target->Makefile->IsOn("CMAKE_EXPORT_COMPILE_COMMANDS")) {
+    return false;
+  }
+  std::string const dir = this->GetTargetDirectoryFull(target);
+  TargetFingerprint& fp = this->TargetFingerprints[dir];
+  fp.Hash = this->Fingerprints->GetFingerprint(target);
+  auto const prev = this->PreviousTargetFingerprints.find(dir);
+  // Every rule file written last time must still be there.
+  if (prev == this->PreviousTargetFingerprints.end() ||
+      prev->second.Hash != fp.Hash || prev->second.RuleFiles == 0 ||
+      (GetTargetRuleFiles(dir) & prev->second.RuleFiles) !=
+        prev->second.RuleFiles) {
+    this->WrittenTargetFingerprint = &fp;
+    return false;
+  }
+  tg->ReuseRuleFiles(prev->second.NumberOfActions);
+  // Keep the hashes of the custom command rules written last time so that
+  // their outputs are still rebuilt when the rules change later.
+  for (auto const& rh : prev->second.RuleHashes) {
+    this->cmGlobalGenerator::AddFileRuleHash(rh.first, rh.second);
+  }
+  fp.RuleHashes = prev->second.RuleHashes;
+  return true;
+#else
+  static_cast<void>(tg);
+  return false;
+#endif
+}
+
+void cmGlobalUnixMakefileGenerator3::AddFileRuleHash(
+  std::string const& fname, std::string const& hash)
+{
+  this->cmGlobalGenerator::AddFileRuleHash(fname, hash);
+  if (this->WrittenTargetFingerprint) {
+    this->WrittenTargetFingerprint->RuleHashes[fname] = hash;
+  }
 }
 
 void cmGlobalUnixMakefileGenerator3::AddCXXCompileCommand(
@@ -778,9 +935,13 @@ void cmGlobalUnixMakefileGenerator3::WriteConvenienceRules2(
         progCmd << lg.ConvertToOutputFormat(progress.Dir,
                                             cmOutputConverter::SHELL);
         //
-        std::set<cmGeneratorTarget const*> emitted;
-        progCmd << " "
-                << this->CountProgressMarksInTarget(gtarget.get(), emitted);
+        size_t count = 0;
+        for (std::size_t const i :
+             this->GetTargetDependClosure(gtarget.get())) {
+          count +=
+            this->ProgressMap[this->DependClosureTargets[i]].Marks.size();
+        }
+        progCmd << " " << count;
         commands.push_back(progCmd.str());
       }
       std::string tmp = "CMakeFiles/Makefile2";
@@ -890,6 +1051,29 @@ size_t cmGlobalUnixMakefileGenerator3::CountProgressMarksInTarget(
   return count;
 }
 
+cmBitSet const& cmGlobalUnixMakefileGenerator3::GetTargetDependClosure(
+  cmGeneratorTarget const* target)
+{
+  auto const i = this->TargetDependClosures.find(target);
+  if (i != this->TargetDependClosures.end()) {
+    return i->second.Targets;
+  }
+
+  TargetDependClosure& closure = this->TargetDependClosures[target];
+  closure.Index = this->DependClosureTargets.size();
+  this->DependClosureTargets.push_back(target);
+  closure.Targets.insert(closure.Index);
+
+  // The final target dependency graph has no cycles, so the closures of
+  // the dependencies are complete when merged into this one.
+  for (cmTargetDepend const& depend : this->GetTargetDirectDepends(target)) {
+    if (depend->GetType() != cmStateEnums::INTERFACE_LIBRARY) {
+      closure.Targets |= this->GetTargetDependClosure(depend);
+    }
+  }
+  return closure.Targets;
+}
+
 size_t cmGlobalUnixMakefileGenerator3::CountProgressMarksInAll(
   const cmLocalGenerator& lg)
 {
@@ -908,6 +1092,15 @@ void cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
   TargetProgress& tp = this->ProgressMap[tg->GetGeneratorTarget()];
   tp.NumberOfActions = tg->GetNumberOfProgressActions();
   tp.VariableFile = tg->GetProgressFileNameFull();
+
+  std::string const dir =
+    this->GetTargetDirectoryFull(tg->GetGeneratorTarget());
+  auto const fp = this->TargetFingerprints.find(dir);
+  if (fp != this->TargetFingerprints.end()) {
+    fp->second.NumberOfActions = tp.NumberOfActions;
+    fp->second.RuleFiles = GetTargetRuleFiles(dir);
+  }
+  this->WrittenTargetFingerprint = nullptr;
 }
 
 void cmGlobalUnixMakefileGenerator3::TargetProgress::WriteProgressVariables(
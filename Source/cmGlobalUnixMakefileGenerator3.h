@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 
+#include "cmBitSet.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalCommonGenerator.h"
 #include "cmGlobalGeneratorFactory.h"
@@ -23,6 +24,7 @@ class cmLocalGenerator;
 class cmLocalUnixMakefileGenerator3;
 class cmMakefile;
 class cmMakefileTargetGenerator;
+class cmTargetFingerprints;
 class cmake;
 struct cmDocumentationEntry;
 
@@ -150,6 +152,14 @@ public:
     std::vector<std::string> const& makeOptions =
       std::vector<std::string>()) override;
 
+  /** Reuse the rule files written for a target by a previous run if
+      CMAKE_INCREMENTAL_GENERATE is enabled and none of their inputs
+      changed since.  Returns false if the rule files must be written.  */
+  bool ReuseTargetRuleFiles(cmMakefileTargetGenerator* tg);
+
+  void AddFileRuleHash(std::string const& fname,
+                       std::string const& hash) override;
+
   /** Record per-target progress information.  */
   void RecordTargetProgress(cmMakefileTargetGenerator* tg);
 
@@ -168,6 +178,11 @@ public:
 
   bool IsIPOSupported() const override { return true; }
 
+  std::vector<std::string> GetKeepGoingBuildOptions() const override
+  {
+    return { "-k" };
+  }
+
   void ComputeTargetObjectDirectory(cmGeneratorTarget* gt) const override;
 
   std::string IncludeDirective;
@@ -248,8 +263,41 @@ protected:
     std::set<cmGeneratorTarget const*>& emitted);
   size_t CountProgressMarksInAll(const cmLocalGenerator& lg);
 
+  // Store the targets each target depends on, directly or not, as
+  // indices into DependClosureTargets.  Computed once per target from
+  // those of its dependencies.
+  struct TargetDependClosure
+  {
+    std::size_t Index = 0;
+    cmBitSet Targets;
+  };
+  cmBitSet const& GetTargetDependClosure(cmGeneratorTarget const* target);
+  std::map<cmGeneratorTarget const*, TargetDependClosure> TargetDependClosures;
+  std::vector<cmGeneratorTarget const*> DependClosureTargets;
+
   std::unique_ptr<cmGeneratedFileStream> CommandDatabase;
 
+  // Store the fingerprints of the inputs of each target's rule files.
+  struct TargetFingerprint
+  {
+    std::string Hash;
+    unsigned long NumberOfActions = 0;
+    // Bit set of the rule files present after they were written.
+    unsigned long RuleFiles = 0;
+    // The hashes of the custom command rules written, by output.
+    std::map<std::string, std::string> RuleHashes;
+  };
+  using TargetFingerprintMap = std::map<std::string, TargetFingerprint>;
+  static unsigned long GetTargetRuleFiles(std::string const& dir);
+  void ReadTargetFingerprints(std::string const& fname);
+  void WriteTargetFingerprints(std::string const& fname);
+  std::string GetTargetDirectoryFull(cmGeneratorTarget const* target) const;
+  std::unique_ptr<cmTargetFingerprints> Fingerprints;
+  TargetFingerprintMap PreviousTargetFingerprints;
+  TargetFingerprintMap TargetFingerprints;
+  // The target whose rule files are being written, if fingerprinted.
+  TargetFingerprint* WrittenTargetFingerprint = nullptr;
+
 private:
   const char* GetBuildIgnoreErrorsFlag() const override { return "-i"; }
   std::string GetEditCacheCommand() const override;
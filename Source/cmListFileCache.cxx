@@ -5,11 +5,15 @@
 #include <cassert>
 #include <memory>
 #include <sstream>
+#include <string>
 #include <utility>
 
+#include <cm/string_view>
+
 #include "cmListFileLexer.h"
 #include "cmMessageType.h"
 #include "cmMessenger.h"
+#include "cmParsedListFileCache.h"
 #include "cmState.h"
 #include "cmStateDirectory.h"
 #include "cmStringAlgorithms.h"
@@ -33,6 +37,7 @@ struct cmListFileParser
   void IssueFileOpenError(std::string const& text) const;
   void IssueError(std::string const& text) const;
   bool ParseFile(const char* filename);
+  bool ParseFileContent(std::string content, const char* filename);
   bool ParseString(const char* str, const char* virtual_filename);
   bool Parse();
   bool ParseFunction(const char* name, long line);
@@ -44,6 +49,7 @@ struct cmListFileParser
   const char* FileName;
   cmListFileLexer* Lexer;
   cmListFileFunction Function;
+  bool IssuedWarning;
   enum
   {
     SeparationOkay,
@@ -59,6 +65,7 @@ cmListFileParser::cmListFileParser(cmListFile* lf, cmListFileBacktrace lfbt,
   , Messenger(messenger)
   , FileName(nullptr)
   , Lexer(cmListFileLexer_New())
+  , IssuedWarning(false)
 {
 }
 
@@ -113,6 +120,42 @@ bool cmListFileParser::ParseFile(const char* filename)
   return Parse();
 }
 
+bool cmListFileParser::ParseFileContent(std::string content,
+                                        const char* filename)
+{
+  this->FileName = filename;
+
+  // Verify the Byte-Order-Mark, if any, as the file lexer does.
+  std::string::size_type start = 0;
+  if (cmHasLiteralPrefix(content, "\xEF\xBB\xBF")) {
+    start = 3;
+  } else if (cmHasLiteralPrefix(content, "\xFE\xFF") ||
+             cmHasLiteralPrefix(content, "\xFF\xFE") ||
+             cmHasPrefix(content, cm::string_view("\0\0\xFE\xFF", 4))) {
+    this->IssueFileOpenError(
+      "File starts with a Byte-Order-Mark that is not UTF-8.");
+    return false;
+  }
+
+  // Convert CRLF -> LF as the file lexer does.
+  std::string::iterator out = content.begin();
+  for (std::string::size_type i = start; i < content.size(); ++i) {
+    if (content[i] == '\r' && i + 1 < content.size() &&
+        content[i + 1] == '\n') {
+      continue;
+    }
+    *out++ = content[i];
+  }
+  content.erase(out, content.end());
+
+  if (!cmListFileLexer_SetString(this->Lexer, content.c_str())) {
+    this->IssueFileOpenError("cmListFileCache: cannot allocate buffer.");
+    return false;
+  }
+
+  return Parse();
+}
+
 bool cmListFileParser::ParseString(const char* str,
                                    const char* virtual_filename)
 {
@@ -166,19 +209,59 @@ bool cmListFileParser::Parse()
 }
 
 bool cmListFile::ParseFile(const char* filename, cmMessenger* messenger,
-                           cmListFileBacktrace const& lfbt)
+                           cmListFileBacktrace const& lfbt,
+                           cmParsedListFileCache* cache)
 {
   if (!cmSystemTools::FileExists(filename) ||
       cmSystemTools::FileIsDirectory(filename)) {
     return false;
   }
 
+#if !defined(CMAKE_BOOTSTRAP)
+  // Parse the same content that is stamped so a concurrent change can
+  // only make the cache entry stale, never wrong.
+  cmParsedListFileCache::Stamp stamp;
+  std::string content;
+  if (cache) {
+    stamp = cmParsedListFileCache::GetStamp(filename, content);
+    // The string lexer stops at a null byte, so leave such files to the
+    // file lexer.
+    if (content.find('\0') != std::string::npos) {
+      stamp = cmParsedListFileCache::Stamp();
+    }
+    if (cache->Find(filename, stamp, this->Functions)) {
+      return true;
+    }
+  }
+#else
+  static_cast<void>(cache);
+#endif
+
   bool parseError = false;
+  bool issuedWarning = false;
 
   {
     cmListFileParser parser(this, lfbt, messenger);
-    parseError = !parser.ParseFile(filename);
+#if !defined(CMAKE_BOOTSTRAP)
+    if (stamp.Valid) {
+      parseError = !parser.ParseFileContent(std::move(content), filename);
+    } else
+#endif
+    {
+      parseError = !parser.ParseFile(filename);
+    }
+    issuedWarning = parser.IssuedWarning;
+  }
+
+#if !defined(CMAKE_BOOTSTRAP)
+  // Files that produce diagnostics are not cached so that every
+  // read reports them again.
+  if (cache && !parseError && !issuedWarning) {
+    cache->Insert(filename, stamp, this->Functions);
   }
+#else
+  static_cast<void>(issuedWarning);
+#endif
 
   return !parseError;
 }
@@ -319,6 +402,7 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
     return false;
   }
   this->Messenger->IssueMessage(MessageType::AUTHOR_WARNING, m.str(), lfbt);
+  this->IssuedWarning = true;
   return true;
 }
 
@@ -21,7 +21,9 @@
  * cmake list files.
  */
 
+class cmCommandBinding;
 class cmMessenger;
+class cmParsedListFileCache;
 
 struct cmCommandContext
 {
@@ -93,6 +95,25 @@ bool operator!=(cmListFileContext const& lhs, cmListFileContext const& rhs);
 struct cmListFileFunction : public cmCommandContext
 {
   std::vector<cmListFileArgument> Arguments;
+
+  // The command binding a cmState resolved for this call, kept so that
+  // executing the call again does not look up the name.  Copies start
+  // unresolved because they may be renamed or run by another state.
+  struct DispatchCache
+  {
+    DispatchCache() = default;
+    DispatchCache(DispatchCache const&) {}
+    DispatchCache& operator=(DispatchCache const&)
+    {
+      this->StateId = 0;
+      this->Binding = nullptr;
+      return *this;
+    }
+
+    unsigned long StateId = 0;
+    cmCommandBinding const* Binding = nullptr;
+  };
+  mutable DispatchCache Dispatch;
 };
 
 // Represent a backtrace (call stack).  Provide value semantics
@@ -208,7 +229,8 @@ std::vector<BT<std::string>> ExpandListWithBacktrace(
 struct cmListFile
 {
   bool ParseFile(const char* path, cmMessenger* messenger,
-                 cmListFileBacktrace const& lfbt);
+                 cmListFileBacktrace const& lfbt,
+                 cmParsedListFileCache* cache = nullptr);
 
   bool ParseString(const char* str, const char* virtual_filename,
                    cmMessenger* messenger, cmListFileBacktrace const& lfbt);
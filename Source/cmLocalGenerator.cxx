@@ -6,8 +6,10 @@
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <queue>
 #include <sstream>
 #include <unordered_set>
 #include <utility>
@@ -2733,6 +2735,115 @@ std::vector<std::string> AddUnityFilesModeAuto(
   return unity_files;
 }
 
+std::vector<std::string> AddUnityFilesModeBalanced(
+  cmGeneratorTarget* target, std::string const& lang,
+  std::vector<cmSourceFile*> const& filtered_sources, cmProp beforeInclude,
+  cmProp afterInclude, std::string const& filename_base, size_t batchSize)
+{
+  if (batchSize == 0) {
+    batchSize = filtered_sources.size();
+  }
+  if (filtered_sources.empty()) {
+    return {};
+  }
+
+  // Estimate the cost of compiling each source.  Sources that do not
+  // exist yet, such as generated ones, cost as much as an average one.
+  std::vector<unsigned long> costs(filtered_sources.size(), 0);
+  std::vector<bool> known(filtered_sources.size(), false);
+  unsigned long knownTotal = 0;
+  size_t knownCount = 0;
+  for (size_t i = 0; i < filtered_sources.size(); ++i) {
+    cmSourceFile* sf = filtered_sources[i];
+    if (cmProp cost = sf->GetProperty("UNITY_BUILD_COST")) {
+      known[i] = cmStrToULong(*cost, &costs[i]);
+      if (!known[i]) {
+        target->GetLocalGenerator()->IssueMessage(
+          MessageType::FATAL_ERROR,
+          cmStrCat("Invalid UNITY_BUILD_COST value of ", *cost,
+                   " assigned to source ", sf->ResolveFullPath(),
+                   ". The value must be a non-negative integer."));
+      }
+    } else {
+      std::string const& path = sf->ResolveFullPath();
+      known[i] = cmSystemTools::FileExists(path, true);
+      if (known[i]) {
+        costs[i] = cmSystemTools::FileLength(path);
+      }
+    }
+    if (known[i]) {
+      knownTotal += costs[i];
+      ++knownCount;
+    }
+  }
+  unsigned long const averageCost = knownCount ? knownTotal / knownCount : 1;
+  for (size_t i = 0; i < costs.size(); ++i) {
+    if (!known[i]) {
+      costs[i] = averageCost;
+    }
+  }
+
+  // Use as many batches as the BATCH mode does, and assign the most
+  // expensive sources first, each to the cheapest batch not yet full.
+  size_t const batchCount =
+    (filtered_sources.size() + batchSize - 1) / batchSize;
+  std::vector<size_t> order(filtered_sources.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&costs](size_t l, size_t r) {
+                     return costs[l] > costs[r];
+                   });
+
+  using BatchLoad = std::pair<unsigned long, size_t>;
+  std::priority_queue<BatchLoad, std::vector<BatchLoad>,
+                      std::greater<BatchLoad>>
+    loads;
+  for (size_t batch = 0; batch < batchCount; ++batch) {
+    loads.emplace(0, batch);
+  }
+  std::vector<size_t> batchOfSource(filtered_sources.size());
+  std::vector<size_t> batchSizes(batchCount, 0);
+  for (size_t i : order) {
+    BatchLoad load = loads.top();
+    loads.pop();
+    batchOfSource[i] = load.second;
+    if (++batchSizes[load.second] < batchSize) {
+      load.first += costs[i];
+      loads.push(load);
+    }
+  }
+
+  std::vector<std::string> unity_files;
+  for (size_t batch = 0; batch < batchCount; ++batch) {
+    std::string filename = cmStrCat(filename_base, "unity_", batch,
+                                    (lang == "C") ? "_c.c" : "_cxx.cxx");
+
+    const std::string filename_tmp = cmStrCat(filename, ".tmp");
+    {
+      cmGeneratedFileStream file(
+        filename_tmp, false,
+        target->GetGlobalGenerator()->GetMakefileEncoding());
+      file << "/* generated by CMake */\n\n";
+
+      // Keep the order of the target's sources within each batch.
+      for (size_t i = 0; i < filtered_sources.size(); ++i) {
+        if (batchOfSource[i] != batch) {
+          continue;
+        }
+        cmSourceFile* sf = filtered_sources[i];
+        RegisterUnitySources(target, sf, filename);
+        IncludeFileInUnitySources(file, sf->ResolveFullPath(), beforeInclude,
+                                  afterInclude);
+      }
+    }
+    cmSystemTools::MoveFileIfDifferent(filename_tmp, filename);
+    unity_files.emplace_back(std::move(filename));
+  }
+  return unity_files;
+}
+
 std::vector<std::string> AddUnityFilesModeGroup(
   cmGeneratorTarget* target, std::string const& lang,
   std::vector<cmSourceFile*> const& filtered_sources, cmProp beforeInclude,
@@ -2829,6 +2940,10 @@ void cmLocalGenerator::AddUnityBuild(cmGeneratorTarget* target)
       unity_files =
         AddUnityFilesModeAuto(target, lang, filtered_sources, beforeInclude,
                               afterInclude, filename_base, unityBatchSize);
+    } else if (unityMode && *unityMode == "BALANCED") {
+      unity_files = AddUnityFilesModeBalanced(target, lang, filtered_sources,
+                                              beforeInclude, afterInclude,
+                                              filename_base, unityBatchSize);
     } else if (unityMode && *unityMode == "GROUP") {
       unity_files =
         AddUnityFilesModeGroup(target, lang, filtered_sources, beforeInclude,
@@ -2837,7 +2952,7 @@ void cmLocalGenerator::AddUnityBuild(cmGeneratorTarget* target)
       // unity mode is set to an unsupported value
       std::string e("Invalid UNITY_BUILD_MODE value of " + *unityMode +
                     " assigned to target " + target->GetName() +
-                    ". Acceptable values are BATCH and GROUP.");
+                    ". Acceptable values are BATCH, BALANCED and GROUP.");
       this->IssueMessage(MessageType::FATAL_ERROR, e);
     }
 
@@ -89,6 +89,10 @@ void cmLocalNinjaGenerator::Generate()
     }
   }
 
+  if (!this->GetGlobalNinjaGenerator()->OpenDirectoryFileStreams(this)) {
+    return;
+  }
+
   for (const auto& target : this->GetGeneratorTargets()) {
     if (target->GetType() == cmStateEnums::INTERFACE_LIBRARY) {
       continue;
@@ -149,6 +153,8 @@ void cmLocalNinjaGenerator::Generate()
     this->WriteCustomCommandBuildStatements(config);
     this->AdditionalCleanFiles(config);
   }
+
+  this->GetGlobalNinjaGenerator()->CloseDirectoryFileStreams();
 }
 
 // TODO: Picked up from cmLocalUnixMakefileGenerator3.  Refactor it.
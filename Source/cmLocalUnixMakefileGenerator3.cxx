@@ -45,6 +45,7 @@
 // C/C++ scanner is needed for bootstrapping CMake.
 #include "cmDependsC.h"
 #ifndef CMAKE_BOOTSTRAP
+#  include "cmDependsCompiler.h"
 #  include "cmDependsFortran.h"
 #  include "cmDependsJava.h"
 #endif
@@ -107,7 +108,9 @@ void cmLocalUnixMakefileGenerator3::Generate()
     std::unique_ptr<cmMakefileTargetGenerator> tg(
       cmMakefileTargetGenerator::New(target.get()));
     if (tg) {
-      tg->WriteRuleFiles();
+      if (!gg->ReuseTargetRuleFiles(tg.get())) {
+        tg->WriteRuleFiles();
+      }
       gg->RecordTargetProgress(tg.get());
     }
   }
@@ -1356,22 +1359,46 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(
       !checker.Check(dependFile, internalDependFile, validDependencies);
   }
 
+  std::string targetName = cmSystemTools::GetFilenameName(targetDir);
+  targetName = targetName.substr(0, targetName.length() - 4);
+
+  bool status = true;
   if (needRescanDependInfo || needRescanDirInfo || needRescanDependencies) {
     // The dependencies must be regenerated.
-    std::string targetName = cmSystemTools::GetFilenameName(targetDir);
-    targetName = targetName.substr(0, targetName.length() - 4);
     std::string message =
       cmStrCat("Scanning dependencies of target ", targetName);
     cmSystemTools::MakefileColorEcho(cmsysTerminal_Color_ForegroundMagenta |
                                        cmsysTerminal_Color_ForegroundBold,
                                      message.c_str(), true, color);
 
-    return this->ScanDependencies(targetDir, dependFile, internalDependFile,
-                                  validDependencies);
+    status = this->ScanDependencies(targetDir, dependFile, internalDependFile,
+                                    validDependencies);
   }
 
-  // The dependencies are already up-to-date.
-  return true;
+#ifndef CMAKE_BOOTSTRAP
+  // Merge the dependencies the compiler wrote while building the objects
+  // whose languages are not scanned above.
+  if (const char* depFiles =
+        this->Makefile->GetDefinition("CMAKE_DEPENDS_DEPENDENCY_FILES")) {
+    cmDependsCompiler depsTracker(this, targetDir);
+    depsTracker.SetVerbose(verbose);
+    depsTracker.SetFileTimeCache(ftc);
+    bool changed = false;
+    if (!depsTracker.Update(cmExpandedList(depFiles), changed)) {
+      status = false;
+    }
+    if (changed) {
+      std::string message = cmStrCat(
+        "Consolidating compiler generated dependencies of target ",
+        targetName);
+      cmSystemTools::MakefileColorEcho(cmsysTerminal_Color_ForegroundMagenta |
+                                         cmsysTerminal_Color_ForegroundBold,
+                                       message.c_str(), true, color);
+    }
+  }
+#endif
+
+  return status;
 }
 
 bool cmLocalUnixMakefileGenerator3::ScanDependencies(
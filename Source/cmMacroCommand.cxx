@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmMacroCommand.h"
 
+#include <cstddef>
 #include <cstdio>
 #include <utility>
 
@@ -22,6 +23,150 @@
 
 namespace {
 
+// A macro body argument split into literal text and references to the
+// macro arguments.  Substituting the references in one pass gives the
+// same result as the textual replacement done by older versions as
+// long as no substituted value contains '$', '{' or '}'.
+struct cmMacroArgumentSegment
+{
+  enum SegmentKind
+  {
+    Literal,
+    Formal,
+    Argc,
+    Argn,
+    Argv,
+    ArgvN
+  };
+
+  SegmentKind Kind;
+  std::string Text;
+  std::size_t Index;
+};
+
+struct cmMacroCompiledArgument
+{
+  bool Compiled = false;
+  std::vector<cmMacroArgumentSegment> Segments;
+};
+
+struct cmMacroCompiledFunction
+{
+  bool HasReferences = false;
+  std::vector<cmMacroCompiledArgument> Arguments;
+};
+
+bool HasSubstitutionSyntax(std::string const& s)
+{
+  return s.find_first_of("${}") != std::string::npos;
+}
+
+// Parse the index of a ${ARGV<n>} reference as the textual replacement
+// would match it: decimal digits without leading zeros.
+bool ParseArgvIndex(cm::string_view name, std::size_t& index)
+{
+  if (name.size() <= 4 || name.substr(0, 4) != "ARGV"_s ||
+      (name[4] == '0' && name.size() > 5) || name.size() > 12) {
+    return false;
+  }
+  index = 0;
+  for (char c : name.substr(4)) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    index = index * 10 + static_cast<std::size_t>(c - '0');
+  }
+  return true;
+}
+
+void AppendLiteral(cmMacroCompiledArgument& arg, cm::string_view text)
+{
+  if (text.empty()) {
+    return;
+  }
+  if (!arg.Segments.empty() &&
+      arg.Segments.back().Kind == cmMacroArgumentSegment::Literal) {
+    arg.Segments.back().Text.append(text.data(), text.size());
+    return;
+  }
+  arg.Segments.push_back(
+    { cmMacroArgumentSegment::Literal, std::string(text), 0 });
+}
+
+cmMacroCompiledArgument CompileArgument(std::string const& value,
+                                        std::vector<std::string> const& args)
+{
+  cmMacroCompiledArgument arg;
+  std::string::size_type pos = 0;
+  while (pos < value.size()) {
+    std::string::size_type const start = value.find("${", pos);
+    if (start == std::string::npos) {
+      break;
+    }
+    std::string::size_type const end = value.find('}', start + 2);
+    if (end == std::string::npos) {
+      // An unterminated reference cannot match anything.
+      break;
+    }
+    cm::string_view const name(value.data() + start + 2, end - start - 2);
+    if (name.find_first_of("${") != cm::string_view::npos) {
+      // Nested references may be formed by earlier replacements.
+      return cmMacroCompiledArgument();
+    }
+    AppendLiteral(arg, cm::string_view(value.data() + pos, start - pos));
+    cmMacroArgumentSegment ref{ cmMacroArgumentSegment::Literal, {}, 0 };
+    for (std::size_t j = 1; j < args.size(); ++j) {
+      if (name == args[j]) {
+        ref.Kind = cmMacroArgumentSegment::Formal;
+        ref.Index = j - 1;
+        break;
+      }
+    }
+    if (ref.Kind == cmMacroArgumentSegment::Literal) {
+      if (name == "ARGC"_s) {
+        ref.Kind = cmMacroArgumentSegment::Argc;
+      } else if (name == "ARGN"_s) {
+        ref.Kind = cmMacroArgumentSegment::Argn;
+      } else if (name == "ARGV"_s) {
+        ref.Kind = cmMacroArgumentSegment::Argv;
+      } else if (ParseArgvIndex(name, ref.Index)) {
+        ref.Kind = cmMacroArgumentSegment::ArgvN;
+      }
+    }
+    if (ref.Kind == cmMacroArgumentSegment::Literal) {
+      AppendLiteral(arg, cm::string_view(value.data() + start,
+                                         end + 1 - start));
+    } else {
+      // Keep the reference text for ${ARGV<n>} beyond ${ARGC}.
+      ref.Text = value.substr(start, end + 1 - start);
+      arg.Segments.push_back(std::move(ref));
+    }
+    pos = end + 1;
+  }
+  AppendLiteral(arg, cm::string_view(value.data() + pos, value.size() - pos));
+
+  // Empty values could join a '$' before a run of references with a
+  // '{' after it into a new reference.
+  for (std::size_t i = 1; i < arg.Segments.size(); ++i) {
+    cmMacroArgumentSegment const& before = arg.Segments[i - 1];
+    if (before.Kind != cmMacroArgumentSegment::Literal ||
+        before.Text.back() != '$') {
+      continue;
+    }
+    std::size_t after = i;
+    while (after < arg.Segments.size() &&
+           arg.Segments[after].Kind != cmMacroArgumentSegment::Literal) {
+      ++after;
+    }
+    if (after < arg.Segments.size() &&
+        arg.Segments[after].Text.front() == '{') {
+      return cmMacroCompiledArgument();
+    }
+  }
+  arg.Compiled = true;
+  return arg;
+}
+
 // define the class for macro commands
 class cmMacroHelperCommand
 {
@@ -33,12 +178,51 @@ public:
   bool operator()(std::vector<cmListFileArgument> const& args,
                   cmExecutionStatus& inStatus) const;
 
+  /**
+   * Split the body arguments into literal text and argument references.
+   */
+  void Compile();
+
   std::vector<std::string> Args;
   std::vector<cmListFileFunction> Functions;
+  std::vector<cmMacroCompiledFunction> CompiledFunctions;
+  bool Compiled = false;
   cmPolicies::PolicyMap Policies;
   std::string FilePath;
 };
 
+void cmMacroHelperCommand::Compile()
+{
+  this->Compiled = true;
+  for (std::size_t j = 1; j < this->Args.size(); ++j) {
+    if (HasSubstitutionSyntax(this->Args[j])) {
+      this->Compiled = false;
+    }
+  }
+  this->CompiledFunctions.clear();
+  this->CompiledFunctions.reserve(this->Functions.size());
+  for (cmListFileFunction const& func : this->Functions) {
+    cmMacroCompiledFunction compiled;
+    for (cmListFileArgument const& k : func.Arguments) {
+      if (k.Delim != cmListFileArgument::Bracket &&
+          k.Value.find("${") != std::string::npos) {
+        compiled.HasReferences = true;
+      }
+    }
+    if (compiled.HasReferences && this->Compiled) {
+      compiled.Arguments.reserve(func.Arguments.size());
+      for (cmListFileArgument const& k : func.Arguments) {
+        if (k.Delim != cmListFileArgument::Bracket) {
+          compiled.Arguments.push_back(CompileArgument(k.Value, this->Args));
+        } else {
+          compiled.Arguments.emplace_back();
+        }
+      }
+    }
+    this->CompiledFunctions.push_back(std::move(compiled));
+  }
+}
+
 bool cmMacroHelperCommand::operator()(
   std::vector<cmListFileArgument> const& args,
   cmExecutionStatus& inStatus) const
@@ -68,58 +252,115 @@ bool cmMacroHelperCommand::operator()(
   auto eit = expandedArgs.begin() + (this->Args.size() - 1);
   std::string expandedArgn = cmJoin(cmMakeRange(eit, expandedArgs.end()), ";");
   std::string expandedArgv = cmJoin(expandedArgs, ";");
-  std::vector<std::string> variables;
-  variables.reserve(this->Args.size() - 1);
-  for (unsigned int j = 1; j < this->Args.size(); ++j) {
-    variables.push_back("${" + this->Args[j] + "}");
+
+  // Values that look like references could be replaced again by the
+  // textual replacement, so use it to get the same result.
+  bool useCompiled = this->Compiled;
+  for (std::string const& a : expandedArgs) {
+    if (useCompiled && HasSubstitutionSyntax(a)) {
+      useCompiled = false;
+    }
   }
+
+  std::vector<std::string> variables;
   std::vector<std::string> argVs;
-  argVs.reserve(expandedArgs.size());
-  char argvName[60];
-  for (unsigned int j = 0; j < expandedArgs.size(); ++j) {
-    sprintf(argvName, "${ARGV%u}", j);
-    argVs.emplace_back(argvName);
-  }
+  auto prepareReplacements = [&]() {
+    if (!variables.empty() || !argVs.empty()) {
+      return;
+    }
+    variables.reserve(this->Args.size() - 1);
+    for (unsigned int j = 1; j < this->Args.size(); ++j) {
+      variables.push_back("${" + this->Args[j] + "}");
+    }
+    argVs.reserve(expandedArgs.size());
+    char argvName[60];
+    for (unsigned int j = 0; j < expandedArgs.size(); ++j) {
+      sprintf(argvName, "${ARGV%u}", j);
+      argVs.emplace_back(argvName);
+    }
+  };
+
   // Invoke all the functions that were collected in the block.
   cmListFileFunction newLFF;
   // for each function
-  for (cmListFileFunction const& func : this->Functions) {
-    // Replace the formal arguments and then invoke the command.
-    newLFF.Arguments.clear();
-    newLFF.Arguments.reserve(func.Arguments.size());
-    newLFF.Name = func.Name;
-    newLFF.Line = func.Line;
+  for (std::size_t fi = 0; fi < this->Functions.size(); ++fi) {
+    cmListFileFunction const& func = this->Functions[fi];
+    cmMacroCompiledFunction const& compiled = this->CompiledFunctions[fi];
+    cmListFileFunction const* lff = &func;
+    if (compiled.HasReferences) {
+      // Replace the formal arguments and then invoke the command.
+      newLFF.Arguments.clear();
+      newLFF.Arguments.reserve(func.Arguments.size());
+      newLFF.Name = func.Name;
+      newLFF.Line = func.Line;
 
-    // for each argument of the current function
-    for (cmListFileArgument const& k : func.Arguments) {
-      cmListFileArgument arg;
-      arg.Value = k.Value;
-      if (k.Delim != cmListFileArgument::Bracket) {
-        // replace formal arguments
-        for (unsigned int j = 0; j < variables.size(); ++j) {
-          cmSystemTools::ReplaceString(arg.Value, variables[j],
-                                       expandedArgs[j]);
-        }
-        // replace argc
-        cmSystemTools::ReplaceString(arg.Value, "${ARGC}", argcDef);
+      // for each argument of the current function
+      for (std::size_t ki = 0; ki < func.Arguments.size(); ++ki) {
+        cmListFileArgument const& k = func.Arguments[ki];
+        cmListFileArgument arg;
+        if (k.Delim == cmListFileArgument::Bracket) {
+          arg.Value = k.Value;
+        } else if (useCompiled && compiled.Arguments[ki].Compiled) {
+          for (cmMacroArgumentSegment const& s :
+               compiled.Arguments[ki].Segments) {
+            switch (s.Kind) {
+              case cmMacroArgumentSegment::Literal:
+                arg.Value += s.Text;
+                break;
+              case cmMacroArgumentSegment::Formal:
+                arg.Value += expandedArgs[s.Index];
+                break;
+              case cmMacroArgumentSegment::Argc:
+                arg.Value += argcDef;
+                break;
+              case cmMacroArgumentSegment::Argn:
+                arg.Value += expandedArgn;
+                break;
+              case cmMacroArgumentSegment::Argv:
+                arg.Value += expandedArgv;
+                break;
+              case cmMacroArgumentSegment::ArgvN:
+                arg.Value += s.Index < expandedArgs.size()
+                  ? expandedArgs[s.Index]
+                  : s.Text;
+                break;
+            }
+          }
+        } else {
+          prepareReplacements();
+          arg.Value = k.Value;
+          // replace formal arguments
+          for (unsigned int j = 0; j < variables.size(); ++j) {
+            cmSystemTools::ReplaceString(arg.Value, variables[j],
+                                         expandedArgs[j]);
+          }
+          // replace argc
+          cmSystemTools::ReplaceString(arg.Value, "${ARGC}", argcDef);
 
-        cmSystemTools::ReplaceString(arg.Value, "${ARGN}", expandedArgn);
-        cmSystemTools::ReplaceString(arg.Value, "${ARGV}", expandedArgv);
+          cmSystemTools::ReplaceString(arg.Value, "${ARGN}", expandedArgn);
+          cmSystemTools::ReplaceString(arg.Value, "${ARGV}", expandedArgv);
 
-        // if the current argument of the current function has ${ARGV in it
-        // then try replacing ARGV values
-        if (arg.Value.find("${ARGV") != std::string::npos) {
-          for (unsigned int t = 0; t < expandedArgs.size(); ++t) {
-            cmSystemTools::ReplaceString(arg.Value, argVs[t], expandedArgs[t]);
+          // if the current argument of the current function has ${ARGV in it
+          // then try replacing ARGV values
+          if (arg.Value.find("${ARGV") != std::string::npos) {
+            for (unsigned int t = 0; t < expandedArgs.size(); ++t) {
+              cmSystemTools::ReplaceString(arg.Value, argVs[t],
+                                           expandedArgs[t]);
+            }
           }
         }
+        arg.Delim = k.Delim;
+        arg.Line = k.Line;
+        newLFF.Arguments.push_back(std::move(arg));
       }
-      arg.Delim = k.Delim;
-      arg.Line = k.Line;
-      newLFF.Arguments.push_back(std::move(arg));
+      lff = &newLFF;
     }
+    // The substituted copy does not cache the command binding, so use
+    // the one cached by the recorded call.
     cmExecutionStatus status(makefile);
-    if (!makefile.ExecuteCommand(newLFF, status) || status.GetNestedError()) {
+    if (!makefile.ExecuteCommand(
+          *lff, status, makefile.GetState()->GetCommandBinding(func)) ||
+        status.GetNestedError()) {
       // The error message should have already included the call stack
       // so we do not need to report an error here.
       macroScope.Quiet();
@@ -172,6 +413,7 @@ bool cmMacroFunctionBlocker::Replay(std::vector<cmListFileFunction> functions,
   f.Args = this->Args;
   f.Functions = std::move(functions);
   f.FilePath = this->GetStartingContext().FilePath;
+  f.Compile();
   mf.RecordPolicies(f.Policies);
   mf.GetState()->AddScriptedCommand(this->Args[0], std::move(f));
   return true;
@@ -96,7 +96,6 @@ cmMakefile::cmMakefile(cmGlobalGenerator* globalGenerator,
 
   this->cmDefineRegex.compile("#([ \t]*)cmakedefine[ \t]+([A-Za-z_0-9]*)");
   this->cmDefine01Regex.compile("#([ \t]*)cmakedefine01[ \t]+([A-Za-z_0-9]*)");
-  this->cmAtVarRegex.compile("(@[A-Za-z_0-9/.+-]+@)");
   this->cmNamedCurly.compile("^[A-Za-z0-9/_.+-]+{");
 
   this->StateSnapshot =
@@ -419,7 +418,8 @@ void cmMakefile::OnExecuteCommand(std::function<void()> callback)
 }
 
 bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
-                                cmExecutionStatus& status)
+                                cmExecutionStatus& status,
+                                cmCommandBinding const* binding)
 {
   bool result = true;
 
@@ -456,8 +456,10 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
   }
 
   // Lookup the command prototype.
-  if (cmState::Command command =
-        this->GetState()->GetCommandByExactName(lff.Name.Lower)) {
+  if (!binding) {
+    binding = this->GetState()->GetCommandBinding(lff);
+  }
+  if (std::shared_ptr<cmState::Command const> command = binding->Get()) {
     // Decide whether to invoke the command.
     if (!cmSystemTools::GetFatalErrorOccured()) {
       // if trace is enabled, print out invoke information
@@ -465,7 +467,7 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
         this->PrintCommandTrace(lff);
       }
       // Try invoking the command.
-      bool invokeSucceeded = command(lff.Arguments, status);
+      bool invokeSucceeded = (*command)(lff.Arguments, status);
       bool hadNestedError = status.GetNestedError();
       if (!invokeSucceeded || hadNestedError) {
         if (!hadNestedError) {
@@ -635,7 +637,8 @@ bool cmMakefile::ReadDependentFile(const std::string& filename,
 
   cmListFile listFile;
   if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetState()->GetListFileCache().get())) {
     return false;
   }
 
@@ -689,7 +692,8 @@ bool cmMakefile::ReadListFile(const std::string& filename)
 
   cmListFile listFile;
   if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetState()->GetListFileCache().get())) {
     return false;
   }
 
@@ -1613,7 +1617,8 @@ void cmMakefile::Configure()
 
   cmListFile listFile;
   if (!listFile.ParseFile(currentStart.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetState()->GetListFileCache().get())) {
     return;
   }
   if (this->IsRootMakefile()) {
@@ -2843,6 +2848,23 @@ const std::string& cmMakefile::ExpandVariablesInString(
   return source;
 }
 
+static void AppendEscapedQuotes(std::string& out, std::string const& value)
+{
+  for (char const ch : value) {
+    if (ch == '"') {
+      out += '\\';
+    }
+    out += ch;
+  }
+}
+
+static bool IsAtVarChar(char c)
+{
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+    (c >= '0' && c <= '9') || c == '/' || c == '_' || c == '.' || c == '+' ||
+    c == '-';
+}
+
 MessageType cmMakefile::ExpandVariablesInStringOld(
   std::string& errorstr, std::string& source, bool escapeQuotes,
   bool noEscapes, bool atOnly, const char* filename, long line,
@@ -2863,16 +2885,24 @@ MessageType cmMakefile::ExpandVariablesInStringOld(
 
     // Look for one @VAR@ at a time.
     const char* in = input.c_str();
-    while (this->cmAtVarRegex.find(in)) {
-      // Get the range of the string to replace.
-      const char* first = in + this->cmAtVarRegex.start();
-      const char* last = in + this->cmAtVarRegex.end();
+    std::string var;
+    for (const char* first = strchr(in, '@'); first;
+         first = strchr(first, '@')) {
+      const char* last = first + 1;
+      while (IsAtVarChar(*last)) {
+        ++last;
+      }
+      if (last == first + 1 || *last != '@') {
+        // Not a reference.  The closing '@' may open the next one.
+        first = last;
+        continue;
+      }
 
       // Store the unchanged part of the string now.
       source.append(in, first - in);
 
       // Lookup the definition of VAR.
-      std::string var(first + 1, last - first - 2);
+      var.assign(first + 1, last - first - 1);
       if (const char* val = this->GetDefinition(var)) {
         // Store the value in the output escaping as requested.
         if (escapeQuotes) {
@@ -2883,7 +2913,7 @@ MessageType cmMakefile::ExpandVariablesInStringOld(
       }
 
       // Continue looking for @VAR@ further along the string.
-      in = last;
+      in = first = last + 1;
     }
 
     // Append the rest of the unchanged part of the string.
@@ -2904,7 +2934,17 @@ MessageType cmMakefile::ExpandVariablesInStringOld(
   parser.SetNoEscapeMode(noEscapes);
   parser.SetReplaceAtSyntax(replaceAt);
   parser.SetRemoveEmpty(removeEmpty);
+  if (parser.ExpandString(source.c_str())) {
+    source = std::move(parser.GetResult());
+    return MessageType::LOG;
+  }
+
+  // The string has an error.  Parse it again to describe the error, but
+  // do not repeat the side effects of the references already expanded.
+  this->SuppressSideEffects = true;
+  parser.SetWarnUninitialized(false);
   int res = parser.ParseString(source.c_str(), 0);
+  this->SuppressSideEffects = false;
   const char* emsg = parser.GetError();
   MessageType mtype = MessageType::LOG;
   if (res && !emsg[0]) {
@@ -2995,11 +3035,19 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
   // It also supports the $ENV{VAR} syntax where VAR is looked up in
   // the current environment variables.
 
+  // Fast path strings without any special characters.
+  if (source.find_first_of("$@\\") == std::string::npos) {
+    return MessageType::LOG;
+  }
+
   const char* in = source.c_str();
   const char* last = in;
   std::string result;
   result.reserve(source.size());
   std::vector<t_lookup> openstack;
+  // Reused for every reference to avoid allocating per lookup.
+  std::string varName;
+  std::string svalue;
   bool error = false;
   bool done = false;
   MessageType mtype = MessageType::LOG;
@@ -3015,38 +3063,36 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
           t_lookup var = openstack.back();
           openstack.pop_back();
           result.append(last, in - last);
-          std::string const& lookup = result.substr(var.loc);
+          varName.assign(result, var.loc, std::string::npos);
+          result.erase(var.loc);
           cmProp value = nullptr;
-          std::string varresult;
-          std::string svalue;
           switch (var.domain) {
             case NORMAL:
-              if (filename && lookup == lineVar) {
-                varresult = std::to_string(line);
+              if (filename && varName == lineVar) {
+                result += std::to_string(line);
               } else {
-                value = this->GetDef(lookup);
+                value = this->GetDef(varName);
               }
               break;
             case ENVIRONMENT:
-              if (cmSystemTools::GetEnv(lookup, svalue)) {
+              if (cmSystemTools::GetEnv(varName, svalue)) {
                 value = &svalue;
               }
               break;
             case CACHE:
-              value = state->GetCacheEntryValue(lookup);
+              value = state->GetCacheEntryValue(varName);
               break;
           }
-          // Get the string we're meant to append to.
+          // Append the value in place of the reference.
           if (value) {
             if (escapeQuotes) {
-              varresult = cmEscapeQuotes(*value);
+              AppendEscapedQuotes(result, *value);
             } else {
-              varresult = *value;
+              result += *value;
             }
           } else if (!this->SuppressSideEffects) {
-            this->MaybeWarnUninitialized(lookup, filename);
+            this->MaybeWarnUninitialized(varName, filename);
           }
-          result.replace(var.loc, result.size() - var.loc, varresult);
           // Start looking from here on out.
           last = in + 1;
         }
@@ -3150,26 +3196,21 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
                          "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
                          "abcdefghijklmnopqrstuvwxyz"
                          "0123456789/_.+-")) {
-            std::string variable(in + 1, nextAt - in - 1);
-
-            std::string varresult;
-            if (filename && variable == lineVar) {
-              varresult = std::to_string(line);
-            } else {
-              const std::string* def = this->GetDef(variable);
-              if (def) {
-                varresult = *def;
-              } else if (!this->SuppressSideEffects) {
-                this->MaybeWarnUninitialized(variable, filename);
-              }
-            }
+            varName.assign(in + 1, nextAt - in - 1);
 
-            if (escapeQuotes) {
-              varresult = cmEscapeQuotes(varresult);
-            }
             // Skip over the variable.
             result.append(last, in - last);
-            result.append(varresult);
+            if (filename && varName == lineVar) {
+              result += std::to_string(line);
+            } else if (const std::string* def = this->GetDef(varName)) {
+              if (escapeQuotes) {
+                AppendEscapedQuotes(result, *def);
+              } else {
+                result += *def;
+              }
+            } else if (!this->SuppressSideEffects) {
+              this->MaybeWarnUninitialized(varName, filename);
+            }
             in = nextAt;
             last = in + 1;
             break;
@@ -3224,7 +3265,7 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
     // Append the rest of the unchanged part of the string.
     result.append(last);
 
-    source = result;
+    source = std::move(result);
   }
 
   return mtype;
@@ -3375,6 +3416,15 @@ bool cmMakefile::ExpandArguments(std::vector<cmListFileArgument> const& inArgs,
       outArgs.push_back(i.Value);
       continue;
     }
+    // Nothing to expand in plain literal text.
+    if (i.Value.find_first_of("$@\\") == std::string::npos) {
+      if (i.Delim == cmListFileArgument::Quoted) {
+        outArgs.push_back(i.Value);
+      } else {
+        cmExpandList(i.Value, outArgs);
+      }
+      continue;
+    }
     // Expand the variables in the argument.
     value = i.Value;
     this->ExpandVariablesInString(value, false, false, false, filename, i.Line,
@@ -3407,6 +3457,17 @@ bool cmMakefile::ExpandArguments(
       outArgs.emplace_back(i.Value, true);
       continue;
     }
+    // Nothing to expand in plain literal text.
+    if (i.Value.find_first_of("$@\\") == std::string::npos) {
+      if (i.Delim == cmListFileArgument::Quoted) {
+        outArgs.emplace_back(i.Value, true);
+      } else {
+        for (std::string const& stringArg : cmExpandedList(i.Value)) {
+          outArgs.emplace_back(stringArg, false);
+        }
+      }
+      continue;
+    }
     // Expand the variables in the argument.
     value = i.Value;
     this->ExpandVariablesInString(value, false, false, false, filename, i.Line,
@@ -3626,9 +3687,10 @@ void cmMakefile::EnableLanguage(std::vector<std::string> const& lang,
 int cmMakefile::TryCompile(const std::string& srcdir,
                            const std::string& bindir,
                            const std::string& projectName,
-                           const std::string& targetName, bool fast, int jobs,
+                           std::vector<std::string> const& targetNames,
+                           bool fast, int jobs,
                            const std::vector<std::string>* cmakeArgs,
-                           std::string& output)
+                           std::string& output, bool keepGoing)
 {
   this->IsSourceFileTryCompile = fast;
   // does the binary directory exist ? If not create it...
@@ -3653,6 +3715,7 @@ int cmMakefile::TryCompile(const std::string& srcdir,
   // be run that way but the cmake object requires a vailid path
   cmake cm(cmake::RoleProject, cmState::Project);
   cm.SetIsInTryCompile(true);
+  cm.GetState()->SetListFileCache(this->GetState()->GetListFileCache());
   auto gg = cm.CreateGlobalGenerator(this->GetGlobalGenerator()->GetName());
   if (!gg) {
     this->IssueMessage(MessageType::INTERNAL_ERROR,
@@ -3746,7 +3809,8 @@ int cmMakefile::TryCompile(const std::string& srcdir,
 
   // finally call the generator to actually build the resulting project
   int ret = this->GetGlobalGenerator()->TryCompile(
-    jobs, srcdir, bindir, projectName, targetName, fast, output, this);
+    jobs, srcdir, bindir, projectName, targetNames, fast, output, this,
+    keepGoing);
 
   this->IsSourceFileTryCompile = false;
   return ret;
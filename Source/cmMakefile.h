@@ -40,6 +40,7 @@
 #  include "cmSourceGroup.h"
 #endif
 
+class cmCommandBinding;
 class cmCompiledGeneratorExpression;
 class cmCustomCommandLines;
 class cmExecutionStatus;
@@ -140,13 +141,15 @@ public:
 
   /**
    * Try running cmake and building a file. This is used for dynamically
-   * loaded commands, not as part of the usual build process.
+   * loaded commands, not as part of the usual build process.  An empty
+   * list of target names builds all targets.  With keepGoing the build
+   * continues past failed targets where the native build tool supports it.
    */
   int TryCompile(const std::string& srcdir, const std::string& bindir,
-                 const std::string& projectName, const std::string& targetName,
-                 bool fast, int jobs,
-                 const std::vector<std::string>* cmakeArgs,
-                 std::string& output);
+                 const std::string& projectName,
+                 std::vector<std::string> const& targetNames, bool fast,
+                 int jobs, const std::vector<std::string>* cmakeArgs,
+                 std::string& output, bool keepGoing = false);
 
   bool GetIsSourceFileTryCompile() const;
 
@@ -708,10 +711,12 @@ public:
 
   /**
    * Execute a single CMake command.  Returns true if the command
-   * succeeded or false if it failed.
+   * succeeded or false if it failed.  A caller executing a copy of a
+   * recorded call may pass the binding cached by the recorded call.
    */
   bool ExecuteCommand(const cmListFileFunction& lff,
-                      cmExecutionStatus& status);
+                      cmExecutionStatus& status,
+                      cmCommandBinding const* binding = nullptr);
 
   //! Enable support for named language, if nil then all languages are
   /// enabled.
@@ -1058,7 +1063,6 @@ private:
 
   mutable cmsys::RegularExpression cmDefineRegex;
   mutable cmsys::RegularExpression cmDefine01Regex;
-  mutable cmsys::RegularExpression cmAtVarRegex;
   mutable cmsys::RegularExpression cmNamedCurly;
 
   std::vector<cmMakefile*> UnConfiguredDirectories;
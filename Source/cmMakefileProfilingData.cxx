@@ -2,8 +2,11 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmMakefileProfilingData.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iomanip>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include <cm3p/json/value.h>
@@ -17,7 +20,8 @@
 #include "cmSystemTools.h"
 
 cmMakefileProfilingData::cmMakefileProfilingData(
-  const std::string& profileStream)
+  const std::string& profileStream, Format format)
+  : OutputFormat(format)
 {
   std::ios::openmode omode = std::ios::out | std::ios::trunc;
   this->ProfileStream.open(profileStream.c_str(), omode);
@@ -28,14 +32,28 @@ cmMakefileProfilingData::cmMakefileProfilingData(
     throw std::runtime_error(std::string("Unable to open: ") + profileStream);
   }
 
-  this->ProfileStream << "[";
+  if (this->OutputFormat == Format::GoogleTrace) {
+    this->ProfileStream << "[";
+  } else {
+    this->CallPaths.emplace_back();
+  }
 };
 
 cmMakefileProfilingData::~cmMakefileProfilingData() noexcept
 {
   if (this->ProfileStream.good()) {
     try {
-      this->ProfileStream << "]";
+      switch (this->OutputFormat) {
+        case Format::GoogleTrace:
+          this->ProfileStream << "]";
+          break;
+        case Format::Folded:
+          this->WriteFolded();
+          break;
+        case Format::Summary:
+          this->WriteSummary();
+          break;
+      }
       this->ProfileStream.close();
     } catch (...) {
       cmSystemTools::Error("Error writing profiling output!");
@@ -45,6 +63,195 @@ cmMakefileProfilingData::~cmMakefileProfilingData() noexcept
 
 void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
                                          cmListFileContext const& lfc)
+{
+  if (this->OutputFormat == Format::GoogleTrace) {
+    this->StartTraceEntry(lff, lfc);
+    return;
+  }
+
+  // Find the node of this call path, adding it on first use.
+  std::string frame =
+    cmStrCat(lff.Name.Lower, " (", lfc.FilePath, ':', lfc.Line, ')');
+  // The folded format separates frames with semicolons.
+  std::replace(frame.begin(), frame.end(), ';', ',');
+  auto const fi =
+    this->FrameIndex.emplace(std::move(frame), this->Frames.size());
+  if (fi.second) {
+    this->Frames.push_back(fi.first->first);
+  }
+  std::size_t const parent =
+    this->Stack.empty() ? 0 : this->Stack.back().Path;
+  auto const ci = this->CallPaths[parent].Children.emplace(
+    fi.first->second, this->CallPaths.size());
+  // Adding a path may move the children maps, so read the iterator now.
+  std::size_t const path = ci.first->second;
+  if (ci.second) {
+    CallPath callPath;
+    callPath.Frame = fi.first->second;
+    callPath.Parent = parent;
+    this->CallPaths.push_back(std::move(callPath));
+  }
+
+  OpenEntry entry;
+  entry.Path = path;
+  entry.Command = &this->CommandTotals[lff.Name.Lower];
+  entry.File = &this->FileTotals[lfc.FilePath];
+  ++entry.Command->Active;
+  ++entry.File->Active;
+  entry.Nested = Clock::duration::zero();
+  entry.Start = Clock::now();
+  this->Stack.push_back(entry);
+}
+
+void cmMakefileProfilingData::StopEntry()
+{
+  if (this->OutputFormat == Format::GoogleTrace) {
+    this->StopTraceEntry();
+    return;
+  }
+  if (this->Stack.empty()) {
+    return;
+  }
+
+  OpenEntry const entry = this->Stack.back();
+  this->Stack.pop_back();
+  Clock::duration const inclusive = Clock::now() - entry.Start;
+  Clock::duration const exclusive = inclusive - entry.Nested;
+  if (!this->Stack.empty()) {
+    this->Stack.back().Nested += inclusive;
+  }
+
+  auto accumulate = [inclusive, exclusive](Totals& totals) {
+    ++totals.Calls;
+    totals.Exclusive += exclusive;
+    if (--totals.Active == 0) {
+      totals.Inclusive += inclusive;
+    }
+  };
+  accumulate(*entry.Command);
+  accumulate(*entry.File);
+
+  // A call path is never on the stack twice.
+  Totals& path = this->CallPaths[entry.Path].Time;
+  ++path.Calls;
+  path.Inclusive += inclusive;
+  path.Exclusive += exclusive;
+}
+
+void cmMakefileProfilingData::AddCounters(std::string const& name,
+                                          Counters const& counters)
+{
+  switch (this->OutputFormat) {
+    case Format::GoogleTrace:
+      break;
+    case Format::Folded:
+      return;
+    case Format::Summary:
+      this->CounterGroups.emplace_back(name, counters);
+      return;
+  }
+
+  /* Do not try again if we previously failed to write to output. */
+  if (!this->ProfileStream.good()) {
+    return;
+  }
+
+  try {
+    if (this->ProfileStream.tellp() > 1) {
+      this->ProfileStream << ",";
+    }
+    cmsys::SystemInformation info;
+    Json::Value v;
+    v["ph"] = "C";
+    v["name"] = name;
+    v["cat"] = "cmake";
+    v["ts"] = Json::Value::UInt64(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count());
+    v["pid"] = static_cast<int>(info.GetProcessId());
+    v["tid"] = 0;
+    Json::Value argsValue(Json::objectValue);
+    for (auto const& counter : counters) {
+      argsValue[counter.first] = Json::Value::UInt64(counter.second);
+    }
+    v["args"] = argsValue;
+
+    this->JsonWriter->write(v, &this->ProfileStream);
+  } catch (std::ios_base::failure& fail) {
+    cmSystemTools::Error(
+      cmStrCat("Failed to write to profiling output: ", fail.what()));
+  } catch (...) {
+    cmSystemTools::Error("Error writing profiling output!");
+  }
+}
+
+void cmMakefileProfilingData::WriteFolded()
+{
+  std::vector<std::size_t> frames;
+  for (std::size_t i = 1; i < this->CallPaths.size(); ++i) {
+    long long const us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           this->CallPaths[i].Time.Exclusive)
+                           .count();
+    frames.clear();
+    for (std::size_t p = i; p != 0; p = this->CallPaths[p].Parent) {
+      frames.push_back(this->CallPaths[p].Frame);
+    }
+    const char* sep = "";
+    for (auto f = frames.rbegin(); f != frames.rend(); ++f) {
+      this->ProfileStream << sep << this->Frames[*f];
+      sep = ";";
+    }
+    this->ProfileStream << ' ' << us << '\n';
+  }
+}
+
+void cmMakefileProfilingData::WriteSummary()
+{
+  auto writeTable = [this](const char* title,
+                           std::map<std::string, Totals> const& totals) {
+    using Row = std::pair<std::string const*, Totals const*>;
+    std::vector<Row> rows;
+    rows.reserve(totals.size());
+    for (auto const& t : totals) {
+      rows.emplace_back(&t.first, &t.second);
+    }
+    std::stable_sort(rows.begin(), rows.end(),
+                     [](Row const& l, Row const& r) {
+                       return l.second->Exclusive > r.second->Exclusive;
+                     });
+
+    auto ms = [](Clock::duration d) {
+      return std::chrono::duration<double, std::milli>(d).count();
+    };
+    std::ostream& os = this->ProfileStream;
+    os << title << "\n\n"
+       << std::setw(12) << "Calls" << std::setw(16) << "Inclusive ms"
+       << std::setw(16) << "Exclusive ms"
+       << "  Name\n";
+    os << std::fixed << std::setprecision(3);
+    for (auto const& row : rows) {
+      os << std::setw(12) << row.second->Calls << std::setw(16)
+         << ms(row.second->Inclusive) << std::setw(16)
+         << ms(row.second->Exclusive) << "  " << *row.first << '\n';
+    }
+    os << '\n';
+  };
+  writeTable("Commands", this->CommandTotals);
+  writeTable("Files", this->FileTotals);
+
+  for (auto const& group : this->CounterGroups) {
+    std::ostream& os = this->ProfileStream;
+    os << group.first << "\n\n";
+    for (auto const& counter : group.second) {
+      os << std::setw(12) << counter.second << "  " << counter.first << '\n';
+    }
+    os << '\n';
+  }
+}
+
+void cmMakefileProfilingData::StartTraceEntry(const cmListFileFunction& lff,
+                                              cmListFileContext const& lfc)
 {
   /* Do not try again if we previously failed to write to output. */
   if (!this->ProfileStream.good()) {
@@ -86,7 +293,7 @@ void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
   }
 }
 
-void cmMakefileProfilingData::StopEntry()
+void cmMakefileProfilingData::StopTraceEntry()
 {
   /* Do not try again if we previously failed to write to output. */
   if (!this->ProfileStream.good()) {
@@ -2,8 +2,14 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #ifndef cmMakefileProfilingData_h
 #define cmMakefileProfilingData_h
+#include <chrono>
+#include <cstddef>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "cmsys/FStream.hxx"
 
@@ -17,13 +23,73 @@ struct cmListFileFunction;
 class cmMakefileProfilingData
 {
 public:
-  cmMakefileProfilingData(const std::string&);
+  enum class Format
+  {
+    // One event object per command invocation, written as it happens.
+    GoogleTrace,
+    // Collapsed stacks with the exclusive time of each call path.
+    Folded,
+    // Tables of time per command and per list file.
+    Summary
+  };
+
+  cmMakefileProfilingData(const std::string&,
+                          Format format = Format::GoogleTrace);
   ~cmMakefileProfilingData() noexcept;
   void StartEntry(const cmListFileFunction& lff, cmListFileContext const& lfc);
   void StopEntry();
 
+  using Counters = std::vector<std::pair<std::string, unsigned long long>>;
+  /** Record named statistics gathered outside of list file commands.
+      The folded format has no place for them and leaves them out.  */
+  void AddCounters(std::string const& name, Counters const& counters);
+
 private:
+  using Clock = std::chrono::steady_clock;
+
+  void StartTraceEntry(const cmListFileFunction& lff,
+                       cmListFileContext const& lfc);
+  void StopTraceEntry();
+  void WriteFolded();
+  void WriteSummary();
+
+  Format OutputFormat;
   cmsys::ofstream ProfileStream;
   std::unique_ptr<Json::StreamWriter> JsonWriter;
+
+  // The aggregated formats accumulate the time of every call in memory
+  // and write the result once, when profiling ends.
+  struct Totals
+  {
+    unsigned long long Calls = 0;
+    Clock::duration Inclusive{};
+    Clock::duration Exclusive{};
+    // Invocations currently on the stack, so that recursion does not
+    // count inclusive time more than once.
+    unsigned int Active = 0;
+  };
+  // A node of the tree of call paths.  Node 0 is the root.
+  struct CallPath
+  {
+    std::size_t Frame = 0;
+    std::size_t Parent = 0;
+    std::unordered_map<std::size_t, std::size_t> Children;
+    Totals Time;
+  };
+  struct OpenEntry
+  {
+    std::size_t Path;
+    Totals* Command;
+    Totals* File;
+    Clock::time_point Start;
+    Clock::duration Nested;
+  };
+  std::vector<std::string> Frames;
+  std::unordered_map<std::string, std::size_t> FrameIndex;
+  std::vector<CallPath> CallPaths;
+  std::vector<OpenEntry> Stack;
+  std::map<std::string, Totals> CommandTotals;
+  std::map<std::string, Totals> FileTotals;
+  std::vector<std::pair<std::string, Counters>> CounterGroups;
 };
 #endif
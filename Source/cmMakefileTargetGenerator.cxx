@@ -121,6 +121,18 @@ void cmMakefileTargetGenerator::GetTargetLinkFlags(
     flags, this->GeneratorTarget, this->GetConfigName(), linkLanguage);
 }
 
+void cmMakefileTargetGenerator::ReuseRuleFiles(
+  unsigned long numberOfProgressActions)
+{
+  this->TargetBuildDirectory =
+    this->LocalGenerator->GetTargetDirectory(this->GeneratorTarget);
+  this->TargetBuildDirectoryFull =
+    this->LocalGenerator->ConvertToFullPath(this->TargetBuildDirectory);
+  this->ProgressFileNameFull =
+    cmStrCat(this->TargetBuildDirectoryFull, "/progress.make");
+  this->NumberOfProgressActions = numberOfProgressActions;
+}
+
 void cmMakefileTargetGenerator::CreateRuleFile()
 {
   // Create a directory for this target.
@@ -315,6 +327,32 @@ void cmMakefileTargetGenerator::WriteCommonCodeRules()
                   << "# This may be replaced when dependencies are built.\n";
   }
 
+  if (this->Makefile->IsOn("CMAKE_DEPENDS_USE_COMPILER")) {
+    // Include the dependencies written by the compiler.
+    std::string compilerDependFileNameFull =
+      cmStrCat(this->TargetBuildDirectoryFull, "/compiler_depend.make");
+    *this->BuildFileStream
+      << "# Include any dependencies generated by the compiler for this "
+         "target.\n"
+      << this->GlobalGenerator->IncludeDirective << " " << root
+      << cmSystemTools::ConvertToOutputPath(
+           this->LocalGenerator->MaybeConvertToRelativePath(
+             this->LocalGenerator->GetBinaryDirectory(),
+             compilerDependFileNameFull))
+      << "\n\n";
+
+    if (!cmSystemTools::FileExists(compilerDependFileNameFull)) {
+      // Write an empty dependency file.
+      cmGeneratedFileStream depFileStream(
+        compilerDependFileNameFull, false,
+        this->GlobalGenerator->GetMakefileEncoding());
+      depFileStream
+        << "# Empty compiler generated dependencies file for "
+        << this->GeneratorTarget->GetName() << ".\n"
+        << "# This may be replaced when dependencies are built.\n";
+    }
+  }
+
   // Open the flags file.  This should be copy-if-different because the
   // rules may depend on this file itself.
   this->FlagFileNameFull =
@@ -476,8 +514,18 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
   objFullPath = cmSystemTools::CollapseFullPath(objFullPath);
   std::string srcFullPath =
     cmSystemTools::CollapseFullPath(source.GetFullPath());
-  this->LocalGenerator->AddImplicitDepends(this->GeneratorTarget, lang,
-                                           objFullPath, srcFullPath);
+  bool const compilerDepends = this->UseCompilerDepends(lang);
+  std::string depFileFullPath;
+  if (compilerDepends) {
+    // The compiler writes the dependencies next to the object file.
+    depFileFullPath = cmStrCat(objFullPath, ".d");
+    this->CompilerDependFiles.push_back(objFullPath);
+    this->CompilerDependFiles.push_back(depFileFullPath);
+    this->CleanFiles.insert(cmStrCat(obj, ".d"));
+  } else {
+    this->LocalGenerator->AddImplicitDepends(this->GeneratorTarget, lang,
+                                             objFullPath, srcFullPath);
+  }
 
   this->LocalGenerator->AppendRuleDepend(depends,
                                          this->FlagFileNameFull.c_str());
@@ -519,8 +567,10 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
         depends.push_back(
           this->GeneratorTarget->GetPchFile(config, lang, arch));
       }
-      this->LocalGenerator->AddImplicitDepends(this->GeneratorTarget, lang,
-                                               objFullPath, pchHeader);
+      if (!compilerDepends) {
+        this->LocalGenerator->AddImplicitDepends(this->GeneratorTarget, lang,
+                                                 objFullPath, pchHeader);
+      }
     }
   }
 
@@ -886,12 +936,30 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
       }
     }
 
+    // Ask the compiler to write the dependencies of the object.
+    std::string compileFlags = flags;
+    if (compilerDepends) {
+      std::string depfileFlags = this->Makefile->GetSafeDefinition(
+        cmStrCat("CMAKE_DEPFILE_FLAGS_", lang));
+      cmSystemTools::ReplaceString(
+        depfileFlags, "<DEPFILE>",
+        this->LocalGenerator->ConvertToOutputFormat(
+          cmStrCat(obj, ".d"), cmOutputConverter::SHELL));
+      cmSystemTools::ReplaceString(depfileFlags, "<OBJECT>", shellObj);
+      cmSystemTools::ReplaceString(
+        depfileFlags, "<CMAKE_C_COMPILER>",
+        this->Makefile->GetSafeDefinition("CMAKE_C_COMPILER"));
+      compileFlags += cmStrCat(' ', depfileFlags);
+    }
+    vars.Flags = compileFlags.c_str();
+
     // Expand placeholders in the commands.
     for (std::string& compileCommand : compileCommands) {
       compileCommand = cmStrCat(launcher, compileCommand);
       rulePlaceholderExpander->ExpandRuleVariables(this->LocalGenerator,
                                                    compileCommand, vars);
     }
+    vars.Flags = flags.c_str();
 
     // Change the command working directory to the local build tree.
     this->LocalGenerator->CreateCDCommand(
@@ -1140,6 +1208,24 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
     *this->InfoFileStream << "  )\n\n";
   }
 
+  // Store the dependency files written by the compiler.
+  if (!this->CompilerDependFiles.empty()) {
+    /* clang-format off */
+    *this->InfoFileStream
+      << "\n"
+      << "# Pairs of object file and dependency file written by the "
+         "compiler.\n"
+      << "set(CMAKE_DEPENDS_DEPENDENCY_FILES\n";
+    /* clang-format on */
+    for (auto pi = this->CompilerDependFiles.begin();
+         pi != this->CompilerDependFiles.end(); pi += 2) {
+      *this->InfoFileStream
+        << "  " << cmOutputConverter::EscapeForCMake(*pi) << " "
+        << cmOutputConverter::EscapeForCMake(*(pi + 1)) << "\n";
+    }
+    *this->InfoFileStream << "  )\n";
+  }
+
   // Store list of targets linked directly or transitively.
   {
     /* clang-format off */
@@ -1265,6 +1351,28 @@ void cmMakefileTargetGenerator::WriteObjectDependRules(
   }
 }
 
+bool cmMakefileTargetGenerator::UseCompilerDepends(
+  std::string const& lang) const
+{
+  if (!this->Makefile->IsOn("CMAKE_DEPENDS_USE_COMPILER")) {
+    return false;
+  }
+  if (lang != "C" && lang != "CXX" && lang != "OBJC" && lang != "OBJCXX" &&
+      lang != "CUDA") {
+    return false;
+  }
+  // Compilers reporting their dependencies on the output, such as MSVC
+  // with /showIncludes, are left to the depend scanners.
+  std::string const& deptype = this->Makefile->GetSafeDefinition(
+    cmStrCat("CMAKE_NINJA_DEPTYPE_", lang));
+  if (deptype == "msvc" || deptype == "intel") {
+    return false;
+  }
+  return !this->Makefile
+            ->GetSafeDefinition(cmStrCat("CMAKE_DEPFILE_FLAGS_", lang))
+            .empty();
+}
+
 void cmMakefileTargetGenerator::GenerateCustomRuleFile(
   cmCustomCommandGenerator const& ccg)
 {
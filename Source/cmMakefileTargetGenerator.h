@@ -48,6 +48,10 @@ public:
      with this target */
   virtual void WriteRuleFiles() = 0;
 
+  /* use the Makefiles written for this target by a previous run, which
+     had the given number of actions with progress reporting */
+  void ReuseRuleFiles(unsigned long numberOfProgressActions);
+
   /* return the number of actions that have progress reporting on them */
   virtual unsigned long GetNumberOfProgressActions()
   {
@@ -105,6 +109,10 @@ protected:
   void WriteObjectDependRules(cmSourceFile const& source,
                               std::vector<std::string>& depends);
 
+  // whether the compiler writes the dependencies of the objects of a
+  // language instead of the depend scanners
+  bool UseCompilerDepends(std::string const& lang) const;
+
   // write the build rule for a custom command
   void GenerateCustomRuleFile(cmCustomCommandGenerator const& ccg);
 
@@ -223,6 +231,9 @@ protected:
   std::vector<std::string> Objects;
   std::vector<std::string> ExternalObjects;
 
+  // pairs of object file and the depfile the compiler writes for it
+  std::vector<std::string> CompilerDependFiles;
+
   // Set of object file names that will be built in this directory.
   std::set<std::string> ObjectFiles;
 
@@ -0,0 +1,181 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmMemoryProfilingData.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cmDefinitions.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmMemoryUsage.h"
+#include "cmPropertyMap.h"
+#include "cmSourceFile.h"
+#include "cmStateDirectory.h"
+#include "cmStateSnapshot.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmTarget.h"
+
+namespace {
+struct TargetRow
+{
+  std::string const* Name;
+  std::string const* Directory;
+  std::size_t Properties;
+  std::size_t Target;
+  std::size_t GeneratorTarget;
+};
+
+struct PropertyMapRow
+{
+  const char* Owner;
+  std::size_t Count = 0;
+  std::size_t Bytes = 0;
+
+  void Add(cmPropertyMap const& map)
+  {
+    ++this->Count;
+    this->Bytes += map.GetAllocatedBytes();
+  }
+};
+}
+
+cmMemoryProfilingData::cmMemoryProfilingData(const std::string& profileStream)
+{
+  std::ios::openmode omode = std::ios::out | std::ios::trunc;
+  this->ProfileStream.open(profileStream.c_str(), omode);
+  if (!this->ProfileStream.good()) {
+    throw std::runtime_error(std::string("Unable to open: ") + profileStream);
+  }
+}
+
+void cmMemoryProfilingData::Report(std::string const& step,
+                                   cmGlobalGenerator const& gg)
+{
+  /* Do not try again if we previously failed to write to output. */
+  if (!this->ProfileStream.good()) {
+    return;
+  }
+
+  std::unordered_map<cmTarget const*, std::size_t> generatorTargets;
+  for (auto const& lg : gg.GetLocalGenerators()) {
+    for (auto const& gt : lg->GetGeneratorTargets()) {
+      generatorTargets[gt->Target] =
+        sizeof(cmGeneratorTarget) + gt->GetAllocatedBytes();
+    }
+  }
+
+  // Variable scopes share structure with the scopes they were made from.
+  // Count each shared node once, for the first directory reaching it.
+  std::unordered_set<void const*> counted;
+  std::vector<TargetRow> targets;
+  PropertyMapRow directoryProperties{ "directories" };
+  PropertyMapRow targetProperties{ "targets" };
+  PropertyMapRow sourceProperties{ "source files" };
+  std::size_t total = 0;
+
+  std::ostream& os = this->ProfileStream;
+  try {
+    os << "Memory after " << step << "\n\n";
+
+    os << "Directories\n\n"
+       << std::setw(14) << "Variables" << std::setw(14) << "Directory"
+       << std::setw(14) << "Targets" << std::setw(14) << "Sources"
+       << "  Path\n";
+    for (auto const& mf : gg.GetMakefiles()) {
+      cmStateSnapshot const snapshot = mf->GetStateSnapshot();
+      std::string const& path = mf->GetCurrentSourceDirectory();
+
+      std::size_t variables = 0;
+      std::vector<std::pair<std::size_t, std::size_t>> scopes;
+      for (cmDefinitions const* scope : snapshot.GetDefinitionsScopes()) {
+        std::size_t const bytes = scope->GetAllocatedBytes(counted);
+        scopes.emplace_back(bytes, scope->GetSize());
+        variables += bytes;
+      }
+
+      cmStateDirectory const directory = snapshot.GetDirectory();
+      std::size_t const directoryBytes = directory.GetAllocatedBytes();
+      directoryProperties.Add(directory.GetProperties());
+
+      std::size_t targetBytes = 0;
+      for (auto const& t : mf->GetTargets()) {
+        cmTarget const& target = t.second;
+        TargetRow row;
+        row.Name = &t.first;
+        row.Directory = &path;
+        row.Properties = target.GetProperties().GetAllocatedBytes();
+        row.Target = sizeof(cmTarget) + target.GetAllocatedBytes();
+        auto const gti = generatorTargets.find(&target);
+        row.GeneratorTarget =
+          gti != generatorTargets.end() ? gti->second : 0;
+        targets.push_back(row);
+        targetProperties.Add(target.GetProperties());
+        targetBytes += row.Target + row.GeneratorTarget;
+      }
+
+      std::size_t sourceBytes = 0;
+      for (auto const& sf : mf->GetSourceFiles()) {
+        sourceProperties.Add(sf->GetProperties());
+        sourceBytes += sizeof(cmSourceFile) +
+          sf->GetProperties().GetAllocatedBytes() +
+          cmHeapBytes(sf->GetFullPath());
+      }
+
+      os << std::setw(14) << variables << std::setw(14) << directoryBytes
+         << std::setw(14) << targetBytes << std::setw(14) << sourceBytes
+         << "  " << path << '\n';
+      for (std::size_t i = 0; i < scopes.size(); ++i) {
+        os << std::setw(14) << scopes[i].first << "    scope " << i << ", "
+           << scopes[i].second << " entries\n";
+      }
+      total += variables + directoryBytes + targetBytes + sourceBytes;
+    }
+    os << '\n';
+
+    std::stable_sort(targets.begin(), targets.end(),
+                     [](TargetRow const& l, TargetRow const& r) {
+                       std::size_t const lb = l.Target + l.GeneratorTarget;
+                       std::size_t const rb = r.Target + r.GeneratorTarget;
+                       return lb != rb ? lb > rb : *l.Name < *r.Name;
+                     });
+    os << "Targets\n\n"
+       << std::setw(14) << "Properties" << std::setw(14) << "cmTarget"
+       << std::setw(18) << "cmGeneratorTarget"
+       << "  Name (Directory)\n";
+    for (TargetRow const& row : targets) {
+      os << std::setw(14) << row.Properties << std::setw(14) << row.Target
+         << std::setw(18) << row.GeneratorTarget << "  " << *row.Name << " ("
+         << *row.Directory << ")\n";
+    }
+    os << '\n';
+
+    os << "Property maps\n\n"
+       << std::setw(14) << "Maps" << std::setw(14) << "Bytes"
+       << "  Owner\n";
+    for (PropertyMapRow const* row :
+         { &directoryProperties, &targetProperties, &sourceProperties }) {
+      os << std::setw(14) << row->Count << std::setw(14) << row->Bytes << "  "
+         << row->Owner << '\n';
+    }
+    os << '\n';
+
+    os << "Total: " << total << " bytes\n\n";
+    os.flush();
+  } catch (std::ios_base::failure& fail) {
+    cmSystemTools::Error(
+      cmStrCat("Failed to write to memory profiling output: ", fail.what()));
+  } catch (...) {
+    cmSystemTools::Error("Error writing memory profiling output!");
+  }
+}
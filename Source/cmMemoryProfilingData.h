@@ -0,0 +1,30 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmMemoryProfilingData_h
+#define cmMemoryProfilingData_h
+#include <string>
+
+#include "cmsys/FStream.hxx"
+
+class cmGlobalGenerator;
+
+/** \class cmMemoryProfilingData
+ * \brief Report the memory held by the configured project.
+ *
+ * Each report estimates the heap memory held by every directory, its
+ * variable scopes and properties, and every target, and appends tables
+ * of the results to the output file.
+ */
+class cmMemoryProfilingData
+{
+public:
+  cmMemoryProfilingData(const std::string&);
+
+  /** Append a report for the current state of the project, which has
+      reached the given step.  */
+  void Report(std::string const& step, cmGlobalGenerator const& gg);
+
+private:
+  cmsys::ofstream ProfileStream;
+};
+#endif
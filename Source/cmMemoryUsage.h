@@ -0,0 +1,128 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmMemoryUsage_h
+#define cmMemoryUsage_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/** \file cmMemoryUsage.h
+ * \brief Estimate the heap memory held by standard containers.
+ *
+ * cmHeapBytes(x) returns the number of bytes that x has allocated on the
+ * heap, not counting sizeof(x) itself.  The node overhead of the
+ * associative containers is an estimate for the common implementations.
+ */
+
+namespace cmMemoryUsageDetail {
+// Bookkeeping of one node of a tree or hash table besides its value.
+std::size_t const TreeNodeOverhead = 4 * sizeof(void*);
+std::size_t const HashNodeOverhead = 2 * sizeof(void*);
+}
+
+inline std::size_t cmHeapBytes(std::string const& s)
+{
+  // A short string lives in the object itself.
+  char const* const data = s.data();
+  char const* const self = reinterpret_cast<char const*>(&s);
+  if (data >= self && data < self + sizeof(s)) {
+    return 0;
+  }
+  return s.capacity() + 1;
+}
+
+template <typename T>
+typename std::enable_if<std::is_trivially_destructible<T>::value,
+                        std::size_t>::type
+cmHeapBytes(T const&)
+{
+  return 0;
+}
+
+template <typename T, typename U>
+std::size_t cmHeapBytes(std::pair<T, U> const& p);
+template <typename T>
+std::size_t cmHeapBytes(std::vector<T> const& v);
+template <typename K, typename C>
+std::size_t cmHeapBytes(std::set<K, C> const& s);
+template <typename K, typename V, typename C>
+std::size_t cmHeapBytes(std::map<K, V, C> const& m);
+template <typename K, typename H>
+std::size_t cmHeapBytes(std::unordered_set<K, H> const& s);
+template <typename K, typename V, typename H>
+std::size_t cmHeapBytes(std::unordered_map<K, V, H> const& m);
+
+template <typename T, typename U>
+std::size_t cmHeapBytes(std::pair<T, U> const& p)
+{
+  return cmHeapBytes(p.first) + cmHeapBytes(p.second);
+}
+
+template <typename T>
+std::size_t cmHeapBytes(std::vector<T> const& v)
+{
+  std::size_t bytes = v.capacity() * sizeof(T);
+  for (T const& e : v) {
+    bytes += cmHeapBytes(e);
+  }
+  return bytes;
+}
+
+template <typename K, typename C>
+std::size_t cmHeapBytes(std::set<K, C> const& s)
+{
+  std::size_t bytes =
+    s.size() * (sizeof(K) + cmMemoryUsageDetail::TreeNodeOverhead);
+  for (K const& e : s) {
+    bytes += cmHeapBytes(e);
+  }
+  return bytes;
+}
+
+template <typename K, typename V, typename C>
+std::size_t cmHeapBytes(std::map<K, V, C> const& m)
+{
+  std::size_t bytes = m.size() *
+    (sizeof(typename std::map<K, V, C>::value_type) +
+     cmMemoryUsageDetail::TreeNodeOverhead);
+  for (auto const& e : m) {
+    bytes += cmHeapBytes(e.first) + cmHeapBytes(e.second);
+  }
+  return bytes;
+}
+
+template <typename K, typename H>
+std::size_t cmHeapBytes(std::unordered_set<K, H> const& s)
+{
+  std::size_t bytes = s.bucket_count() * sizeof(void*) +
+    s.size() * (sizeof(K) + cmMemoryUsageDetail::HashNodeOverhead);
+  for (K const& e : s) {
+    bytes += cmHeapBytes(e);
+  }
+  return bytes;
+}
+
+template <typename K, typename V, typename H>
+std::size_t cmHeapBytes(std::unordered_map<K, V, H> const& m)
+{
+  std::size_t bytes = m.bucket_count() * sizeof(void*) +
+    m.size() *
+      (sizeof(typename std::unordered_map<K, V, H>::value_type) +
+       cmMemoryUsageDetail::HashNodeOverhead);
+  for (auto const& e : m) {
+    bytes += cmHeapBytes(e.first) + cmHeapBytes(e.second);
+  }
+  return bytes;
+}
+
+#endif
@@ -0,0 +1,264 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmParsedListFileCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmCryptoHash.h"
+#include "cmGeneratedFileStream.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmVersion.h"
+
+namespace {
+
+// Bump when the serialized layout or the parser output changes.
+const char* const CacheMagic = "CMakeParsedListFileCache 1";
+
+bool ReadWholeFile(std::string const& path, std::string& content)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>(fin),
+                 std::istreambuf_iterator<char>());
+  return !fin.bad();
+}
+
+class Writer
+{
+public:
+  explicit Writer(std::ostream& os)
+    : OS(os)
+  {
+  }
+
+  void Number(std::uint64_t n)
+  {
+    char bytes[8];
+    for (char& b : bytes) {
+      b = static_cast<char>(n & 0xff);
+      n >>= 8;
+    }
+    this->OS.write(bytes, sizeof(bytes));
+  }
+
+  void String(std::string const& s)
+  {
+    this->Number(s.size());
+    this->OS.write(s.data(), static_cast<std::streamsize>(s.size()));
+  }
+
+private:
+  std::ostream& OS;
+};
+
+class Reader
+{
+public:
+  explicit Reader(std::string const& data)
+    : Data(data)
+  {
+  }
+
+  bool Number(std::uint64_t& n)
+  {
+    if (this->Data.size() - this->Pos < 8) {
+      return false;
+    }
+    n = 0;
+    for (int i = 7; i >= 0; --i) {
+      n = (n << 8) |
+        static_cast<unsigned char>(this->Data[this->Pos + std::size_t(i)]);
+    }
+    this->Pos += 8;
+    return true;
+  }
+
+  bool String(std::string& s)
+  {
+    std::uint64_t n;
+    if (!this->Number(n) || this->Data.size() - this->Pos < n) {
+      return false;
+    }
+    s.assign(this->Data, this->Pos, static_cast<std::size_t>(n));
+    this->Pos += static_cast<std::size_t>(n);
+    return true;
+  }
+
+private:
+  std::string const& Data;
+  std::size_t Pos = 0;
+};
+
+bool ReadFunction(Reader& r, cmListFileFunction& lff)
+{
+  std::string name;
+  std::uint64_t line;
+  std::uint64_t nargs;
+  if (!r.String(name) || !r.Number(line) || !r.Number(nargs)) {
+    return false;
+  }
+  lff.Name = name;
+  lff.Line = static_cast<long>(line);
+  lff.Arguments.resize(static_cast<std::size_t>(nargs));
+  for (cmListFileArgument& arg : lff.Arguments) {
+    std::uint64_t delim;
+    if (!r.String(arg.Value) || !r.Number(delim) || !r.Number(line) ||
+        delim > cmListFileArgument::Bracket) {
+      return false;
+    }
+    arg.Delim = static_cast<cmListFileArgument::Delimiter>(delim);
+    arg.Line = static_cast<long>(line);
+  }
+  return true;
+}
+
+void WriteFunction(Writer& w, cmListFileFunction const& lff)
+{
+  w.String(lff.Name.Original);
+  w.Number(static_cast<std::uint64_t>(lff.Line));
+  w.Number(lff.Arguments.size());
+  for (cmListFileArgument const& arg : lff.Arguments) {
+    w.String(arg.Value);
+    w.Number(static_cast<std::uint64_t>(arg.Delim));
+    w.Number(static_cast<std::uint64_t>(arg.Line));
+  }
+}
+
+std::string CacheHeader()
+{
+  return cmStrCat(CacheMagic, ' ', cmVersion::GetCMakeVersion());
+}
+}
+
+cmParsedListFileCache::Stamp cmParsedListFileCache::GetStamp(
+  std::string const& path, std::string& content)
+{
+  Stamp stamp;
+  // Take the time before reading so a later change makes it newer.
+  long long const mtime = cmSystemTools::ModifiedTime(path);
+  if (!ReadWholeFile(path, content)) {
+    content.clear();
+    return stamp;
+  }
+  stamp.Size = content.size();
+  stamp.MTime = mtime;
+  stamp.Hash = cmCryptoHash(cmCryptoHash::AlgoMD5).HashString(content);
+  stamp.Valid = true;
+  return stamp;
+}
+
+bool cmParsedListFileCache::Find(std::string const& path, Stamp const& stamp,
+                                 std::vector<cmListFileFunction>& functions)
+{
+  if (!stamp.Valid) {
+    return false;
+  }
+  auto i = this->Entries.find(path);
+  if (i == this->Entries.end()) {
+    return false;
+  }
+  Entry& entry = i->second;
+  if (entry.FileStamp.Size != stamp.Size ||
+      entry.FileStamp.MTime != stamp.MTime ||
+      entry.FileStamp.Hash != stamp.Hash) {
+    return false;
+  }
+  entry.Used = true;
+  functions = entry.Functions;
+  return true;
+}
+
+void cmParsedListFileCache::Insert(
+  std::string const& path, Stamp const& stamp,
+  std::vector<cmListFileFunction> const& functions)
+{
+  if (!stamp.Valid) {
+    return;
+  }
+  Entry& entry = this->Entries[path];
+  entry.FileStamp = stamp;
+  entry.Functions = functions;
+  entry.Used = true;
+}
+
+bool cmParsedListFileCache::Load(std::string const& cacheFile)
+{
+  std::string data;
+  if (!ReadWholeFile(cacheFile, data)) {
+    return false;
+  }
+  Reader r(data);
+  std::string header;
+  std::uint64_t count;
+  if (!r.String(header) || header != CacheHeader() || !r.Number(count)) {
+    return false;
+  }
+  for (std::uint64_t e = 0; e < count; ++e) {
+    std::string path;
+    Entry entry;
+    std::uint64_t size;
+    std::uint64_t mtime;
+    std::uint64_t nfuncs;
+    if (!r.String(path) || !r.Number(size) || !r.Number(mtime) ||
+        !r.String(entry.FileStamp.Hash) || !r.Number(nfuncs)) {
+      return false;
+    }
+    entry.FileStamp.Size = size;
+    entry.FileStamp.MTime = static_cast<long long>(mtime);
+    entry.FileStamp.Valid = true;
+    entry.Functions.resize(static_cast<std::size_t>(nfuncs));
+    for (cmListFileFunction& lff : entry.Functions) {
+      if (!ReadFunction(r, lff)) {
+        return false;
+      }
+    }
+    this->Entries.emplace(std::move(path), std::move(entry));
+  }
+  return true;
+}
+
+bool cmParsedListFileCache::Save(std::string const& cacheFile) const
+{
+  cmGeneratedFileStream fout;
+  fout.Open(cacheFile, true, true);
+  if (!fout) {
+    return false;
+  }
+  fout.SetCopyIfDifferent(true);
+
+  // Write entries in a stable order so unchanged content is not rewritten.
+  std::vector<std::string const*> paths;
+  for (auto const& e : this->Entries) {
+    if (e.second.Used) {
+      paths.push_back(&e.first);
+    }
+  }
+  std::sort(paths.begin(), paths.end(),
+            [](std::string const* l, std::string const* r) {
+              return *l < *r;
+            });
+
+  Writer w(fout);
+  w.String(CacheHeader());
+  w.Number(paths.size());
+  for (std::string const* path : paths) {
+    Entry const& entry = this->Entries.at(*path);
+    w.String(*path);
+    w.Number(entry.FileStamp.Size);
+    w.Number(static_cast<std::uint64_t>(entry.FileStamp.MTime));
+    w.String(entry.FileStamp.Hash);
+    w.Number(entry.Functions.size());
+    for (cmListFileFunction const& lff : entry.Functions) {
+      WriteFunction(w, lff);
+    }
+  }
+  return fout.Close();
+}
@@ -0,0 +1,64 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmParsedListFileCache_h
+#define cmParsedListFileCache_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cmListFileCache.h"
+
+/** \class cmParsedListFileCache
+ * \brief Cache of parsed list file functions keyed by file content.
+ *
+ * Each entry records the size, modification time and content hash of
+ * the file it was parsed from and is reused only while all three still
+ * match the file on disk.  The cache may be saved to and loaded from a
+ * file in the build tree so that unchanged list files need not be
+ * parsed again by a later configure run.
+ */
+class cmParsedListFileCache
+{
+public:
+  /** Identity of a list file's content on disk.  */
+  struct Stamp
+  {
+    bool Valid = false;
+    unsigned long long Size = 0;
+    long long MTime = 0;
+    std::string Hash;
+  };
+
+  /** Read the given file into @a content and compute its stamp from
+      the content read.  */
+  static Stamp GetStamp(std::string const& path, std::string& content);
+
+  /** Copy the functions cached for a file with a matching stamp.  */
+  bool Find(std::string const& path, Stamp const& stamp,
+            std::vector<cmListFileFunction>& functions);
+
+  /** Record the functions parsed from a file with the given stamp.  */
+  void Insert(std::string const& path, Stamp const& stamp,
+              std::vector<cmListFileFunction> const& functions);
+
+  /** Merge entries from a cache file written by Save.  Entries already
+      present in memory take precedence.  */
+  bool Load(std::string const& cacheFile);
+
+  /** Write the entries used since construction or the last Load.  */
+  bool Save(std::string const& cacheFile) const;
+
+private:
+  struct Entry
+  {
+    Stamp FileStamp;
+    std::vector<cmListFileFunction> Functions;
+    bool Used = false;
+  };
+  std::unordered_map<std::string, Entry> Entries;
+};
+
+#endif
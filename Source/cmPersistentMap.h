@@ -0,0 +1,265 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmPersistentMap_h
+#define cmPersistentMap_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+  @brief A map from small integer keys to values with structural sharing
+
+  Copying a cmPersistentMap is O(1): the copy shares all nodes with the
+  original.  A modification copies only the nodes on the path to the
+  modified key that are still shared, so a copy costs memory and time
+  proportional to the number of changes made to it afterwards.
+
+  The map is a bitmap-compressed radix trie over the key bits, 5 bits
+  per level.  It is intended for dense keys such as interned symbols.
+
+  Values that convert to false are tombstones.  The map counts them in
+  every subtree so that EraseTombstones() costs time proportional to the
+  number of tombstones rather than the size of the map.
+
+  A map must not be modified concurrently with any access to a map
+  sharing nodes with it.
+ */
+template <typename T>
+class cmPersistentMap
+{
+public:
+  using key_type = std::uint32_t;
+
+  /** Get a pointer to the value of a key, or null if not present.  */
+  T const* Find(key_type key) const
+  {
+    if (!this->Root || (key >> this->RootShift) >= Width) {
+      return nullptr;
+    }
+    Node const* node = this->Root.get();
+    for (unsigned shift = this->RootShift;; shift -= Bits) {
+      std::uint32_t const bit = std::uint32_t(1) << ((key >> shift) & Mask);
+      if (!(node->Bitmap & bit)) {
+        return nullptr;
+      }
+      std::size_t const pos = SlotOf(node->Bitmap, bit);
+      if (shift == 0) {
+        return &node->Values[pos].second;
+      }
+      node = node->Children[pos].get();
+    }
+  }
+
+  /** Insert a key or replace its value.  */
+  void Set(key_type key, T value)
+  {
+    while (this->Root && (key >> this->RootShift) >= Width) {
+      // Grow the trie by one level above the current root.
+      auto root = std::make_shared<Node>();
+      root->Bitmap = 1;
+      root->Tombstones = this->Root->Tombstones;
+      root->Children.emplace_back(std::move(this->Root));
+      this->Root = std::move(root);
+      this->RootShift += Bits;
+    }
+    if (!this->Root) {
+      this->Root = std::make_shared<Node>();
+      this->RootShift = 0;
+      while ((key >> this->RootShift) >= Width) {
+        this->RootShift += Bits;
+      }
+    }
+    this->Size += SetIn(this->Root, this->RootShift, key, std::move(value));
+  }
+
+  /** Remove all tombstones.  */
+  void EraseTombstones()
+  {
+    if (this->Root && this->Root->Tombstones) {
+      this->Size -= EraseTombstonesIn(this->Root, this->RootShift);
+    }
+  }
+
+  /** Call f(key, value) for every entry in increasing key order.  */
+  template <typename F>
+  void ForEach(F&& f) const
+  {
+    if (this->Root) {
+      ForEachIn(*this->Root, this->RootShift, f);
+    }
+  }
+
+  std::size_t GetSize() const { return this->Size; }
+  bool IsEmpty() const { return this->Size == 0; }
+
+  /** Estimate the heap memory held by the map, with f(value) giving the
+      heap memory held by a value.  Nodes already in 'counted' are shared
+      with a map estimated before and are skipped, so that estimating
+      several maps counts each node once.  */
+  template <typename F>
+  std::size_t GetAllocatedBytes(std::unordered_set<void const*>& counted,
+                                F&& f) const
+  {
+    return this->Root ? AllocatedBytesIn(*this->Root, counted, f) : 0;
+  }
+
+private:
+  static const unsigned Bits = 5;
+  static const std::uint32_t Width = std::uint32_t(1) << Bits;
+  static const std::uint32_t Mask = Width - 1;
+
+  struct Node;
+  using NodePtr = std::shared_ptr<Node>;
+  struct Node
+  {
+    std::uint32_t Bitmap = 0;
+    std::size_t Tombstones = 0;
+    std::vector<NodePtr> Children;
+    std::vector<std::pair<key_type, T>> Values;
+  };
+
+  NodePtr Root;
+  unsigned RootShift = 0;
+  std::size_t Size = 0;
+
+  static std::size_t SlotOf(std::uint32_t bitmap, std::uint32_t bit)
+  {
+    std::uint32_t v = bitmap & (bit - 1);
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return static_cast<std::size_t>(
+      (((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+  }
+
+  static Node& MakeUnique(NodePtr& node)
+  {
+    if (node.use_count() != 1) {
+      node = std::make_shared<Node>(*node);
+    }
+    return *node;
+  }
+
+  // Returns the number of keys added.
+  static std::size_t SetIn(NodePtr& nodePtr, unsigned shift, key_type key,
+                           T&& value)
+  {
+    Node& node = MakeUnique(nodePtr);
+    std::uint32_t const bit = std::uint32_t(1) << ((key >> shift) & Mask);
+    std::size_t const pos = SlotOf(node.Bitmap, bit);
+    bool const present = (node.Bitmap & bit) != 0;
+    if (shift == 0) {
+      std::size_t const isTombstone = value ? 0 : 1;
+      if (present) {
+        T& old = node.Values[pos].second;
+        node.Tombstones -= old ? 0 : 1;
+        node.Tombstones += isTombstone;
+        old = std::move(value);
+        return 0;
+      }
+      node.Bitmap |= bit;
+      node.Tombstones += isTombstone;
+      node.Values.emplace(node.Values.begin() + pos, key, std::move(value));
+      return 1;
+    }
+    if (!present) {
+      node.Bitmap |= bit;
+      node.Children.emplace(node.Children.begin() + pos,
+                            std::make_shared<Node>());
+    }
+    NodePtr& child = node.Children[pos];
+    std::size_t const before = child->Tombstones;
+    std::size_t const added =
+      SetIn(child, shift - Bits, key, std::move(value));
+    node.Tombstones = node.Tombstones - before + child->Tombstones;
+    return added;
+  }
+
+  // Returns the number of keys removed.
+  static std::size_t EraseTombstonesIn(NodePtr& nodePtr, unsigned shift)
+  {
+    Node& node = MakeUnique(nodePtr);
+    std::size_t removed = 0;
+    if (shift == 0) {
+      std::uint32_t bitmap = 0;
+      std::size_t out = 0;
+      for (std::size_t in = 0; in < node.Values.size(); ++in) {
+        if (!node.Values[in].second) {
+          ++removed;
+          continue;
+        }
+        bitmap |= std::uint32_t(1) << (node.Values[in].first & Mask);
+        if (out != in) {
+          node.Values[out] = std::move(node.Values[in]);
+        }
+        ++out;
+      }
+      node.Values.erase(node.Values.begin() + out, node.Values.end());
+      node.Bitmap = bitmap;
+    } else {
+      std::uint32_t bitmap = 0;
+      std::size_t in = 0;
+      std::size_t out = 0;
+      for (std::uint32_t i = 0; i < Width; ++i) {
+        std::uint32_t const bit = std::uint32_t(1) << i;
+        if (!(node.Bitmap & bit)) {
+          continue;
+        }
+        NodePtr& child = node.Children[in++];
+        if (child->Tombstones) {
+          removed += EraseTombstonesIn(child, shift - Bits);
+        }
+        if (child->Bitmap) {
+          bitmap |= bit;
+          node.Children[out++].swap(child);
+        }
+      }
+      node.Children.erase(node.Children.begin() + out, node.Children.end());
+      node.Bitmap = bitmap;
+    }
+    node.Tombstones = 0;
+    return removed;
+  }
+
+  template <typename F>
+  static std::size_t AllocatedBytesIn(Node const& node,
+                                      std::unordered_set<void const*>& counted,
+                                      F& f)
+  {
+    if (!counted.insert(&node).second) {
+      return 0;
+    }
+    // The node shares its allocation with the shared_ptr control block.
+    std::size_t bytes = sizeof(Node) + 2 * sizeof(void*) +
+      node.Children.capacity() * sizeof(NodePtr) +
+      node.Values.capacity() * sizeof(std::pair<key_type, T>);
+    for (auto const& v : node.Values) {
+      bytes += f(v.second);
+    }
+    for (NodePtr const& child : node.Children) {
+      bytes += AllocatedBytesIn(*child, counted, f);
+    }
+    return bytes;
+  }
+
+  template <typename F>
+  static void ForEachIn(Node const& node, unsigned shift, F& f)
+  {
+    if (shift == 0) {
+      for (auto const& v : node.Values) {
+        f(v.first, v.second);
+      }
+      return;
+    }
+    for (NodePtr const& child : node.Children) {
+      ForEachIn(*child, shift - Bits, f);
+    }
+  }
+};
+
+#endif
@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <utility>
 
+#include "cmMemoryUsage.h"
+
 void cmPropertyMap::Clear()
 {
   Map_.clear();
@@ -76,3 +78,8 @@ std::vector<std::pair<std::string, std::string>> cmPropertyMap::GetList() const
             });
   return kvList;
 }
+
+std::size_t cmPropertyMap::GetAllocatedBytes() const
+{
+  return cmHeapBytes(Map_);
+}
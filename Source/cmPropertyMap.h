@@ -5,6 +5,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -46,6 +47,11 @@ public:
   //! Get a sorted by key list of property key,value pairs
   std::vector<std::pair<std::string, std::string>> GetList() const;
 
+  // -- Memory
+
+  //! Estimate the heap memory held by the map
+  std::size_t GetAllocatedBytes() const;
+
 private:
   std::unordered_map<std::string, std::string> Map_;
 };
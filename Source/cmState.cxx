@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <utility>
@@ -20,16 +21,25 @@
 #include "cmListFileCache.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
+#include "cmParsedListFileCache.h"
 #include "cmStatePrivate.h"
 #include "cmStateSnapshot.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmake.h"
 
+namespace {
+std::atomic<unsigned long> NextStateId(1);
+}
+
 cmState::cmState()
+  : Id(NextStateId++)
 {
   this->CacheManager = cm::make_unique<cmCacheManager>();
   this->GlobVerificationManager = cm::make_unique<cmGlobVerificationManager>();
+#if !defined(CMAKE_BOOTSTRAP)
+  this->ListFileCache = std::make_shared<cmParsedListFileCache>();
+#endif
 }
 
 cmState::~cmState() = default;
@@ -407,8 +417,9 @@ void cmState::AddBuiltinCommand(std::string const& name,
 void cmState::AddBuiltinCommand(std::string const& name, Command command)
 {
   assert(name == cmSystemTools::LowerCase(name));
-  assert(this->BuiltinCommands.find(name) == this->BuiltinCommands.end());
-  this->BuiltinCommands.emplace(name, std::move(command));
+  cmCommandBinding& binding = this->Commands[name];
+  assert(!binding.Builtin);
+  binding.Builtin = std::make_shared<Command const>(std::move(command));
 }
 
 static bool InvokeBuiltinCommand(cmState::BuiltinCommand command,
@@ -482,13 +493,14 @@ void cmState::AddUnexpectedCommand(std::string const& name, const char* error)
 void cmState::AddScriptedCommand(std::string const& name, Command command)
 {
   std::string sName = cmSystemTools::LowerCase(name);
+  cmCommandBinding& binding = this->Commands[sName];
 
   // if the command already exists, give a new name to the old command.
-  if (Command oldCmd = this->GetCommandByExactName(sName)) {
-    this->ScriptedCommands["_" + sName] = oldCmd;
+  if (std::shared_ptr<Command const> oldCmd = binding.Get()) {
+    this->Commands["_" + sName].Scripted = std::move(oldCmd);
   }
 
-  this->ScriptedCommands[sName] = std::move(command);
+  binding.Scripted = std::make_shared<Command const>(std::move(command));
 }
 
 cmState::Command cmState::GetCommand(std::string const& name) const
@@ -498,43 +510,58 @@ cmState::Command cmState::GetCommand(std::string const& name) const
 
 cmState::Command cmState::GetCommandByExactName(std::string const& name) const
 {
-  auto pos = this->ScriptedCommands.find(name);
-  if (pos != this->ScriptedCommands.end()) {
-    return pos->second;
-  }
-  pos = this->BuiltinCommands.find(name);
-  if (pos != this->BuiltinCommands.end()) {
-    return pos->second;
+  auto pos = this->Commands.find(name);
+  if (pos != this->Commands.end()) {
+    if (std::shared_ptr<Command const> command = pos->second.Get()) {
+      return *command;
+    }
   }
   return nullptr;
 }
 
+cmCommandBinding const* cmState::GetCommandBinding(std::string const& name)
+{
+  return &this->Commands[name];
+}
+
+cmCommandBinding const* cmState::GetCommandBinding(
+  cmListFileFunction const& lff)
+{
+  cmListFileFunction::DispatchCache& cache = lff.Dispatch;
+  if (cache.StateId != this->Id) {
+    cache.Binding = this->GetCommandBinding(lff.Name.Lower);
+    cache.StateId = this->Id;
+  }
+  return cache.Binding;
+}
+
 std::vector<std::string> cmState::GetCommandNames() const
 {
   std::vector<std::string> commandNames;
-  commandNames.reserve(this->BuiltinCommands.size() +
-                       this->ScriptedCommands.size());
-  for (auto const& bc : this->BuiltinCommands) {
-    commandNames.push_back(bc.first);
-  }
-  for (auto const& sc : this->ScriptedCommands) {
-    commandNames.push_back(sc.first);
+  commandNames.reserve(this->Commands.size());
+  for (auto const& c : this->Commands) {
+    if (c.second.Get()) {
+      commandNames.push_back(c.first);
+    }
   }
   std::sort(commandNames.begin(), commandNames.end());
-  commandNames.erase(std::unique(commandNames.begin(), commandNames.end()),
-                     commandNames.end());
   return commandNames;
 }
 
 void cmState::RemoveBuiltinCommand(std::string const& name)
 {
   assert(name == cmSystemTools::LowerCase(name));
-  this->BuiltinCommands.erase(name);
+  auto pos = this->Commands.find(name);
+  if (pos != this->Commands.end()) {
+    pos->second.Builtin.reset();
+  }
 }
 
 void cmState::RemoveUserDefinedCommands()
 {
-  this->ScriptedCommands.clear();
+  for (auto& c : this->Commands) {
+    c.second.Scripted.reset();
+  }
 }
 
 void cmState::SetGlobalProperty(const std::string& prop, const char* value)
@@ -626,6 +653,11 @@ bool cmState::GetGlobalPropertyAsBool(const std::string& prop)
   return cmIsOn(this->GetGlobalProperty(prop));
 }
 
+cmPropertyMap const& cmState::GetGlobalProperties() const
+{
+  return this->GlobalProperties;
+}
+
 void cmState::SetSourceDirectory(std::string const& sourceDirectory)
 {
   this->SourceDirectory = sourceDirectory;
@@ -643,6 +675,17 @@ void cmState::SetBinaryDirectory(std::string const& binaryDirectory)
   cmSystemTools::ConvertToUnixSlashes(this->BinaryDirectory);
 }
 
+std::shared_ptr<cmParsedListFileCache> const& cmState::GetListFileCache()
+  const
+{
+  return this->ListFileCache;
+}
+
+void cmState::SetListFileCache(std::shared_ptr<cmParsedListFileCache> cache)
+{
+  this->ListFileCache = std::move(cache);
+}
+
 void cmState::SetWindowsShell(bool windowsShell)
 {
   this->WindowsShell = windowsShell;
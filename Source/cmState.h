@@ -6,10 +6,10 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <functional>
-#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cmDefinitions.h"
@@ -28,6 +28,33 @@ class cmGlobVerificationManager;
 class cmStateSnapshot;
 class cmMessenger;
 class cmExecutionStatus;
+class cmParsedListFileCache;
+
+/** \class cmCommandBinding
+ * \brief The commands bound to one name.
+ *
+ * A scripted command overrides a builtin command of the same name.
+ * Bindings are owned by cmState and never move, so callers may keep a
+ * pointer to one instead of looking the name up again.
+ */
+class cmCommandBinding
+{
+public:
+  using Command = std::function<bool(std::vector<cmListFileArgument> const&,
+                                     cmExecutionStatus&)>;
+
+  /** Get the command currently bound, or null.  The caller shares
+      ownership so the command survives its own redefinition.  */
+  std::shared_ptr<Command const> Get() const
+  {
+    return this->Scripted ? this->Scripted : this->Builtin;
+  }
+
+private:
+  friend class cmState;
+  std::shared_ptr<Command const> Builtin;
+  std::shared_ptr<Command const> Scripted;
+};
 
 class cmState
 {
@@ -142,8 +169,7 @@ public:
   bool GetIsGeneratorMultiConfig() const;
   void SetIsGeneratorMultiConfig(bool b);
 
-  using Command = std::function<bool(std::vector<cmListFileArgument> const&,
-                                     cmExecutionStatus&)>;
+  using Command = cmCommandBinding::Command;
   using BuiltinCommand = bool (*)(std::vector<std::string> const&,
                                   cmExecutionStatus&);
 
@@ -151,6 +177,12 @@ public:
   Command GetCommand(std::string const& name) const;
   // Returns a command from its name, or nullptr
   Command GetCommandByExactName(std::string const& name) const;
+  // Returns the binding of a lower-case command name.  The binding stays
+  // valid for the lifetime of this state and follows later definitions.
+  cmCommandBinding const* GetCommandBinding(std::string const& name);
+  // Returns the binding of the command a function calls.  The binding is
+  // cached in the function for later calls made through this state.
+  cmCommandBinding const* GetCommandBinding(cmListFileFunction const& lff);
 
   void AddBuiltinCommand(std::string const& name,
                          std::unique_ptr<cmCommand> command);
@@ -169,12 +201,18 @@ public:
                             bool asString = false);
   cmProp GetGlobalProperty(const std::string& prop);
   bool GetGlobalPropertyAsBool(const std::string& prop);
+  cmPropertyMap const& GetGlobalProperties() const;
 
   std::string const& GetSourceDirectory() const;
   void SetSourceDirectory(std::string const& sourceDirectory);
   std::string const& GetBinaryDirectory() const;
   void SetBinaryDirectory(std::string const& binaryDirectory);
 
+  /** Cache of parsed list files.  May be null, and may be shared with
+      the state of a nested try_compile project.  */
+  std::shared_ptr<cmParsedListFileCache> const& GetListFileCache() const;
+  void SetListFileCache(std::shared_ptr<cmParsedListFileCache> cache);
+
   void SetWindowsShell(bool windowsShell);
   bool UseWindowsShell() const;
   void SetWindowsVSIDE(bool windowsVSIDE);
@@ -220,11 +258,13 @@ private:
 
   cmPropertyDefinitionMap PropertyDefinitions;
   std::vector<std::string> EnabledLanguages;
-  std::map<std::string, Command> BuiltinCommands;
-  std::map<std::string, Command> ScriptedCommands;
+  std::unordered_map<std::string, cmCommandBinding> Commands;
+  // Identifies this state in command bindings cached by functions.
+  unsigned long const Id;
   cmPropertyMap GlobalProperties;
   std::unique_ptr<cmCacheManager> CacheManager;
   std::unique_ptr<cmGlobVerificationManager> GlobVerificationManager;
+  std::shared_ptr<cmParsedListFileCache> ListFileCache;
 
   cmLinkedTree<cmStateDetail::BuildsystemDirectoryStateType>
     BuildsystemDirectory;
@@ -11,6 +11,7 @@
 #include <cmext/algorithm>
 
 #include "cmAlgorithms.h"
+#include "cmMemoryUsage.h"
 #include "cmProperty.h"
 #include "cmPropertyMap.h"
 #include "cmRange.h"
@@ -660,3 +661,29 @@ void cmStateDirectory::AddNormalTargetName(std::string const& name)
 {
   this->DirectoryState->NormalTargetNames.push_back(name);
 }
+
+cmPropertyMap const& cmStateDirectory::GetProperties() const
+{
+  return this->DirectoryState->Properties;
+}
+
+std::size_t cmStateDirectory::GetAllocatedBytes() const
+{
+  cmStateDetail::BuildsystemDirectoryStateType const& d =
+    *this->DirectoryState;
+  // Backtraces share their frames, so count only the handles.
+  std::size_t const backtraces = d.IncludeDirectoryBacktraces.capacity() +
+    d.CompileDefinitionsBacktraces.capacity() +
+    d.CompileOptionsBacktraces.capacity() +
+    d.LinkOptionsBacktraces.capacity() +
+    d.LinkDirectoriesBacktraces.capacity();
+  return cmHeapBytes(d.Location) + cmHeapBytes(d.OutputLocation) +
+    cmHeapBytes(d.RelativePathTopSource) +
+    cmHeapBytes(d.RelativePathTopBinary) + cmHeapBytes(d.IncludeDirectories) +
+    cmHeapBytes(d.CompileDefinitions) + cmHeapBytes(d.CompileOptions) +
+    cmHeapBytes(d.LinkOptions) + cmHeapBytes(d.LinkDirectories) +
+    cmHeapBytes(d.NormalTargetNames) + cmHeapBytes(d.ProjectName) +
+    backtraces * sizeof(cmListFileBacktrace) +
+    d.Properties.GetAllocatedBytes() +
+    d.Children.capacity() * sizeof(cmStateSnapshot);
+}
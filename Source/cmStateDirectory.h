@@ -6,6 +6,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -17,6 +18,8 @@
 #include "cmStateSnapshot.h"
 #include "cmStringAlgorithms.h"
 
+class cmPropertyMap;
+
 class cmStateDirectory
 {
   cmStateDirectory(
@@ -94,6 +97,9 @@ public:
 
   void AddNormalTargetName(std::string const& name);
 
+  cmPropertyMap const& GetProperties() const;
+  std::size_t GetAllocatedBytes() const;
+
 private:
   void ComputeRelativePathTopSource();
   void ComputeRelativePathTopBinary();
@@ -238,6 +238,16 @@ std::vector<std::string> cmStateSnapshot::ClosureKeys() const
                                     this->Position->Root);
 }
 
+std::vector<cmDefinitions const*> cmStateSnapshot::GetDefinitionsScopes()
+  const
+{
+  std::vector<cmDefinitions const*> scopes;
+  for (auto it = this->Position->Vars; it != this->Position->Root; ++it) {
+    scopes.push_back(&*it);
+  }
+  return scopes;
+}
+
 bool cmStateSnapshot::RaiseScope(std::string const& var, const char* varDef)
 {
   if (this->Position->ScopeParent == this->Position->DirectoryParent) {
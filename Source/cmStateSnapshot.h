@@ -15,6 +15,7 @@
 #include "cmPolicies.h"
 #include "cmStateTypes.h"
 
+class cmDefinitions;
 class cmState;
 class cmStateDirectory;
 
@@ -30,6 +31,7 @@ public:
   void RemoveDefinition(std::string const& name);
   std::vector<std::string> ClosureKeys() const;
   bool RaiseScope(std::string const& var, const char* varDef);
+  std::vector<cmDefinitions const*> GetDefinitionsScopes() const;
 
   void SetListFile(std::string const& listfile);
 
@@ -24,6 +24,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmListFileCache.h"
 #include "cmMakefile.h"
+#include "cmMemoryUsage.h"
 #include "cmMessageType.h"
 #include "cmMessenger.h"
 #include "cmProperty.h"
@@ -373,6 +374,7 @@ cmTarget::cmTarget(std::string const& name, cmStateEnums::TargetType type,
     initProp("Swift_MODULE_DIRECTORY");
     initProp("VS_JUST_MY_CODE_DEBUGGING");
     initProp("DISABLE_PRECOMPILE_HEADERS");
+    initProp("PRECOMPILE_HEADERS_AUTO_REUSE");
     initProp("UNITY_BUILD");
     initPropValue("UNITY_BUILD_BATCH_SIZE", "8");
     initPropValue("UNITY_BUILD_MODE", "BATCH");
@@ -725,6 +727,7 @@ void cmTarget::AddPostBuildCommand(cmCustomCommand&& cmd)
 
 void cmTarget::AddTracedSources(std::vector<std::string> const& srcs)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   if (!srcs.empty()) {
     cmListFileBacktrace lfbt = impl->Makefile->GetBacktrace();
     impl->SourceEntries.push_back(cmJoin(srcs, ";"));
@@ -734,6 +737,7 @@ void cmTarget::AddTracedSources(std::vector<std::string> const& srcs)
 
 void cmTarget::AddSources(std::vector<std::string> const& srcs)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   std::string srcFiles;
   const char* sep = "";
   for (auto filename : srcs) {
@@ -1168,6 +1172,7 @@ void cmTarget::SetProperty(const std::string& prop, const char* value)
         impl->Makefile->GetBacktrace())) {
     return;
   }
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
 #define MAKE_STATIC_PROP(PROP) static const std::string prop##PROP = #PROP
   MAKE_STATIC_PROP(C_STANDARD);
   MAKE_STATIC_PROP(CXX_STANDARD);
@@ -1379,6 +1384,7 @@ void cmTarget::AppendProperty(const std::string& prop,
         impl->Makefile->GetBacktrace())) {
     return;
   }
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   if (prop == "NAME") {
     impl->Makefile->IssueMessage(MessageType::FATAL_ERROR,
                                  "NAME property is read-only\n");
@@ -1509,6 +1515,7 @@ void cmTarget::AppendBuildInterfaceIncludes()
 void cmTarget::InsertInclude(std::string const& entry,
                              cmListFileBacktrace const& bt, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   auto position = before ? impl->IncludeDirectoriesEntries.begin()
                          : impl->IncludeDirectoriesEntries.end();
 
@@ -1522,6 +1529,7 @@ void cmTarget::InsertInclude(std::string const& entry,
 void cmTarget::InsertCompileOption(std::string const& entry,
                                    cmListFileBacktrace const& bt, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   auto position = before ? impl->CompileOptionsEntries.begin()
                          : impl->CompileOptionsEntries.end();
 
@@ -1535,6 +1543,7 @@ void cmTarget::InsertCompileOption(std::string const& entry,
 void cmTarget::InsertCompileDefinition(std::string const& entry,
                                        cmListFileBacktrace const& bt)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   impl->CompileDefinitionsEntries.push_back(entry);
   impl->CompileDefinitionsBacktraces.push_back(bt);
 }
@@ -1542,6 +1551,7 @@ void cmTarget::InsertCompileDefinition(std::string const& entry,
 void cmTarget::InsertLinkOption(std::string const& entry,
                                 cmListFileBacktrace const& bt, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   auto position =
     before ? impl->LinkOptionsEntries.begin() : impl->LinkOptionsEntries.end();
 
@@ -1555,6 +1565,7 @@ void cmTarget::InsertLinkOption(std::string const& entry,
 void cmTarget::InsertLinkDirectory(std::string const& entry,
                                    cmListFileBacktrace const& bt, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   auto position = before ? impl->LinkDirectoriesEntries.begin()
                          : impl->LinkDirectoriesEntries.end();
 
@@ -1568,6 +1579,7 @@ void cmTarget::InsertLinkDirectory(std::string const& entry,
 void cmTarget::InsertPrecompileHeader(std::string const& entry,
                                       cmListFileBacktrace const& bt)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   impl->PrecompileHeadersEntries.push_back(entry);
   impl->PrecompileHeadersBacktraces.push_back(bt);
 }
@@ -1892,6 +1904,41 @@ cmPropertyMap const& cmTarget::GetProperties() const
   return impl->Properties;
 }
 
+std::size_t cmTarget::GetAllocatedBytes() const
+{
+  // Backtraces share their frames, so count only the handles.
+  std::size_t const backtraces =
+    impl->IncludeDirectoriesBacktraces.capacity() +
+    impl->CompileOptionsBacktraces.capacity() +
+    impl->CompileFeaturesBacktraces.capacity() +
+    impl->CompileDefinitionsBacktraces.capacity() +
+    impl->PrecompileHeadersBacktraces.capacity() +
+    impl->SourceBacktraces.capacity() +
+    impl->LinkOptionsBacktraces.capacity() +
+    impl->LinkDirectoriesBacktraces.capacity() +
+    impl->LinkImplementationPropertyBacktraces.capacity();
+  std::size_t const commands = impl->PreBuildCommands.capacity() +
+    impl->PreLinkCommands.capacity() + impl->PostBuildCommands.capacity();
+  return sizeof(cmTargetInternals) + cmHeapBytes(impl->Name) +
+    cmHeapBytes(impl->InstallPath) + cmHeapBytes(impl->RuntimeInstallPath) +
+    impl->Properties.GetAllocatedBytes() +
+    cmHeapBytes(impl->SystemIncludeDirectories) +
+    cmHeapBytes(impl->OriginalLinkLibraries) +
+    cmHeapBytes(impl->IncludeDirectoriesEntries) +
+    cmHeapBytes(impl->CompileOptionsEntries) +
+    cmHeapBytes(impl->CompileFeaturesEntries) +
+    cmHeapBytes(impl->CompileDefinitionsEntries) +
+    cmHeapBytes(impl->PrecompileHeadersEntries) +
+    cmHeapBytes(impl->SourceEntries) + cmHeapBytes(impl->LinkOptionsEntries) +
+    cmHeapBytes(impl->LinkDirectoriesEntries) +
+    cmHeapBytes(impl->LinkImplementationPropertyEntries) +
+    backtraces * sizeof(cmListFileBacktrace) +
+    commands * sizeof(cmCustomCommand) +
+    impl->InstallGenerators.capacity() * sizeof(cmInstallTargetGenerator*) +
+    impl->TLLCommands.capacity() *
+    sizeof(std::pair<cmTarget::TLLSignature, cmListFileContext>);
+}
+
 bool cmTarget::IsDLLPlatform() const
 {
   return impl->IsDLLPlatform;
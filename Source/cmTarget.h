@@ -5,6 +5,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <iosfwd>
 #include <memory>
 #include <set>
@@ -187,6 +188,9 @@ public:
   //! Get all properties
   cmPropertyMap const& GetProperties() const;
 
+  //! Estimate the heap memory held by the target
+  std::size_t GetAllocatedBytes() const;
+
   //! Return whether or not the target is for a DLL platform.
   bool IsDLLPlatform() const;
 
@@ -0,0 +1,383 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmTargetFingerprints.h"
+
+#include <utility>
+
+#include <cm/string_view>
+
+#include "cmCryptoHash.h"
+#include "cmCustomCommand.h"
+#include "cmCustomCommandLines.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
+#include "cmLinkItem.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmPolicies.h"
+#include "cmProperty.h"
+#include "cmPropertyMap.h"
+#include "cmSourceFile.h"
+#include "cmState.h"
+#include "cmStateDirectory.h"
+#include "cmStateSnapshot.h"
+#include "cmStateTypes.h"
+#include "cmSystemTools.h"
+#include "cmTarget.h"
+#include "cmTargetDepend.h"
+#include "cmVersion.h"
+#include "cmake.h"
+
+namespace {
+
+void AppendString(cmCryptoHash& hash, cm::string_view value)
+{
+  // Terminate each string so that adjacent values cannot run together.
+  hash.Append(value);
+  hash.Append(cm::string_view("", 1));
+}
+
+void AppendProperty(cmCryptoHash& hash, std::string const& name,
+                    cmProp value)
+{
+  if (value) {
+    AppendString(hash, name);
+    AppendString(hash, *value);
+  }
+}
+
+void AppendProperties(cmCryptoHash& hash, cmPropertyMap const& properties)
+{
+  for (auto const& p : properties.GetList()) {
+    AppendString(hash, p.first);
+    AppendString(hash, p.second);
+  }
+}
+
+// Append one character per policy, e.g. for the settings recorded on a
+// target or in effect at the end of a directory.
+template <typename GetStatus>
+void AppendPolicies(cmCryptoHash& hash, GetStatus getStatus)
+{
+  std::string statuses;
+  statuses.reserve(cmPolicies::CMPCOUNT);
+  for (int i = 0; i < cmPolicies::CMPCOUNT; ++i) {
+    statuses +=
+      static_cast<char>('0' + getStatus(static_cast<cmPolicies::PolicyID>(i)));
+  }
+  AppendString(hash, statuses);
+}
+
+// Whether a value may contain a generator expression that reads a target
+// other than the one being evaluated.
+bool MayReadOtherTargets(cm::string_view value)
+{
+  return value.find("$<TARGET") != cm::string_view::npos ||
+    value.find("GENEX_EVAL") != cm::string_view::npos;
+}
+
+bool MayReadOtherTargets(cmPropertyMap const& properties)
+{
+  for (auto const& p : properties.GetList()) {
+    if (MayReadOtherTargets(p.second)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Target properties that are not stored in the property map.
+char const* const TargetEntryProperties[] = {
+  "C_STANDARD",          "CXX_STANDARD",
+  "CUDA_STANDARD",       "OBJC_STANDARD",
+  "OBJCXX_STANDARD",     "LINK_LIBRARIES",
+  "INCLUDE_DIRECTORIES", "COMPILE_FEATURES",
+  "COMPILE_OPTIONS",     "COMPILE_DEFINITIONS",
+  "PRECOMPILE_HEADERS",  "LINK_OPTIONS",
+  "LINK_DIRECTORIES",    "MANUALLY_ADDED_DEPENDENCIES",
+  "SOURCES"
+};
+
+// Source file properties that are not stored in the property map.
+char const* const SourceEntryProperties[] = { "INCLUDE_DIRECTORIES",
+                                              "COMPILE_OPTIONS",
+                                              "COMPILE_DEFINITIONS" };
+
+// Directory properties that are not stored in the property map.
+char const* const DirectoryEntryProperties[] = {
+  "INCLUDE_DIRECTORIES", "COMPILE_DEFINITIONS", "COMPILE_OPTIONS",
+  "LINK_OPTIONS", "LINK_DIRECTORIES"
+};
+}
+
+cmTargetFingerprints::cmTargetFingerprints(cmGlobalGenerator* gg)
+  : GlobalGenerator(gg)
+{
+}
+
+std::string cmTargetFingerprints::GetFingerprint(
+  cmGeneratorTarget const* target)
+{
+  // Collect the targets whose inputs the rules of this target may read.
+  std::set<cmGeneratorTarget const*> targets;
+  std::vector<std::string> const& configs =
+    target->Makefile->GetGeneratorConfigs(cmMakefile::IncludeEmptyConfig);
+  for (std::string const& config : configs) {
+    if (cmLinkImplementationLibraries const* impl =
+          target->GetLinkImplementationLibraries(config)) {
+      for (cmLinkImplItem const& lib : impl->Libraries) {
+        if (lib.Target && targets.insert(lib.Target).second) {
+          this->CollectLinked(target, lib.Target, config, targets);
+        }
+      }
+    }
+  }
+  for (cmLinkItem const& util : target->GetUtilityItems()) {
+    if (util.Target) {
+      targets.insert(util.Target);
+    }
+  }
+  for (cmTargetDepend const& dep :
+       this->GlobalGenerator->GetTargetDirectDepends(target)) {
+    targets.insert(dep);
+  }
+  TargetInputs const& inputs = this->GetTargetInputs(target);
+  targets.insert(inputs.Referenced.begin(), inputs.Referenced.end());
+  targets.erase(target);
+
+  // Order the inputs independently of where the targets live in memory.
+  bool readsAnyTarget = inputs.ReadsAnyTarget;
+  std::set<std::string> hashes;
+  for (cmGeneratorTarget const* dep : targets) {
+    TargetInputs const& depInputs = this->GetTargetInputs(dep);
+    readsAnyTarget = readsAnyTarget || depInputs.ReadsAnyTarget;
+    hashes.insert(depInputs.Hash);
+  }
+
+  cmCryptoHash hash(cmCryptoHash::AlgoMD5);
+  hash.Initialize();
+  AppendString(hash, this->GetGlobalHash());
+  AppendString(hash, inputs.Hash);
+  for (std::string const& h : hashes) {
+    AppendString(hash, h);
+  }
+  if (readsAnyTarget) {
+    AppendString(hash, this->GetProjectHash());
+  }
+  return hash.FinalizeHex();
+}
+
+void cmTargetFingerprints::CollectLinked(
+  cmGeneratorTarget const* head, cmGeneratorTarget const* target,
+  std::string const& config, std::set<cmGeneratorTarget const*>& targets)
+{
+  std::vector<cmGeneratorTarget const*> linked;
+  if (cmLinkInterface const* iface = target->GetLinkInterface(config, head)) {
+    for (cmLinkItem const& lib : iface->Libraries) {
+      linked.push_back(lib.Target);
+    }
+    for (cmLinkItem const& lib : iface->SharedDeps) {
+      linked.push_back(lib.Target);
+    }
+  }
+  if (cmLinkInterfaceLibraries const* usage =
+        target->GetLinkInterfaceLibraries(config, head, true)) {
+    for (cmLinkItem const& lib : usage->Libraries) {
+      linked.push_back(lib.Target);
+    }
+  }
+  for (cmGeneratorTarget const* dep : linked) {
+    if (dep && targets.insert(dep).second) {
+      this->CollectLinked(head, dep, config, targets);
+    }
+  }
+}
+
+cmTargetFingerprints::TargetInputs const&
+cmTargetFingerprints::GetTargetInputs(cmGeneratorTarget const* target)
+{
+  auto i = this->Targets.find(target);
+  if (i != this->Targets.end()) {
+    return i->second;
+  }
+  TargetInputs& inputs = this->Targets[target];
+  cmLocalGenerator const* lg = target->GetLocalGenerator();
+
+  cmCryptoHash hash(cmCryptoHash::AlgoMD5);
+  hash.Initialize();
+  AppendString(hash, target->GetName());
+  AppendString(hash, cmState::GetTargetTypeName(target->GetType()));
+  AppendString(hash, target->IsImported() ? "IMPORTED" : "");
+  AppendString(hash, this->GetDirectoryHash(lg));
+
+  cmTarget const* t = target->Target;
+  AppendPolicies(hash, [t](cmPolicies::PolicyID id) {
+    return t->GetPolicyStatus(id);
+  });
+  AppendProperties(hash, t->GetProperties());
+  inputs.ReadsAnyTarget = MayReadOtherTargets(t->GetProperties());
+  for (char const* name : TargetEntryProperties) {
+    cmProp value = t->GetProperty(name);
+    AppendProperty(hash, name, value);
+    if (value && MayReadOtherTargets(*value)) {
+      inputs.ReadsAnyTarget = true;
+    }
+  }
+
+  for (auto const* commands :
+       { &t->GetPreBuildCommands(), &t->GetPreLinkCommands(),
+         &t->GetPostBuildCommands() }) {
+    AppendString(hash, "COMMANDS");
+    for (cmCustomCommand const& cc : *commands) {
+      this->HashCustomCommand(hash, cc, lg, inputs);
+    }
+  }
+
+  if (!target->IsImported() &&
+      target->GetType() != cmStateEnums::INTERFACE_LIBRARY) {
+    std::vector<std::string> const& configs =
+      target->Makefile->GetGeneratorConfigs(cmMakefile::IncludeEmptyConfig);
+    for (std::string const& config : configs) {
+      AppendString(hash, config);
+      std::vector<cmSourceFile*> sources;
+      target->GetSourceFiles(sources, config);
+      for (cmSourceFile const* sf : sources) {
+        AppendString(hash, sf->GetFullPath());
+        AppendProperties(hash, sf->GetProperties());
+        if (MayReadOtherTargets(sf->GetProperties())) {
+          inputs.ReadsAnyTarget = true;
+        }
+        for (char const* name : SourceEntryProperties) {
+          cmProp value = sf->GetProperty(name);
+          AppendProperty(hash, name, value);
+          if (value && MayReadOtherTargets(*value)) {
+            inputs.ReadsAnyTarget = true;
+          }
+        }
+        if (cmCustomCommand const* cc = sf->GetCustomCommand()) {
+          this->HashCustomCommand(hash, *cc, lg, inputs);
+        }
+      }
+    }
+  }
+
+  inputs.Hash = hash.FinalizeHex();
+  return inputs;
+}
+
+void cmTargetFingerprints::HashCustomCommand(cmCryptoHash& hash,
+                                             cmCustomCommand const& cc,
+                                             cmLocalGenerator const* lg,
+                                             TargetInputs& inputs)
+{
+  auto appendList = [&hash, &inputs](std::vector<std::string> const& list) {
+    AppendString(hash, std::to_string(list.size()));
+    for (std::string const& s : list) {
+      AppendString(hash, s);
+      if (MayReadOtherTargets(s)) {
+        inputs.ReadsAnyTarget = true;
+      }
+    }
+  };
+  appendList(cc.GetOutputs());
+  appendList(cc.GetByproducts());
+  appendList(cc.GetDepends());
+  for (cmCustomCommandLine const& line : cc.GetCommandLines()) {
+    appendList(line);
+    // A command may name an executable target to run.
+    if (!line.empty()) {
+      if (cmGeneratorTarget* gt = lg->FindGeneratorTargetToUse(line[0])) {
+        inputs.Referenced.push_back(gt);
+      }
+    }
+  }
+  // A dependency may name a target whose file is depended on.
+  for (std::string const& dep : cc.GetDepends()) {
+    if (cmGeneratorTarget* gt = lg->FindGeneratorTargetToUse(dep)) {
+      inputs.Referenced.push_back(gt);
+    }
+  }
+  for (auto const& idi : cc.GetImplicitDepends()) {
+    AppendString(hash, idi.first);
+    AppendString(hash, idi.second);
+  }
+  AppendString(hash, cc.GetWorkingDirectory());
+  AppendString(hash, cc.GetComment() ? cc.GetComment() : "");
+  AppendString(hash, cc.GetDepfile());
+  AppendString(hash, cc.GetJobPool());
+  char const flags[] = { cc.GetEscapeOldStyle() ? '1' : '0',
+                         cc.GetEscapeAllowMakeVars() ? '1' : '0',
+                         cc.GetUsesTerminal() ? '1' : '0',
+                         cc.GetCommandExpandLists() ? '1' : '0',
+                         cc.GetStdPipesUTF8() ? '1' : '0' };
+  AppendString(hash, cm::string_view(flags, sizeof(flags)));
+}
+
+std::string const& cmTargetFingerprints::GetDirectoryHash(
+  cmLocalGenerator const* lg)
+{
+  std::string& result = this->Directories[lg];
+  if (!result.empty()) {
+    return result;
+  }
+  cmCryptoHash hash(cmCryptoHash::AlgoMD5);
+  hash.Initialize();
+  AppendString(hash, lg->GetCurrentSourceDirectory());
+  AppendString(hash, lg->GetCurrentBinaryDirectory());
+
+  AppendPolicies(hash, [lg](cmPolicies::PolicyID id) {
+    return lg->GetPolicyStatus(id);
+  });
+
+  // The variables of the directory, including cache entries.
+  cmMakefile const* mf = lg->GetMakefile();
+  for (std::string const& name : mf->GetDefinitions()) {
+    AppendProperty(hash, name, mf->GetDef(name));
+  }
+
+  // The properties of the directory and the directories it inherits from.
+  for (cmStateSnapshot snapshot = lg->GetStateSnapshot(); snapshot.IsValid();
+       snapshot = snapshot.GetBuildsystemDirectoryParent()) {
+    cmStateDirectory dir = snapshot.GetDirectory();
+    AppendString(hash, dir.GetCurrentBinary());
+    AppendProperties(hash, dir.GetProperties());
+    for (char const* name : DirectoryEntryProperties) {
+      AppendProperty(hash, name, dir.GetProperty(name));
+    }
+  }
+
+  result = hash.FinalizeHex();
+  return result;
+}
+
+std::string const& cmTargetFingerprints::GetGlobalHash()
+{
+  if (this->GlobalHash.empty()) {
+    cmake* cm = this->GlobalGenerator->GetCMakeInstance();
+    cmCryptoHash hash(cmCryptoHash::AlgoMD5);
+    hash.Initialize();
+    AppendString(hash, cmVersion::GetCMakeVersion());
+    AppendString(hash, cmSystemTools::GetCMakeCommand());
+    AppendString(hash, this->GlobalGenerator->GetName());
+    AppendString(hash, cm->GetHomeDirectory());
+    AppendString(hash, cm->GetHomeOutputDirectory());
+    AppendProperties(hash, cm->GetState()->GetGlobalProperties());
+    this->GlobalHash = hash.FinalizeHex();
+  }
+  return this->GlobalHash;
+}
+
+std::string const& cmTargetFingerprints::GetProjectHash()
+{
+  if (this->ProjectHash.empty()) {
+    cmCryptoHash hash(cmCryptoHash::AlgoMD5);
+    hash.Initialize();
+    for (auto const& lg : this->GlobalGenerator->GetLocalGenerators()) {
+      for (auto const& gt : lg->GetGeneratorTargets()) {
+        AppendString(hash, this->GetTargetInputs(gt.get()).Hash);
+      }
+    }
+    this->ProjectHash = hash.FinalizeHex();
+  }
+  return this->ProjectHash;
+}
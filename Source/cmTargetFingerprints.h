@@ -0,0 +1,74 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmTargetFingerprints_h
+#define cmTargetFingerprints_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class cmCryptoHash;
+class cmCustomCommand;
+class cmGeneratorTarget;
+class cmGlobalGenerator;
+class cmLocalGenerator;
+
+/** \class cmTargetFingerprints
+ * \brief Summarize the inputs of the build rules generated for a target.
+ *
+ * The fingerprint of a target is a hash of everything the build rules
+ * generated for it may read: its properties, policy settings, sources
+ * and custom commands, the variables, policy settings and properties of
+ * its directory, and the same inputs of every target it links to or
+ * depends on.  A generator may skip
+ * writing the rules of a target whose fingerprint did not change since
+ * the rules were last written.
+ *
+ * When a target reads other targets through generator expressions that
+ * cannot be followed statically, its fingerprint covers all targets of
+ * the project.
+ */
+class cmTargetFingerprints
+{
+public:
+  cmTargetFingerprints(cmGlobalGenerator* gg);
+
+  cmTargetFingerprints(cmTargetFingerprints const&) = delete;
+  cmTargetFingerprints& operator=(cmTargetFingerprints const&) = delete;
+
+  /** Get the fingerprint of the given target.  */
+  std::string GetFingerprint(cmGeneratorTarget const* target);
+
+private:
+  struct TargetInputs
+  {
+    std::string Hash;
+    // Targets named by custom commands of the target.
+    std::vector<cmGeneratorTarget const*> Referenced;
+    // Whether a generator expression may read any other target.
+    bool ReadsAnyTarget = false;
+  };
+
+  TargetInputs const& GetTargetInputs(cmGeneratorTarget const* target);
+  std::string const& GetDirectoryHash(cmLocalGenerator const* lg);
+  std::string const& GetGlobalHash();
+  std::string const& GetProjectHash();
+
+  void CollectLinked(cmGeneratorTarget const* head,
+                     cmGeneratorTarget const* target,
+                     std::string const& config,
+                     std::set<cmGeneratorTarget const*>& targets);
+  void HashCustomCommand(cmCryptoHash& hash, cmCustomCommand const& cc,
+                         cmLocalGenerator const* lg, TargetInputs& inputs);
+
+  cmGlobalGenerator* GlobalGenerator;
+  std::map<cmGeneratorTarget const*, TargetInputs> Targets;
+  std::map<cmLocalGenerator const*, std::string> Directories;
+  std::string GlobalHash;
+  std::string ProjectHash;
+};
+
+#endif
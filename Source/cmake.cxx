@@ -34,6 +34,7 @@
 #include "cmDuration.h"
 #include "cmExternalMakefileProjectGenerator.h"
 #include "cmFileTimeCache.h"
+#include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalGenerator.h"
 #include "cmGlobalGeneratorFactory.h"
@@ -42,6 +43,7 @@
 #include "cmMakefile.h"
 #if !defined(CMAKE_BOOTSTRAP)
 #  include "cmMakefileProfilingData.h"
+#  include "cmMemoryProfilingData.h"
 #endif
 #include "cmMessenger.h"
 #include "cmState.h"
@@ -61,6 +63,7 @@
 
 #  include "cmFileAPI.h"
 #  include "cmGraphVizWriter.h"
+#  include "cmParsedListFileCache.h"
 #  include "cmVariableWatch.h"
 #endif
 
@@ -620,6 +623,7 @@ void cmake::SetArgs(const std::vector<std::string>& args)
 #if !defined(CMAKE_BOOTSTRAP)
   std::string profilingFormat;
   std::string profilingOutput;
+  std::string memoryProfilingOutput;
 #endif
   for (unsigned int i = 1; i < args.size(); ++i) {
     std::string const& arg = args[i];
@@ -844,6 +848,20 @@ void cmake::SetArgs(const std::vector<std::string>& args)
       if (profilingFormat.empty()) {
         cmSystemTools::Error("No format specified for --profiling-format");
       }
+    } else if (cmHasLiteralPrefix(arg, "--profiling-memory-output")) {
+      std::size_t const prefix = strlen("--profiling-memory-output=");
+      memoryProfilingOutput.clear();
+      if (arg.size() > prefix) {
+        memoryProfilingOutput = arg.substr(prefix);
+      }
+      if (memoryProfilingOutput.empty()) {
+        cmSystemTools::Error(
+          "No path specified for --profiling-memory-output");
+      } else {
+        memoryProfilingOutput =
+          cmSystemTools::CollapseFullPath(memoryProfilingOutput);
+        cmSystemTools::ConvertToUnixSlashes(memoryProfilingOutput);
+      }
     } else if (cmHasLiteralPrefix(arg, "--profiling-output")) {
       profilingOutput = arg.substr(strlen("--profiling-output="));
       profilingOutput = cmSystemTools::CollapseFullPath(profilingOutput);
@@ -876,19 +894,34 @@ void cmake::SetArgs(const std::vector<std::string>& args)
         "--profiling-format specified but no --profiling-output!");
       return;
     }
+    cmMakefileProfilingData::Format format;
     if (profilingFormat == "google-trace"_s) {
-      try {
-        this->ProfilingOutput =
-          cm::make_unique<cmMakefileProfilingData>(profilingOutput);
-      } catch (std::runtime_error& e) {
-        cmSystemTools::Error(
-          cmStrCat("Could not start profiling: ", e.what()));
-        return;
-      }
+      format = cmMakefileProfilingData::Format::GoogleTrace;
+    } else if (profilingFormat == "folded"_s) {
+      format = cmMakefileProfilingData::Format::Folded;
+    } else if (profilingFormat == "summary"_s) {
+      format = cmMakefileProfilingData::Format::Summary;
     } else {
       cmSystemTools::Error("Invalid format specified for --profiling-format");
       return;
     }
+    try {
+      this->ProfilingOutput =
+        cm::make_unique<cmMakefileProfilingData>(profilingOutput, format);
+    } catch (std::runtime_error& e) {
+      cmSystemTools::Error(cmStrCat("Could not start profiling: ", e.what()));
+      return;
+    }
+  }
+  if (!memoryProfilingOutput.empty()) {
+    try {
+      this->MemoryProfilingOutput =
+        cm::make_unique<cmMemoryProfilingData>(memoryProfilingOutput);
+    } catch (std::runtime_error& e) {
+      cmSystemTools::Error(
+        cmStrCat("Could not start memory profiling: ", e.what()));
+      return;
+    }
   }
 #endif
 
@@ -1635,10 +1668,28 @@ int cmake::ActualConfigure()
 #if !defined(CMAKE_BOOTSTRAP)
   this->FileAPI = cm::make_unique<cmFileAPI>(this);
   this->FileAPI->ReadQueries();
+
+  // Reuse list files parsed by a previous run.  A try_compile shares
+  // the cache of the project that started it.
+  std::string const listFileCachePath =
+    cmStrCat(this->GetHomeOutputDirectory(),
+             "/CMakeFiles/CMakeParsedListFiles.bin");
+  cmParsedListFileCache* listFileCache =
+    this->State->GetIsInTryCompile()
+    ? nullptr
+    : this->State->GetListFileCache().get();
+  if (listFileCache) {
+    listFileCache->Load(listFileCachePath);
+  }
 #endif
 
   // actually do the configure
   this->GlobalGenerator->Configure();
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->MemoryProfilingOutput) {
+    this->MemoryProfilingOutput->Report("configure", *this->GlobalGenerator);
+  }
+#endif
   // Before saving the cache
   // if the project did not define one of the entries below, add them now
   // so users can edit the values in the cache:
@@ -1676,6 +1727,11 @@ int cmake::ActualConfigure()
 
   this->State->SaveVerificationScript(this->GetHomeOutputDirectory());
   this->SaveCache(this->GetHomeOutputDirectory());
+#if !defined(CMAKE_BOOTSTRAP)
+  if (listFileCache) {
+    listFileCache->Save(listFileCachePath);
+  }
+#endif
   if (cmSystemTools::GetErrorOccuredFlag()) {
     return -1;
   }
@@ -1891,6 +1947,20 @@ int cmake::Generate()
     return -1;
   }
   this->GlobalGenerator->Generate();
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->ProfilingOutput) {
+    cmCompiledGeneratorExpression::CacheStatistics const stats =
+      cmCompiledGeneratorExpression::GetCacheStatistics();
+    this->ProfilingOutput->AddCounters(
+      "Generator expression evaluations",
+      { { "evaluations", stats.Evaluations },
+        { "cache hits", stats.Hits },
+        { "uncacheable", stats.Uncacheable } });
+  }
+  if (this->MemoryProfilingOutput) {
+    this->MemoryProfilingOutput->Report("generate", *this->GlobalGenerator);
+  }
+#endif
   if (!this->GraphVizFile.empty()) {
     std::cout << "Generate graphviz: " << this->GraphVizFile << std::endl;
     this->GenerateGraphViz(this->GraphVizFile);
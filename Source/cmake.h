@@ -39,6 +39,7 @@ class cmGlobalGeneratorFactory;
 class cmMakefile;
 #if !defined(CMAKE_BOOTSTRAP)
 class cmMakefileProfilingData;
+class cmMemoryProfilingData;
 #endif
 class cmMessenger;
 class cmVariableWatch;
@@ -657,6 +658,7 @@ private:
 
 #if !defined(CMAKE_BOOTSTRAP)
   std::unique_ptr<cmMakefileProfilingData> ProfilingOutput;
+  std::unique_ptr<cmMemoryProfilingData> MemoryProfilingOutput;
 #endif
 };
 
@@ -100,10 +100,13 @@ const char* cmDocumentationOptions[][2] = {
 #  if !defined(CMAKE_BOOTSTRAP)
   { "--profiling-format=<fmt>",
     "Output data for profiling CMake scripts. Supported formats: "
-    "google-trace" },
+    "google-trace, folded, summary" },
   { "--profiling-output=<file>",
     "Select an output path for the profiling data enabled through "
     "--profiling-format." },
+  { "--profiling-memory-output=<file>",
+    "Write an estimate of the memory held by directories, variable "
+    "scopes, targets and property maps after configure and generate." },
 #  endif
   { nullptr, nullptr }
 };
@@ -42,6 +42,10 @@ static const char* cmDocumentationOptions[][2] = {
   { "--test-output-size-failed <size>",
     "Limit the output for failed tests "
     "to <size> bytes" },
+  { "--test-output-stream",
+    "Keep only the start and end of the test output in memory" },
+  { "--test-output-log-dir <dir>",
+    "Write the full output of each test to a file in <dir>" },
   { "-F", "Enable failover." },
   { "-j <jobs>, --parallel <jobs>",
     "Run the tests in parallel using the "
@@ -137,6 +141,12 @@ static const char* cmDocumentationOptions[][2] = {
   { "--force-new-ctest-process",
     "Run child CTest instances as new processes" },
   { "--schedule-random", "Use a random order for scheduling tests" },
+  { "--schedule-critical-path",
+    "Start tests with the longest chain of dependent tests first" },
+  { "--shard-index <index>",
+    "Run only the tests of the given shard, counting from 0" },
+  { "--shard-count <count>",
+    "Split the tests into the given number of shards of similar cost" },
   { "--submit-index",
     "Submit individual dashboard tests with specific index" },
   { "--timeout <seconds>", "Set the default test timeout." },
@@ -0,0 +1,87 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <cstddef>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "cmBitSet.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return -1;                                                              \
+    }                                                                         \
+  } while (false)
+
+namespace {
+std::vector<std::size_t> elements(cmBitSet const& s)
+{
+  return std::vector<std::size_t>(s.begin(), s.end());
+}
+}
+
+int testBitSet(int /*unused*/, char* /*unused*/ [])
+{
+  cmBitSet empty;
+  ASSERT_TRUE(empty.empty());
+  ASSERT_TRUE(empty.size() == 0);
+  ASSERT_TRUE(empty.begin() == empty.end());
+  ASSERT_TRUE(!empty.contains(0));
+
+  cmBitSet a;
+  ASSERT_TRUE(a.insert(3));
+  ASSERT_TRUE(a.insert(64));
+  ASSERT_TRUE(a.insert(0));
+  ASSERT_TRUE(a.insert(200));
+  ASSERT_TRUE(!a.insert(64));
+  ASSERT_TRUE(!a.empty());
+  ASSERT_TRUE(a.size() == 4);
+  ASSERT_TRUE(a.contains(200));
+  ASSERT_TRUE(!a.contains(199));
+  ASSERT_TRUE(!a.contains(100000));
+  ASSERT_TRUE(elements(a) == (std::vector<std::size_t>{ 0, 3, 64, 200 }));
+
+  cmBitSet b;
+  b.insert(3);
+  b.insert(63);
+  b.insert(64);
+
+  cmBitSet u = a;
+  u |= b;
+  ASSERT_TRUE(elements(u) == (std::vector<std::size_t>{ 0, 3, 63, 64, 200 }));
+
+  // Intersections may leave trailing empty words behind.
+  cmBitSet i = a;
+  i &= b;
+  ASSERT_TRUE(elements(i) == (std::vector<std::size_t>{ 3, 64 }));
+  cmBitSet expect;
+  expect.insert(64);
+  expect.insert(3);
+  ASSERT_TRUE(i == expect);
+  cmBitSet i2 = b;
+  i2 &= a;
+  ASSERT_TRUE(i2 == expect);
+  ASSERT_TRUE(i != a);
+
+  // Compare against std::set for a pseudo-random sequence.
+  std::set<std::size_t> ref;
+  cmBitSet bits;
+  std::size_t x = 12345;
+  for (int n = 0; n < 1000; ++n) {
+    x = (x * 1103515245 + 12345) % 2147483648u;
+    std::size_t const v = x % 700;
+    ASSERT_TRUE(bits.insert(v) == ref.insert(v).second);
+  }
+  ASSERT_TRUE(bits.size() == ref.size());
+  ASSERT_TRUE(elements(bits) ==
+              std::vector<std::size_t>(ref.begin(), ref.end()));
+
+  bits.clear();
+  ASSERT_TRUE(bits.empty());
+  ASSERT_TRUE(bits == empty);
+
+  return 0;
+}
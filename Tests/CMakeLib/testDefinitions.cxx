@@ -0,0 +1,102 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmDefinitions.h"
+#include "cmLinkedTree.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+using Tree = cmLinkedTree<cmDefinitions>;
+
+static bool testSymbols()
+{
+  std::cout << "testSymbols()\n";
+  ASSERT_TRUE(cmDefinitions::Lookup("testSymbols_never_set") ==
+              cmDefinitions::NoSymbol);
+  cmDefinitions::Symbol a = cmDefinitions::Intern("testSymbols_a");
+  ASSERT_TRUE(a != cmDefinitions::NoSymbol);
+  ASSERT_TRUE(cmDefinitions::Intern("testSymbols_a") == a);
+  ASSERT_TRUE(cmDefinitions::Lookup("testSymbols_a") == a);
+  ASSERT_TRUE(cmDefinitions::Intern("testSymbols_b") != a);
+  ASSERT_TRUE(cmDefinitions::GetName(a) == "testSymbols_a");
+  return true;
+}
+
+static bool testScopes()
+{
+  std::cout << "testScopes()\n";
+  Tree tree;
+  Tree::iterator root = tree.Root();
+  Tree::iterator parent = tree.Push(root);
+  parent->Set("A", "parent");
+  parent->Set("B", "parent");
+  parent->Unset("C");
+  Tree::iterator child = tree.Push(parent);
+  child->Set("B", "child");
+  child->Set("C", "child");
+
+  std::string const* a = cmDefinitions::Get("A", child, root);
+  ASSERT_TRUE(a && *a == "parent");
+  std::string const* b = cmDefinitions::Get("B", child, root);
+  ASSERT_TRUE(b && *b == "child");
+  b = cmDefinitions::Get("B", parent, root);
+  ASSERT_TRUE(b && *b == "parent");
+  ASSERT_TRUE(!cmDefinitions::Get("C", parent, root));
+  ASSERT_TRUE(cmDefinitions::HasKey("C", parent, root));
+  ASSERT_TRUE(!cmDefinitions::HasKey("D", child, root));
+
+  // Raising copies the visible definition into the child scope.
+  cmDefinitions::Raise("A", child, root);
+  parent->Set("A", "changed");
+  a = cmDefinitions::Get("A", child, root);
+  ASSERT_TRUE(a && *a == "parent");
+
+  std::vector<std::string> keys = cmDefinitions::ClosureKeys(child, root);
+  std::sort(keys.begin(), keys.end());
+  ASSERT_TRUE((keys == std::vector<std::string>{ "A", "B", "C" }));
+
+  child->Unset("B");
+  keys = cmDefinitions::ClosureKeys(child, root);
+  std::sort(keys.begin(), keys.end());
+  ASSERT_TRUE((keys == std::vector<std::string>{ "A", "C" }));
+
+  // A closure drops unset entries and does not see later changes.
+  parent->Unset("E");
+  Tree closureTree;
+  Tree::iterator closure = closureTree.Push(closureTree.Root());
+  *closure = cmDefinitions::MakeClosure(child, root);
+  keys = cmDefinitions::ClosureKeys(closure, closureTree.Root());
+  std::sort(keys.begin(), keys.end());
+  ASSERT_TRUE((keys == std::vector<std::string>{ "A", "C" }));
+  ASSERT_TRUE(!cmDefinitions::HasKey("E", closure, closureTree.Root()));
+  ASSERT_TRUE(!cmDefinitions::HasKey("B", closure, closureTree.Root()));
+  child->Set("C", "changed");
+  closure->Set("A", "closure");
+  std::string const* c = cmDefinitions::Get("C", closure, closureTree.Root());
+  ASSERT_TRUE(c && *c == "child");
+  a = cmDefinitions::Get("A", child, root);
+  ASSERT_TRUE(a && *a == "parent");
+  return true;
+}
+
+int testDefinitions(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testSymbols()) {
+    return 1;
+  }
+  if (!testScopes()) {
+    return 1;
+  }
+  return 0;
+}
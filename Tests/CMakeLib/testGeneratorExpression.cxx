@@ -0,0 +1,87 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <cm/memory>
+
+#include "cmGeneratorExpression.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmState.h"
+#include "cmTarget.h"
+#include "cmake.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+// Evaluate a newly parsed expression, which cannot reuse an earlier result.
+std::string EvaluateUncached(std::string const& input, cmLocalGenerator* lg,
+                             cmGeneratorTarget const* head)
+{
+  cmGeneratorExpression ge;
+  return ge.Parse(input)->Evaluate(lg, "Debug", head);
+}
+
+bool testPropertyChange(cmLocalGenerator* lg, cmTarget* target,
+                        cmGeneratorTarget const* gt)
+{
+  std::cout << "testPropertyChange()\n";
+  for (std::string const input :
+       { "$<TARGET_PROPERTY:FOO>", "$<TARGET_PROPERTY:tgt,FOO>",
+         "$<GENEX_EVAL:$<TARGET_PROPERTY:FOO>>",
+         "$<TARGET_GENEX_EVAL:tgt,$<TARGET_PROPERTY:tgt,FOO>>" }) {
+    target->SetProperty("FOO", "before");
+    cmGeneratorExpression ge;
+    std::unique_ptr<cmCompiledGeneratorExpression> cge = ge.Parse(input);
+    // The second evaluation stores its result for the third one.
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(cge->Evaluate(lg, "Debug", gt) ==
+                  EvaluateUncached(input, lg, gt));
+    }
+    ASSERT_TRUE(cge->Evaluate(lg, "Debug", gt) == "before");
+
+    target->SetProperty("FOO", "after");
+    ASSERT_TRUE(cge->Evaluate(lg, "Debug", gt) ==
+                EvaluateUncached(input, lg, gt));
+    ASSERT_TRUE(cge->Evaluate(lg, "Debug", gt) == "after");
+
+    target->AppendProperty("FOO", "appended");
+    ASSERT_TRUE(cge->Evaluate(lg, "Debug", gt) ==
+                EvaluateUncached(input, lg, gt));
+    ASSERT_TRUE(cge->Evaluate(lg, "Debug", gt) == "after;appended");
+  }
+  return true;
+}
+}
+
+int testGeneratorExpression(int /*unused*/, char* /*unused*/ [])
+{
+  cmake cm(cmake::RoleInternal, cmState::Project);
+  cm.SetHomeDirectory("");
+  cm.SetHomeOutputDirectory("");
+  cm.GetCurrentSnapshot().SetDefaultDefinitions();
+  cmGlobalGenerator gg(&cm);
+  cmMakefile mf(&gg, cm.GetCurrentSnapshot());
+  std::unique_ptr<cmLocalGenerator> lg = gg.CreateLocalGenerator(&mf);
+  cmTarget* target = mf.AddNewUtilityTarget("tgt", false);
+  auto gt = cm::make_unique<cmGeneratorTarget>(target, lg.get());
+  cmGeneratorTarget const* head = gt.get();
+  lg->AddGeneratorTarget(std::move(gt));
+
+  if (!testPropertyChange(lg.get(), target, head)) {
+    return 1;
+  }
+  return 0;
+}
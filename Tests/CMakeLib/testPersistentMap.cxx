@@ -0,0 +1,117 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "cmPersistentMap.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+using Map = cmPersistentMap<int>;
+
+static std::vector<std::pair<std::uint32_t, int>> Entries(Map const& map)
+{
+  std::vector<std::pair<std::uint32_t, int>> entries;
+  map.ForEach([&entries](std::uint32_t key, int value) {
+    entries.emplace_back(key, value);
+  });
+  return entries;
+}
+
+static bool testSetFind()
+{
+  std::cout << "testSetFind()\n";
+  Map map;
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_TRUE(!map.Find(0));
+  map.Set(3, 30);
+  map.Set(1000, 10000);
+  map.Set(0xFFFFFFFEu, 7);
+  map.Set(3, 31);
+  ASSERT_TRUE(map.GetSize() == 3);
+  ASSERT_TRUE(map.Find(3) && *map.Find(3) == 31);
+  ASSERT_TRUE(map.Find(1000) && *map.Find(1000) == 10000);
+  ASSERT_TRUE(map.Find(0xFFFFFFFEu) && *map.Find(0xFFFFFFFEu) == 7);
+  ASSERT_TRUE(!map.Find(4));
+  ASSERT_TRUE(!map.Find(0xFFFFFFFFu));
+  ASSERT_TRUE((Entries(map) ==
+               std::vector<std::pair<std::uint32_t, int>>{
+                 { 3, 31 }, { 1000, 10000 }, { 0xFFFFFFFEu, 7 } }));
+  return true;
+}
+
+static bool testSharing()
+{
+  std::cout << "testSharing()\n";
+  Map original;
+  for (std::uint32_t i = 1; i <= 2000; ++i) {
+    original.Set(i, int(i));
+  }
+  Map copy = original;
+  copy.Set(5, -5);
+  copy.Set(5000, 5000);
+  ASSERT_TRUE(*original.Find(5) == 5);
+  ASSERT_TRUE(!original.Find(5000));
+  ASSERT_TRUE(*copy.Find(5) == -5);
+  ASSERT_TRUE(*copy.Find(1999) == 1999);
+  ASSERT_TRUE(original.GetSize() == 2000);
+  ASSERT_TRUE(copy.GetSize() == 2001);
+
+  original.Set(6, -6);
+  ASSERT_TRUE(*copy.Find(6) == 6);
+  return true;
+}
+
+static bool testTombstones()
+{
+  std::cout << "testTombstones()\n";
+  Map map;
+  for (std::uint32_t i = 1; i <= 100; ++i) {
+    map.Set(i, int(i));
+  }
+  // Zero values are tombstones.
+  map.Set(10, 0);
+  map.Set(70, 0);
+  map.Set(200, 0);
+  map.Set(70, 70);
+  Map const before = map;
+  map.EraseTombstones();
+  ASSERT_TRUE(map.GetSize() == 99);
+  ASSERT_TRUE(!map.Find(10));
+  ASSERT_TRUE(!map.Find(200));
+  ASSERT_TRUE(map.Find(70) && *map.Find(70) == 70);
+  ASSERT_TRUE(before.GetSize() == 101);
+  ASSERT_TRUE(before.Find(10) && *before.Find(10) == 0);
+
+  Map empty;
+  empty.Set(1, 0);
+  empty.EraseTombstones();
+  ASSERT_TRUE(empty.IsEmpty());
+  ASSERT_TRUE(!empty.Find(1));
+  empty.Set(1, 1);
+  ASSERT_TRUE(empty.Find(1) && *empty.Find(1) == 1);
+  return true;
+}
+
+int testPersistentMap(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testSetFind()) {
+    return 1;
+  }
+  if (!testSharing()) {
+    return 1;
+  }
+  if (!testTombstones()) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,25 @@
+# The header must be known from the depfile written by the compiler,
+# not from the C dependency scanner.  Depfiles are merged by the next
+# build, so compiler_depend.make lists it only after the first one.
+file(READ "${check_compiler_depends}/depend.make" depend_make)
+if(depend_make MATCHES "MakeDependsCompiler\\.h")
+  string(APPEND RunCMake_TEST_FAILED "
+ depend.make lists MakeDependsCompiler.h, so the scanner was used:
+${depend_make}
+")
+endif()
+set(compiler_depend_make "${check_compiler_depends}/compiler_depend.make")
+if(NOT EXISTS "${compiler_depend_make}")
+  string(APPEND RunCMake_TEST_FAILED "
+ '${compiler_depend_make}' missing
+")
+  return()
+endif()
+file(READ "${compiler_depend_make}" compiler_depends)
+if(check_step EQUAL 2 AND
+    NOT compiler_depends MATCHES "MakeDependsCompiler\\.h")
+  string(APPEND RunCMake_TEST_FAILED "
+ compiler_depend.make does not list MakeDependsCompiler.h:
+${compiler_depends}
+")
+endif()
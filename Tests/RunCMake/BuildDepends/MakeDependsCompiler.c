@@ -0,0 +1,6 @@
+#include "MakeDependsCompiler.h"
+
+int main(void)
+{
+  return MAKE_DEPENDS_COMPILER;
+}
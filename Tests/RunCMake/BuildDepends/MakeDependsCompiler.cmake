@@ -0,0 +1,23 @@
+enable_language(C)
+
+set(CMAKE_DEPENDS_USE_COMPILER ON)
+
+add_executable(main ${CMAKE_CURRENT_SOURCE_DIR}/MakeDependsCompiler.c)
+target_include_directories(main PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+
+# Compilers without depfile support still use the C scanner.
+if(CMAKE_DEPFILE_FLAGS_C AND NOT CMAKE_NINJA_DEPTYPE_C MATCHES "^(msvc|intel)$")
+  set(check_scanner "
+set(check_compiler_depends \"${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/main.dir\")
+include(\"${CMAKE_CURRENT_SOURCE_DIR}/MakeDependsCompiler-check-scanner.cmake\")
+")
+endif()
+
+file(GENERATE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:main>|${CMAKE_CURRENT_BINARY_DIR}/MakeDependsCompiler.h\"
+  )
+set(check_exes
+  \"$<TARGET_FILE:main>\"
+  )
+${check_scanner}")
@@ -0,0 +1,11 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeDependsCompilerDeleted.h" [[
+#define MAKE_DEPENDS_COMPILER_DELETED 1
+]])
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeDependsCompilerDeleted.c" [[
+#include "MakeDependsCompilerDeleted.h"
+
+int main(void)
+{
+  return MAKE_DEPENDS_COMPILER_DELETED;
+}
+]])
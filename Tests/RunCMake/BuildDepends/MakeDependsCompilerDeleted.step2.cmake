@@ -0,0 +1,9 @@
+# The object still depends on the header from the last build.  Removing
+# the header along with its include must not break the build.
+file(REMOVE "${RunCMake_TEST_BINARY_DIR}/MakeDependsCompilerDeleted.h")
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeDependsCompilerDeleted.c" [[
+int main(void)
+{
+  return 2;
+}
+]])
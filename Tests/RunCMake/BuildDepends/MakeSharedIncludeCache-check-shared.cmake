@@ -0,0 +1,22 @@
+# Only main2, which is scanned after the marker was added to the shared
+# include cache, lists the marker header.
+if(check_step EQUAL 1)
+  foreach(t main1 main2)
+    file(READ "${check_dir}/CMakeFiles/${t}.dir/depend.make" depend_make)
+    if(depend_make MATCHES "MakeSharedIncludeCacheMarker\\.h")
+      set(listed 1)
+    else()
+      set(listed 0)
+    endif()
+    if(t STREQUAL "main1" AND listed)
+      string(APPEND RunCMake_TEST_FAILED "
+ main1 lists the marker header before it was added to the shared cache
+")
+    elseif(t STREQUAL "main2" AND NOT listed)
+      string(APPEND RunCMake_TEST_FAILED "
+ main2 was not served from the shared include cache:
+${depend_make}
+")
+    endif()
+  endforeach()
+endif()
@@ -0,0 +1,12 @@
+# Add an include line to the shared include cache entry of a header so
+# that only a target served from the cache depends on the marker header.
+# An entry starts with the file name and its modification time.
+file(GLOB cache_files "${dir}/CMakeFiles/CMakeIncludeCache/*.includecache")
+foreach(cache_file IN LISTS cache_files)
+  file(READ "${cache_file}" cache)
+  if(NOT cache MATCHES "MakeSharedIncludeCacheMarker")
+    string(REGEX REPLACE "(\n[^\n]*MakeSharedIncludeCache\\.h\n[0-9]+\n)"
+      "\\1MakeSharedIncludeCacheMarker.h\n-\n" cache "${cache}")
+    file(WRITE "${cache_file}" "${cache}")
+  endif()
+endforeach()
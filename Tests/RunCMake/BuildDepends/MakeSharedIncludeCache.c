@@ -0,0 +1,6 @@
+#include "MakeSharedIncludeCache.h"
+
+int main(void)
+{
+  return MAKE_SHARED_INCLUDE_CACHE;
+}
@@ -0,0 +1,29 @@
+enable_language(C)
+
+# Both targets include the same headers, so the second target scanned
+# finds them in the include cache shared by the build tree.
+add_executable(main1 ${CMAKE_CURRENT_SOURCE_DIR}/MakeSharedIncludeCache.c)
+add_executable(main2 ${CMAKE_CURRENT_SOURCE_DIR}/MakeSharedIncludeCache.c)
+# Mark the shared cache between the scans of the two targets.
+add_custom_target(mark
+  COMMAND ${CMAKE_COMMAND} -Ddir=${CMAKE_CURRENT_BINARY_DIR}
+          -P ${CMAKE_CURRENT_SOURCE_DIR}/MakeSharedIncludeCache-mark.cmake
+  )
+add_dependencies(mark main1)
+add_dependencies(main2 mark)
+foreach(t main1 main2)
+  target_include_directories(${t} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+endforeach()
+
+file(GENERATE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:main1>|${CMAKE_CURRENT_BINARY_DIR}/MakeSharedIncludeCache2.h\"
+  \"$<TARGET_FILE:main2>|${CMAKE_CURRENT_BINARY_DIR}/MakeSharedIncludeCache2.h\"
+  )
+set(check_exes
+  \"$<TARGET_FILE:main1>\"
+  \"$<TARGET_FILE:main2>\"
+  )
+set(check_dir \"${CMAKE_CURRENT_BINARY_DIR}\")
+include(\"${CMAKE_CURRENT_SOURCE_DIR}/MakeSharedIncludeCache-check-shared.cmake\")
+")
@@ -0,0 +1,7 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeSharedIncludeCache.h" [[
+#include "MakeSharedIncludeCache2.h"
+]])
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeSharedIncludeCache2.h" [[
+#define MAKE_SHARED_INCLUDE_CACHE 1
+]])
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeSharedIncludeCacheMarker.h" "")
@@ -0,0 +1,3 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeSharedIncludeCache2.h" [[
+#define MAKE_SHARED_INCLUDE_CACHE 2
+]])
@@ -65,6 +65,9 @@ unset(RunCMake_TEST_SOURCE_DIR)
 
 if(RunCMake_GENERATOR MATCHES "Make")
   run_BuildDepends(MakeCustomIncludes)
+  run_BuildDepends(MakeDependsCompiler)
+  run_BuildDepends(MakeDependsCompilerDeleted)
+  run_BuildDepends(MakeSharedIncludeCache)
   if(NOT "${RunCMake_BINARY_DIR}" STREQUAL "${RunCMake_SOURCE_DIR}")
     run_BuildDepends(MakeInProjectOnly)
   endif()
@@ -0,0 +1,2 @@
+cmake_policy(SET CMP0053 NEW)
+include(ExpandCommon.cmake)
@@ -0,0 +1,3 @@
+cmake_policy(SET CMP0053 NEW)
+set(v "v")
+set(out "a\x${v}")
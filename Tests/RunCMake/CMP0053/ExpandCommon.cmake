@@ -0,0 +1,76 @@
+# Expansion cases shared by the Expand-OLD and Expand-NEW tests.  The
+# expected OLD results are those of the generated parser, which the
+# hand-written expander must reproduce.
+cmake_policy(GET CMP0053 policy)
+
+set(x "X")
+set(name "x")
+set(q [[a"b]])
+set(v "v")
+set(ENV{CMP0053_EXPAND_ENV} "E")
+set(cv "C" CACHE INTERNAL "")
+string(ASCII 9 tab)
+string(ASCII 10 lf)
+
+# Expand <input> as a quoted command argument and compare the result to
+# <expect-OLD> or, if given, <expect-NEW> under the NEW behavior.
+function(check_arg input expect)
+  if(policy STREQUAL "NEW" AND ARGC GREATER 2)
+    set(expect "${ARGV2}")
+  endif()
+  string(CONCAT code [=[set(out "]=] "${input}" [=[")]=])
+  cmake_language(EVAL CODE "${code}")
+  if(NOT out STREQUAL expect)
+    message(SEND_ERROR
+      "Argument\n  ${input}\nexpanded to\n  ${out}\nbut expected\n  ${expect}")
+  endif()
+endfunction()
+
+# Expand <input> with string(CONFIGURE) and the given options.
+function(check_configure input expect)
+  string(CONFIGURE "${input}" out ${ARGN})
+  if(NOT out STREQUAL expect)
+    message(SEND_ERROR "string(CONFIGURE ${ARGN})\n  ${input}\n"
+      "expanded to\n  ${out}\nbut expected\n  ${expect}")
+  endif()
+endfunction()
+
+# Escape sequences.
+check_arg([[\${x}]] [[${x}]])
+check_arg([[a\;b]] [[a\;b]])
+check_arg([[\@x@]] [[@x@]])
+string(CONCAT expect "${tab}|${lf}|" [[\|"| |#|(|)|$|^]])
+check_arg([[\t|\n|\\|\"|\ |\#|\(|\)|\$|\^]] "${expect}")
+if(policy STREQUAL "OLD")
+  check_arg([[\@|\0|x]] [[@||x]])
+endif()
+
+# References.
+check_arg([[${${name}}]] [[X]])
+check_arg([[<${undefined}>]] [[<>]])
+check_arg([[${q}]] [[a"b]])
+check_arg([[$CACHE{cv}]] [[C]])
+check_arg([[$ENV{CMP0053_EXPAND_ENV}/$ENV{}]] [[E/]])
+check_arg([[$ENV{CMP0053_EXPAND_${name}}]] [[]])
+check_arg([[a$b {} @ x@y @@ $]] [[a$b {} @ x@y @@ $]])
+check_arg([[@x@]] [[X]] [[@x@]])
+check_arg([[${x}@x@${name}]] [[XXx]] [[X@x@x]])
+
+# Nesting deeper than the hand-written expander handles itself.
+string(REPEAT [[${]] 1100 open)
+string(REPEAT "}" 1100 close)
+check_arg("${open}v${close}" [[v]])
+
+# string(CONFIGURE) does not process escape sequences.
+set(input [[${x} @x@ \${x} $ENV{CMP0053_EXPAND_ENV} <${undefined}> \n \;]])
+check_configure("${input}" [[X X \X E <> \n \;]])
+check_configure("${input}" [[X X \X E <> \n \;]] ESCAPE_QUOTES)
+check_configure("${input}"
+  [[${x} X \${x} $ENV{CMP0053_EXPAND_ENV} <${undefined}> \n \;]] @ONLY)
+check_configure([[${q} @q@]] [[a"b a"b]])
+check_configure([[${q} @q@]] [[${q} a"b]] @ONLY)
+check_configure([[${q} @q@]] [[a\"b a\"b]] ESCAPE_QUOTES)
+check_configure([[@x @ @@ @x@@x@]] [[@x @ @@ XX]])
+check_configure([[@x @ @@ @x@@x@]] [[@x @ @@ XX]] @ONLY)
+check_configure([[x\]] [[x\]])
+check_configure([[a\b${x}]] [[a\bX]])
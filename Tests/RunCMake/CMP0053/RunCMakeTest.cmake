@@ -3,3 +3,10 @@ include(RunCMake)
 run_cmake(CMP0053-OLD)
 run_cmake(CMP0053-NEW)
 run_cmake(CMP0053-WARN)
+
+run_cmake(Expand-OLD)
+run_cmake(Expand-NEW)
+run_cmake(ExpandUnterminated-OLD)
+run_cmake(ExpandUnterminated-NEW)
+run_cmake(ExpandBadEscape-OLD)
+run_cmake(ExpandBadEscape-NEW)
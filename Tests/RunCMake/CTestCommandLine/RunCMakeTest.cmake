@@ -222,8 +222,74 @@ run_TestLoad(test-load-invalid 'two')
 # our threshold.
 run_TestLoad(test-load-pass 10)
 
+# Verify that no wait is reported when the only tests left depend on
+# a running one.
+function(run_TestLoadDepends)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestLoadDepends)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(t1 \"${CMAKE_COMMAND}\" -E sleep 2)
+  add_test(t2 \"${CMAKE_COMMAND}\" -E echo t2)
+  add_test(t3 \"${CMAKE_COMMAND}\" -E echo t3)
+  set_tests_properties(t3 PROPERTIES DEPENDS t1)
+")
+  run_cmake_command(test-load-depends ${CMAKE_CTEST_COMMAND} -j4 --test-load 1000)
+endfunction()
+run_TestLoadDepends()
+
 unset(ENV{__CTEST_FAKE_LOAD_AVERAGE_FOR_TESTING})
 
+# Tests for the --schedule-critical-path feature of ctest
+function(run_ScheduleCriticalPath name)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${name})
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  # A long chain of cheap tests and a short chain ending in an expensive
+  # test.  Every test takes both slots, so the tests run one at a time.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  foreach(t p1 p2 p3 q1 q2)
+    add_test(\${t} \"${CMAKE_COMMAND}\" -E echo \${t})
+    set_tests_properties(\${t} PROPERTIES COST 1 PROCESSORS 2)
+  endforeach()
+  set_tests_properties(p2 PROPERTIES DEPENDS p1)
+  set_tests_properties(p3 PROPERTIES DEPENDS p2)
+  set_tests_properties(q2 PROPERTIES DEPENDS q1 COST 100)
+")
+  run_cmake_command(${name} ${CMAKE_CTEST_COMMAND} -j2 ${ARGN})
+endfunction()
+run_ScheduleCriticalPath(schedule-default)
+run_ScheduleCriticalPath(schedule-critical-path --schedule-critical-path)
+
+# Tests for the --shard-index and --shard-count options of ctest
+function(run_Shard name)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Shard)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  # Tests c and d depend on each other and t1 and t2 require the setup
+  # test s.  The shards get a, t1 and b, c, d, t2, and both get s.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  foreach(t a b c d s t1 t2)
+    add_test(\${t} \"${CMAKE_COMMAND}\" -E echo \${t})
+  endforeach()
+  set_tests_properties(a PROPERTIES COST 10)
+  set_tests_properties(b PROPERTIES COST 6)
+  set_tests_properties(c PROPERTIES COST 5)
+  set_tests_properties(d PROPERTIES COST 1 DEPENDS c)
+  set_tests_properties(s PROPERTIES FIXTURES_SETUP db)
+  set_tests_properties(t1 t2 PROPERTIES COST 3 FIXTURES_REQUIRED db)
+")
+  run_cmake_command(${name} ${CMAKE_CTEST_COMMAND} -N ${ARGN})
+endfunction()
+run_Shard(shard-0 --shard-index 0 --shard-count 2)
+run_Shard(shard-1 --shard-index 1 --shard-count 2)
+run_Shard(shard-bad-index --shard-index 2 --shard-count 2)
+run_Shard(shard-no-count --shard-index 0)
+run_Shard(shard-rerun-failed --shard-index 0 --shard-count 2 --rerun-failed)
+
 function(run_TestOutputSize)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestOutputSize)
   set(RunCMake_TEST_NO_CLEAN 1)
@@ -242,6 +308,52 @@ function(run_TestOutputSize)
 endfunction()
 run_TestOutputSize()
 
+function(run_TestOutputStream name)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${name})
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  # The first line ends in a carriage return, which only the log keeps.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/lines.cmake" "
+  string(ASCII 13 cr)
+  message(\"line 1\${cr}\")
+  foreach(i RANGE 2 100)
+    message(\"line \${i}\")
+  endforeach()
+  message(\"\${LAST}\")
+")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(PassingTest \"${CMAKE_COMMAND}\" -DLAST=done -P lines.cmake)
+  set_tests_properties(PassingTest PROPERTIES
+    PASS_REGULAR_EXPRESSION \"^done\")
+  add_test(FailingTest \"${CMAKE_COMMAND}\" -DLAST=bad -P lines.cmake)
+  set_tests_properties(FailingTest PROPERTIES
+    FAIL_REGULAR_EXPRESSION \"^bad\")
+")
+  run_cmake_command(${name}
+    ${CMAKE_CTEST_COMMAND} -M Experimental -T Test
+                           --no-compress-output
+                           --test-output-stream
+                           ${ARGN}
+    )
+endfunction()
+run_TestOutputStream(TestOutputStream
+  --test-output-log-dir logs
+  --test-output-size-passed 40
+  --test-output-size-failed 60
+  )
+# A limit of zero keeps the whole output of its outcome.
+run_TestOutputStream(TestOutputStreamUnlimited
+  --test-output-size-passed 0
+  --test-output-size-failed 60
+  )
+# Output that fits the larger limit still keeps its end within the
+# smaller one.
+run_TestOutputStream(TestOutputStreamShort
+  --test-output-size-passed 40
+  --test-output-size-failed 100000
+  )
+
 # Test --stop-on-failure
 function(run_stop_on_failure)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/stop-on-failure)
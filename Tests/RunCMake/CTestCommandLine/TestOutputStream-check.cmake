@@ -0,0 +1,33 @@
+include("${CMAKE_CURRENT_LIST_DIR}/TestOutputStream-common.cmake")
+if(RunCMake_TEST_FAILED)
+  # The Test.xml file was not found or did not parse.
+elseif(NOT "${test_passed}" MATCHES [[<Value>line 1
+line 2
+.*threshold of 40 bytes.*
+done
+</Value>]])
+  set(RunCMake_TEST_FAILED "Test.xml passed test output does not keep its start and end:\n ${test_passed}")
+elseif(NOT "${test_failed}" MATCHES [[<Value>line 1
+line 2
+.*threshold of 60 bytes.*line 100
+bad
+</Value>]])
+  set(RunCMake_TEST_FAILED "Test.xml failed test output does not keep its start and end:\n ${test_failed}")
+endif()
+
+foreach(t 1-PassingTest 2-FailingTest)
+  set(log "${RunCMake_TEST_BINARY_DIR}/logs/${t}.log")
+  if(NOT EXISTS "${log}")
+    string(APPEND RunCMake_TEST_FAILED "\n${log} not found")
+  else()
+    file(READ "${log}" log_content)
+    if(NOT log_content MATCHES "^line 1\nline 2\n.*\nline 50\n.*\nline 100\n")
+      string(APPEND RunCMake_TEST_FAILED "\n${log} does not have the full output:\n${log_content}")
+    endif()
+    # The first line ends in "\r\n" as written by the test.
+    file(READ "${log}" log_start LIMIT 8 HEX)
+    if(NOT log_start STREQUAL "6c696e6520310d0a")
+      string(APPEND RunCMake_TEST_FAILED "\n${log} does not start with the raw output:\n${log_start}")
+    endif()
+  endif()
+endforeach()
@@ -0,0 +1,16 @@
+include("${CMAKE_CURRENT_LIST_DIR}/TestOutputStream-common.cmake")
+if(RunCMake_TEST_FAILED)
+  # The Test.xml file was not found or did not parse.
+elseif(NOT "${test_passed}" MATCHES [[<Value>line 1
+.*threshold of 40 bytes.*
+done
+</Value>]])
+  set(RunCMake_TEST_FAILED "Test.xml passed test output does not keep its start and end:\n ${test_passed}")
+elseif(NOT "${test_failed}" MATCHES [[<Value>line 1
+line 2
+(line [0-9]+
+)*line 100
+bad
+</Value>]])
+  set(RunCMake_TEST_FAILED "Test.xml failed test output is not complete:\n ${test_failed}")
+endif()
@@ -0,0 +1,3 @@
+if(actual_stdout MATCHES "WAITING")
+  set(RunCMake_TEST_FAILED "ctest waited for the load with no ready test")
+endif()
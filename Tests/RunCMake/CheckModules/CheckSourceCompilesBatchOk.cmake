@@ -0,0 +1,28 @@
+enable_language(C)
+include(CheckSourceCompilesBatch)
+
+set(CMAKE_REQUIRED_DEFINITIONS -DREQUIRED_DEF)
+check_source_compiles_batch(C
+  HAVE_MAIN "int main(void) { return 0; }"
+  HAVE_DEF "#ifndef REQUIRED_DEF
+#error no definition
+#endif
+int main(void) { return 0; }"
+  HAVE_ERROR "#error unsupported
+int main(void) { return 0; }"
+  )
+unset(CMAKE_REQUIRED_DEFINITIONS)
+
+if(NOT HAVE_MAIN OR NOT HAVE_DEF)
+  message(SEND_ERROR "check_source_compiles_batch failed a valid check")
+endif()
+if(HAVE_ERROR)
+  message(SEND_ERROR "check_source_compiles_batch passed an invalid check")
+endif()
+
+# Checks with a cached result are not repeated.
+set(HAVE_ERROR 1 CACHE INTERNAL "")
+check_source_compiles_batch(C HAVE_ERROR "#error unsupported")
+if(NOT HAVE_ERROR)
+  message(SEND_ERROR "check_source_compiles_batch repeated a cached check")
+endif()
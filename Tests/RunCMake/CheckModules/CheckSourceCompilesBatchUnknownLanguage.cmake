@@ -0,0 +1,2 @@
+include(CheckSourceCompilesBatch)
+check_source_compiles_batch(FOOBAR HAVE_MAIN "int main() { return 0; }")
@@ -22,3 +22,6 @@ run_cmake(CheckIncludeFilesOkNoC)
 run_cmake(CheckIncludeFilesMissingLanguage)
 run_cmake(CheckIncludeFilesUnknownArgument)
 run_cmake(CheckIncludeFilesUnknownLanguage)
+
+run_cmake(CheckSourceCompilesBatchOk)
+run_cmake(CheckSourceCompilesBatchUnknownLanguage)
@@ -0,0 +1,12 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+file(STRINGS ${ProfilingTestOutput} stacks
+  REGEX [[;__testing_outer \([^)]*ProfilingFolded.cmake:9\);__testing_inner \([^)]*:5\) [0-9]+$]])
+list(LENGTH stacks numStacks)
+if (NOT numStacks EQUAL 1)
+  set(RunCMake_TEST_FAILED
+      "Expected one folded stack for __testing_inner, found ${numStacks}")
+endif()
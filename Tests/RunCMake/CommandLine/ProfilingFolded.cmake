@@ -0,0 +1,9 @@
+function(__testing_inner)
+endfunction()
+function(__testing_outer)
+  foreach(i RANGE 100)
+    __testing_inner()
+  endforeach()
+endfunction()
+
+__TESTING_OUTER()
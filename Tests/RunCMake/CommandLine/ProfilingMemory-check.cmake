@@ -0,0 +1,23 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+file(STRINGS ${ProfilingTestOutput} steps REGEX "^Memory after ")
+if (NOT steps STREQUAL "Memory after configure;Memory after generate")
+  set(RunCMake_TEST_FAILED "Unexpected reports: ${steps}")
+  return()
+endif()
+
+file(STRINGS ${ProfilingTestOutput} targets
+  REGEX "^ +[1-9][0-9]* +[1-9][0-9]* +[0-9]+  __testing_target \\(")
+list(LENGTH targets numTargets)
+if (NOT numTargets EQUAL 2)
+  set(RunCMake_TEST_FAILED
+      "Expected a row for __testing_target in each report")
+  return()
+endif()
+list(GET targets 1 generated)
+if (NOT generated MATCHES "^ +[0-9]+ +[0-9]+ +[1-9][0-9]*  ")
+  set(RunCMake_TEST_FAILED "Expected the generator target after generate")
+endif()
@@ -0,0 +1,3 @@
+set(__testing_variable "value")
+add_custom_target(__testing_target)
+set_property(TARGET __testing_target PROPERTY __TESTING_PROPERTY value)
@@ -0,0 +1,26 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+file(STRINGS ${ProfilingTestOutput} inner
+  REGEX [[^ +101 +[0-9.]+ +[0-9.]+  __testing_inner$]])
+list(LENGTH inner numInner)
+if (NOT numInner EQUAL 1)
+  set(RunCMake_TEST_FAILED "Expected a row for 101 calls of __testing_inner")
+  return()
+endif()
+
+file(STRINGS ${ProfilingTestOutput} file
+  REGEX [[^ +[0-9]+ +[0-9.]+ +[0-9.]+  .*/ProfilingSummary.cmake$]])
+if (NOT file)
+  set(RunCMake_TEST_FAILED "Expected a row for ProfilingSummary.cmake")
+endif()
+
+file(STRINGS ${ProfilingTestOutput} genex
+  REGEX [[^ +[0-9]+  (evaluations|cache hits|uncacheable)$]])
+list(LENGTH genex numGenex)
+if (NOT numGenex EQUAL 3)
+  set(RunCMake_TEST_FAILED
+    "Expected generator expression evaluation counters")
+endif()
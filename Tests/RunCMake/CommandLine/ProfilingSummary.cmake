@@ -0,0 +1,11 @@
+function(__testing_inner)
+endfunction()
+function(__testing_outer)
+  foreach(i RANGE 100)
+    __testing_inner()
+  endforeach()
+endfunction()
+
+__TESTING_OUTER()
+
+add_custom_target(__testing_genex COMMAND ${CMAKE_COMMAND} -E echo $<CONFIG>)
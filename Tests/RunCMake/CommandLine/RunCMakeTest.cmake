@@ -817,8 +817,30 @@ set(RunCMake_TEST_OPTIONS --profiling-format=google-trace)
 run_cmake(profiling-missing-output)
 unset(RunCMake_TEST_OPTIONS)
 
+set(RunCMake_TEST_OPTIONS --profiling-memory-output)
+run_cmake(profiling-memory-missing-output)
+unset(RunCMake_TEST_OPTIONS)
+
 set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/profiling-test")
 set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output.json)
 set(RunCMake_TEST_OPTIONS --profiling-format=google-trace --profiling-output=${ProfilingTestOutput})
 run_cmake(ProfilingTest)
 unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/profiling-folded")
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output.txt)
+set(RunCMake_TEST_OPTIONS --profiling-format=folded --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingFolded)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/profiling-summary")
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output.txt)
+set(RunCMake_TEST_OPTIONS --profiling-format=summary --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingSummary)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/profiling-memory")
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/memory.txt)
+set(RunCMake_TEST_OPTIONS --profiling-memory-output=${ProfilingTestOutput})
+run_cmake(ProfilingMemory)
+unset(RunCMake_TEST_OPTIONS)
@@ -0,0 +1,3 @@
+if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/CMakeParsedListFiles.bin")
+  set(RunCMake_TEST_FAILED "Parsed list file cache was not written.")
+endif()
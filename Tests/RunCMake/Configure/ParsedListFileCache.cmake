@@ -0,0 +1,2 @@
+include(${CMAKE_CURRENT_BINARY_DIR}/Included.cmake)
+include(${CMAKE_CURRENT_BINARY_DIR}/Included.cmake)
@@ -51,6 +51,21 @@ run_cmake(RemoveCache)
 file(REMOVE "${RunCMake_TEST_BINARY_DIR}/CMakeCache.txt")
 run_cmake(RemoveCache)
 
+# Use a single build tree to check that cached list files are re-read
+# when their content changes, even without a size or timestamp change.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ParsedListFileCache-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/Included.cmake"
+  "message(STATUS \"Included: 1\")\n")
+run_cmake(ParsedListFileCache)
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/Included.cmake"
+  "message(STATUS \"Included: 2\")\n")
+run_cmake_command(ParsedListFileCache-rerun ${CMAKE_COMMAND} .)
+unset(RunCMake_TEST_BINARY_DIR)
+unset(RunCMake_TEST_NO_CLEAN)
+
 if(NOT RunCMake_GENERATOR MATCHES "^Ninja Multi-Config$")
   run_cmake(NoCMAKE_CROSS_CONFIGS)
   run_cmake(NoCMAKE_DEFAULT_BUILD_TYPE)
@@ -0,0 +1,16 @@
+function(check_marked marked unmarked)
+  foreach(t ${marked} ${unmarked})
+    file(READ "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${t}.dir/build.make"
+      content)
+    string(FIND "${content}" "# marked" pos)
+    list(FIND marked "${t}" expect)
+    if(NOT expect EQUAL -1 AND pos EQUAL -1)
+      string(APPEND RunCMake_TEST_FAILED
+        "Rule files of target ${t} were unexpectedly rewritten.\n")
+    elseif(expect EQUAL -1 AND NOT pos EQUAL -1)
+      string(APPEND RunCMake_TEST_FAILED
+        "Rule files of target ${t} were unexpectedly reused.\n")
+    endif()
+  endforeach()
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}" PARENT_SCOPE)
+endfunction()
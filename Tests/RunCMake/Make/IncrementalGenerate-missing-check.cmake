@@ -0,0 +1,5 @@
+include(${CMAKE_CURRENT_LIST_DIR}/IncrementalGenerate-common.cmake)
+check_marked("a;b" "c")
+if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/c.dir/flags.make")
+  string(APPEND RunCMake_TEST_FAILED "Rule file c.dir/flags.make was not written.\n")
+endif()
@@ -0,0 +1,2 @@
+include(${CMAKE_CURRENT_LIST_DIR}/IncrementalGenerate-common.cmake)
+check_marked("" "a;b;c")
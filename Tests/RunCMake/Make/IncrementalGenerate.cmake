@@ -0,0 +1,7 @@
+include("${CMAKE_BINARY_DIR}/pol.cmake" NO_POLICY_SCOPE)
+enable_language(C)
+add_library(a STATIC hello.c)
+include("${CMAKE_BINARY_DIR}/a.cmake")
+add_executable(b hello.c)
+target_link_libraries(b a)
+add_library(c STATIC hello.c)
@@ -0,0 +1,4 @@
+if(EXISTS "${RunCMake_TEST_BINARY_DIR}/d.txt")
+  string(APPEND RunCMake_TEST_FAILED
+    "The output of the edited custom command was not removed.\n")
+endif()
@@ -0,0 +1,17 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/d.dir/build.make" content)
+if(NOT content MATCHES "# marked")
+  string(APPEND RunCMake_TEST_FAILED
+    "Rule files of target d were unexpectedly rewritten.\n")
+endif()
+
+# The hash of a reused rule is kept although its output was never built.
+set(hashes_file "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/CMakeRuleHashes.txt")
+if(EXISTS "${hashes_file}")
+  file(READ "${hashes_file}" hashes)
+else()
+  set(hashes "")
+endif()
+if(NOT hashes MATCHES "[0-9a-f]+ d\\.txt\n")
+  string(APPEND RunCMake_TEST_FAILED
+    "CMakeRuleHashes.txt does not list d.txt:\n${hashes}")
+endif()
@@ -0,0 +1,4 @@
+include("${CMAKE_BINARY_DIR}/d.cmake")
+add_custom_command(OUTPUT d.txt
+  COMMAND ${CMAKE_COMMAND} -E echo ${d_text} > d.txt)
+add_custom_target(d ALL DEPENDS d.txt)
@@ -0,0 +1,41 @@
+set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles")
+
+# Every library reached through the diamond or the cycle is seen
+# exactly once, and its include directory is marked as a system one.
+file(STRINGS "${dir}/top.dir/flags.make" includes REGEX "_INCLUDES = ")
+foreach(lib left right bottom cycle1 cycle2)
+  string(REGEX MATCHALL "/${lib}[\" ]" found "${includes} ")
+  list(LENGTH found count)
+  if(NOT count EQUAL 1)
+    string(APPEND RunCMake_TEST_FAILED
+      "Include directory of ${lib} appears ${count} times:\n ${includes}\n")
+  elseif(includes MATCHES "(^| )[-/]I *\"?[^ ]*/${lib}[\" ]")
+    string(APPEND RunCMake_TEST_FAILED
+      "Include directory of ${lib} is not a system one:\n ${includes}\n")
+  endif()
+endforeach()
+
+# The cycle is repeated on the link line after the diamond's bottom.
+file(READ "${dir}/top.dir/link.txt" link)
+set(order "left right cycle1 bottom cycle2 cycle1 cycle2")
+string(REGEX REPLACE "([a-z0-9]+)" "[^ ]*\\1[^ ]*\\\\.[A-Za-z]+" expect
+  "${order}")
+if(NOT link MATCHES "${expect}")
+  string(APPEND RunCMake_TEST_FAILED
+    "Link line does not list libraries in the order\n ${order}\n"
+    "Actual:\n ${link}\n")
+endif()
+
+file(READ "${dir}/Makefile2" makefile2)
+foreach(dep top:left top:right top:bottom top:cycle1
+            left:bottom right:bottom cycle1:cycle2)
+  string(REPLACE ":" ";" dep "${dep}")
+  list(GET dep 0 from)
+  list(GET dep 1 to)
+  set(line "CMakeFiles/${from}.dir/all: CMakeFiles/${to}.dir/all\n")
+  string(FIND "${makefile2}" "${line}" pos)
+  if(pos EQUAL -1)
+    string(APPEND RunCMake_TEST_FAILED
+      "Makefile2 does not make ${from} depend on ${to}.\n")
+  endif()
+endforeach()
@@ -0,0 +1,22 @@
+enable_language(C)
+
+# A diamond: left and right both bring in bottom.
+add_library(bottom STATIC hello.c)
+target_include_directories(bottom SYSTEM INTERFACE ${CMAKE_CURRENT_SOURCE_DIR}/bottom)
+add_library(left STATIC hello.c)
+target_link_libraries(left PUBLIC bottom)
+target_include_directories(left SYSTEM INTERFACE ${CMAKE_CURRENT_SOURCE_DIR}/left)
+add_library(right STATIC hello.c)
+target_link_libraries(right PUBLIC bottom)
+target_include_directories(right SYSTEM INTERFACE ${CMAKE_CURRENT_SOURCE_DIR}/right)
+
+# A cycle of static libraries.
+add_library(cycle1 STATIC hello.c)
+add_library(cycle2 STATIC hello.c)
+target_link_libraries(cycle1 PUBLIC cycle2)
+target_link_libraries(cycle2 PUBLIC cycle1)
+target_include_directories(cycle1 SYSTEM INTERFACE ${CMAKE_CURRENT_SOURCE_DIR}/cycle1)
+target_include_directories(cycle2 SYSTEM INTERFACE ${CMAKE_CURRENT_SOURCE_DIR}/cycle2)
+
+add_executable(top hello.c)
+target_link_libraries(top PRIVATE left right cycle1)
@@ -38,3 +38,80 @@ run_VerboseBuild()
 
 run_cmake(CustomCommandDepfile-ERROR)
 run_cmake(IncludeRegexSubdir)
+run_cmake(LinkClosure)
+
+function(run_IncrementalGenerate)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/IncrementalGenerate-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/a.cmake"
+    "target_compile_definitions(a PRIVATE A=1)\n")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/pol.cmake" "")
+  set(RunCMake_TEST_OPTIONS -DCMAKE_INCREMENTAL_GENERATE=ON)
+  run_cmake(IncrementalGenerate)
+  unset(RunCMake_TEST_OPTIONS)
+  # The first configuration of a build tree sets some variables that
+  # later runs do not, so start from a regenerated tree.
+  run_cmake_command(IncrementalGenerate-regenerate ${CMAKE_COMMAND} .)
+
+  macro(mark_rule_files)
+    foreach(t a b c)
+      file(APPEND "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${t}.dir/build.make"
+        "# marked\n")
+    endforeach()
+  endmacro()
+
+  # Regenerating without changes reuses all rule files.
+  mark_rule_files()
+  run_cmake_command(IncrementalGenerate-unchanged ${CMAKE_COMMAND} .)
+
+  # Changing a target rewrites its rule files and those of its dependents.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/a.cmake"
+    "target_compile_definitions(a PRIVATE A=2)\n")
+  run_cmake_command(IncrementalGenerate-changed ${CMAKE_COMMAND} .)
+
+  # Changing a policy setting rewrites the rule files of its targets.
+  mark_rule_files()
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/pol.cmake"
+    "cmake_policy(SET CMP0065 NEW)\n")
+  run_cmake_command(IncrementalGenerate-policy ${CMAKE_COMMAND} .)
+
+  # Removing any rule file of a target rewrites them.
+  mark_rule_files()
+  file(REMOVE "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/c.dir/flags.make")
+  run_cmake_command(IncrementalGenerate-missing ${CMAKE_COMMAND} .)
+
+  # Disabling the feature rewrites all rule files.
+  mark_rule_files()
+  run_cmake_command(IncrementalGenerate-disabled ${CMAKE_COMMAND}
+    -DCMAKE_INCREMENTAL_GENERATE=OFF .)
+endfunction()
+run_IncrementalGenerate()
+
+function(run_IncrementalGenerateRuleHash)
+  set(RunCMake_TEST_BINARY_DIR
+    ${RunCMake_BINARY_DIR}/IncrementalGenerateRuleHash-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/d.cmake" "set(d_text 1)\n")
+  set(RunCMake_TEST_OPTIONS -DCMAKE_INCREMENTAL_GENERATE=ON)
+  run_cmake(IncrementalGenerateRuleHash)
+  unset(RunCMake_TEST_OPTIONS)
+  run_cmake_command(IncrementalGenerateRuleHash-regenerate
+    ${CMAKE_COMMAND} .)
+
+  # Reusing the rule files of a target whose custom command output was
+  # not built keeps the hash of the rule.
+  file(APPEND "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/d.dir/build.make"
+    "# marked\n")
+  run_cmake_command(IncrementalGenerateRuleHash-reused ${CMAKE_COMMAND} .)
+
+  # Editing the custom command once its output exists removes the output
+  # so that it is built again.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/d.txt" "1\n")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/d.cmake" "set(d_text 2)\n")
+  run_cmake_command(IncrementalGenerateRuleHash-edited ${CMAKE_COMMAND} .)
+endfunction()
+run_IncrementalGenerateRuleHash()
@@ -322,3 +322,10 @@ function (run_ChangeBuildType)
   run_ninja("${RunCMake_TEST_BINARY_DIR}" -w dupbuild=err)
 endfunction()
 run_ChangeBuildType()
+
+function (run_Subninja)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Subninja-build)
+  run_cmake(Subninja)
+  run_ninja("${RunCMake_TEST_BINARY_DIR}")
+endfunction()
+run_Subninja()
@@ -0,0 +1,17 @@
+set(build_file "${RunCMake_TEST_BINARY_DIR}/build.ninja")
+file(READ "${build_file}" build)
+foreach(dir "" "Subninja/")
+  set(dir_file "${dir}CMakeFiles/directory.ninja")
+  if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/${dir_file}")
+    set(RunCMake_TEST_FAILED "Directory file not generated:\n ${dir_file}")
+    return()
+  endif()
+  if(NOT build MATCHES "\nsubninja ${dir_file}\n")
+    set(RunCMake_TEST_FAILED "File\n ${build_file}\ndoes not include:\n ${dir_file}")
+    return()
+  endif()
+endforeach()
+file(READ "${RunCMake_TEST_BINARY_DIR}/Subninja/CMakeFiles/directory.ninja" sub)
+if(NOT sub MATCHES "\nbuild Subninja/CMakeFiles/greeting.dir/")
+  set(RunCMake_TEST_FAILED "Subninja/CMakeFiles/directory.ninja does not build greeting")
+endif()
@@ -0,0 +1,5 @@
+enable_language(C)
+set(CMAKE_NINJA_SUBNINJA ON)
+add_subdirectory(Subninja)
+add_executable(hello hello_with_greeting.c)
+target_link_libraries(hello greeting)
@@ -0,0 +1,19 @@
+set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles")
+set(config "")
+if (RunCMake_GENERATOR_IS_MULTI_CONFIG)
+  set(config "/Debug")
+endif()
+
+foreach(tgt IN ITEMS foo other first second zlower)
+  if (NOT EXISTS "${dir}/${tgt}.dir${config}/cmake_pch.h")
+    set(RunCMake_TEST_FAILED "Target ${tgt} has no generated pch header")
+    return()
+  endif()
+endforeach()
+
+foreach(tgt IN ITEMS foobar upper)
+  if (EXISTS "${dir}/${tgt}.dir${config}/cmake_pch.h")
+    set(RunCMake_TEST_FAILED "Target ${tgt} did not reuse a pch")
+    return()
+  endif()
+endforeach()
@@ -0,0 +1,46 @@
+cmake_minimum_required(VERSION 3.18)
+project(PchAutoReuse C)
+
+if(CMAKE_C_COMPILE_OPTIONS_USE_PCH)
+  add_definitions(-DHAVE_PCH_SUPPORT)
+endif()
+
+set(CMAKE_PRECOMPILE_HEADERS_AUTO_REUSE ON)
+
+add_library(foo STATIC foo.c)
+target_include_directories(foo PUBLIC include)
+target_precompile_headers(foo PRIVATE <stdio.h> <string.h>)
+
+# Same headers and flags: reuses the PCH of foo.
+add_executable(foobar foobar.c)
+target_link_libraries(foobar foo)
+target_precompile_headers(foobar PRIVATE <stdio.h> <string.h>)
+
+# Different compile definitions: keeps its own PCH.
+add_library(other STATIC empty.c)
+target_include_directories(other PUBLIC include)
+target_compile_definitions(other PRIVATE OTHER)
+target_precompile_headers(other PRIVATE <stdio.h> <string.h>)
+
+# Mutually dependent static libraries: reusing the PCH of one from the
+# other would make the owner depend on itself.
+add_library(first STATIC empty.c)
+target_include_directories(first PUBLIC include)
+target_precompile_headers(first PRIVATE <string.h>)
+add_library(second STATIC foo.c)
+target_include_directories(second PUBLIC include)
+target_precompile_headers(second PRIVATE <string.h>)
+target_link_libraries(first second)
+target_link_libraries(second first)
+
+# Dependencies own the PCH of their dependents.
+add_library(upper STATIC empty.c)
+target_include_directories(upper PUBLIC include)
+target_precompile_headers(upper PRIVATE <stdio.h>)
+target_link_libraries(upper zlower)
+add_library(zlower STATIC foo.c)
+target_include_directories(zlower PUBLIC include)
+target_precompile_headers(zlower PRIVATE <stdio.h>)
+
+enable_testing()
+add_test(NAME foobar COMMAND foobar)
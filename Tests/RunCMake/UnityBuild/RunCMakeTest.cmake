@@ -8,6 +8,8 @@ run_cmake(unitybuild_cxx_group)
 run_cmake(unitybuild_c_and_cxx)
 run_cmake(unitybuild_c_and_cxx_group)
 run_cmake(unitybuild_batchsize)
+run_cmake(unitybuild_balanced)
+run_cmake(unitybuild_balanced_invalid_cost)
 run_cmake(unitybuild_default_batchsize)
 run_cmake(unitybuild_skip)
 run_cmake(unitybuild_code_before_and_after_include)
@@ -0,0 +1,25 @@
+function(check_batch tgt batch)
+  set(unitybuild_c
+    "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${tgt}.dir/Unity/unity_${batch}_c.c")
+  if(NOT EXISTS "${unitybuild_c}")
+    set(RunCMake_TEST_FAILED
+      "Generated unity source file ${unitybuild_c} does not exist." PARENT_SCOPE)
+    return()
+  endif()
+  file(STRINGS "${unitybuild_c}" includes REGEX "^#include")
+  string(REGEX REPLACE "#include \"[^;\"]*/(s[0-9]\\.c)\"" "\\1"
+    actual "${includes}")
+  if(NOT actual STREQUAL "${ARGN}")
+    set(RunCMake_TEST_FAILED
+      "${unitybuild_c} includes\n  ${actual}\nbut expected\n  ${ARGN}"
+      PARENT_SCOPE)
+  endif()
+endfunction()
+
+# The two heavy sources go to different batches, which are then filled
+# with the light sources in order.
+check_batch(tgt 0 s1.c s6.c s7.c s8.c)
+check_batch(tgt 1 s2.c s3.c s4.c s5.c)
+
+check_batch(tgt_cost 0 s5.c s6.c s7.c s8.c)
+check_batch(tgt_cost 1 s1.c s2.c s3.c s4.c)
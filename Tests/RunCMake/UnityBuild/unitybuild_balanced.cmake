@@ -0,0 +1,32 @@
+project(unitybuild_balanced C)
+
+set(srcs "")
+foreach(s RANGE 1 8)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  set(padding "")
+  if(s EQUAL 1)
+    string(REPEAT "/* heavy */\n" 400 padding)
+  elseif(s EQUAL 2)
+    string(REPEAT "/* heavy */\n" 300 padding)
+  endif()
+  file(WRITE "${src}" "${padding}int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+
+# An explicit cost overrides the size of the file.  Use a copy of the
+# source so that the other target keeps measuring the file size.
+set(cost_src "${CMAKE_CURRENT_BINARY_DIR}/cost/s8.c")
+file(WRITE "${cost_src}" "int s8(void) { return 0; }\n")
+set_property(SOURCE "${cost_src}" PROPERTY UNITY_BUILD_COST 100000)
+set(cost_srcs ${srcs})
+list(REMOVE_AT cost_srcs 7)
+
+add_library(tgt SHARED ${srcs})
+add_library(tgt_cost SHARED ${cost_srcs} "${cost_src}")
+
+set_target_properties(tgt tgt_cost
+  PROPERTIES
+    UNITY_BUILD ON
+    UNITY_BUILD_MODE BALANCED
+    UNITY_BUILD_BATCH_SIZE 4
+)
@@ -0,0 +1,27 @@
+enable_language(C)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.c "#error bad\n")
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR}
+  BATCH
+    RESULT_SRC ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+    RESULT_BAD ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+    RESULT_DEF ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COMPILE_DEFINITIONS -DSOME_DEFINITION
+  OUTPUT_VARIABLE out
+  )
+if(RESULT)
+  message(SEND_ERROR "try_compile BATCH with a failing check succeeded")
+endif()
+if(NOT RESULT_SRC OR NOT RESULT_DEF)
+  message(SEND_ERROR "try_compile BATCH failed a valid check:\n${out}")
+endif()
+if(RESULT_BAD)
+  message(SEND_ERROR "try_compile BATCH passed an invalid check")
+endif()
+
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR}
+  BATCH RESULT_ONLY ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  )
+if(NOT RESULT OR NOT RESULT_ONLY)
+  message(SEND_ERROR "try_compile BATCH with a valid check failed:\n${out}")
+endif()
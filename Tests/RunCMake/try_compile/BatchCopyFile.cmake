@@ -0,0 +1,3 @@
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR}
+  BATCH RESULT_SRC ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/out.bin)
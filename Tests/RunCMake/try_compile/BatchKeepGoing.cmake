@@ -0,0 +1,22 @@
+enable_language(C)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.c "#error bad\n")
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR}
+  BATCH
+    RESULT_BAD ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+    RESULT_SRC ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+    RESULT_DEF ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COMPILE_DEFINITIONS -DSOME_DEFINITION
+  OUTPUT_VARIABLE out
+  )
+if(RESULT_BAD OR NOT RESULT_SRC OR NOT RESULT_DEF)
+  message(SEND_ERROR "try_compile BATCH gave wrong results:\n${out}")
+endif()
+
+# The job count is capped by the number of checks, and the one build
+# keeps going past the failed check instead of rebuilding the others.
+string(REGEX MATCHALL "Run Build Command\\(s\\):[^\n]*" commands "${out}")
+list(LENGTH commands count)
+if(NOT count EQUAL 1 OR NOT commands MATCHES " -j ?3( |$)"
+    OR NOT commands MATCHES " -k( |$)")
+  message(SEND_ERROR "try_compile BATCH ran unexpected builds:\n${out}")
+endif()
@@ -0,0 +1,40 @@
+enable_language(C)
+
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  COPY_FILE_ERROR copy_err
+  )
+if(NOT result)
+  message(FATAL_ERROR "try_compile failed:\n${out}")
+endif()
+if(copy_err)
+  message(FATAL_ERROR "try_compile COPY_FILE failed:\n${copy_err}")
+endif()
+
+try_compile(result_pp ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COMPILE_DEFINITIONS -DPP_ERROR
+  OUTPUT_VARIABLE out_pp
+  )
+if(result_pp)
+  message(FATAL_ERROR "try_compile with PP_ERROR defined succeeded:\n${out_pp}")
+endif()
+
+# Headers found in include directories of the caller are not part of the
+# cache key, so these checks are not stored.
+try_compile(result_inc ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  CMAKE_FLAGS -DINCLUDE_DIRECTORIES=${CMAKE_CURRENT_SOURCE_DIR}
+  OUTPUT_VARIABLE out_inc
+  )
+try_compile(result_flag ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COMPILE_DEFINITIONS -I${CMAKE_CURRENT_SOURCE_DIR}
+  OUTPUT_VARIABLE out_flag
+  )
+if(NOT result_inc OR NOT result_flag)
+  message(FATAL_ERROR "try_compile with include directories failed:\n"
+    "${out_inc}\n${out_flag}")
+endif()
@@ -0,0 +1,16 @@
+include(ResultCache.cmake)
+
+if(NOT EXISTS ${CMAKE_CURRENT_BINARY_DIR}/copy)
+  message(FATAL_ERROR "try_compile did not restore the cached executable")
+endif()
+if(NOT out MATCHES "CACHED-MARKER")
+  message(FATAL_ERROR "try_compile did not use the cached result:\n${out}")
+endif()
+# Failures are not cached, so the failing check is built again.
+if(out_pp MATCHES "CACHED-MARKER")
+  message(FATAL_ERROR "try_compile used a cached failure:\n${out_pp}")
+endif()
+if(out_inc MATCHES "CACHED-MARKER" OR out_flag MATCHES "CACHED-MARKER")
+  message(FATAL_ERROR "try_compile used a cached result despite include "
+    "directories:\n${out_inc}\n${out_flag}")
+endif()
@@ -15,6 +15,8 @@ run_cmake(BadSources1)
 run_cmake(BadSources2)
 run_cmake(NonSourceCopyFile)
 run_cmake(NonSourceCompileDefinitions)
+run_cmake(BatchOdd)
+run_cmake(BatchCopyFile)
 
 set(RunCMake_TEST_OPTIONS --debug-trycompile)
 run_cmake(PlatformVariables)
@@ -25,6 +27,13 @@ run_cmake(TargetTypeExe)
 run_cmake(TargetTypeInvalid)
 run_cmake(TargetTypeStatic)
 
+run_cmake(Batch)
+if(RunCMake_GENERATOR MATCHES "^(Unix|MSYS|MinGW) Makefiles$|Ninja")
+  set(ENV{CMAKE_BUILD_PARALLEL_LEVEL} 8)
+  run_cmake(BatchKeepGoing)
+  unset(ENV{CMAKE_BUILD_PARALLEL_LEVEL})
+endif()
+
 if (CMAKE_SYSTEM_NAME MATCHES "^(Linux|Darwin|Windows)$" AND
     CMAKE_C_COMPILER_ID MATCHES "^(MSVC|GNU|Clang|AppleClang)$")
   set (RunCMake_TEST_OPTIONS -DRunCMake_C_COMPILER_ID=${CMAKE_C_COMPILER_ID})
@@ -58,6 +67,24 @@ if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU" AND NOT CMAKE_CXX_COMPILER_VERSION VERSI
   run_cmake(CxxStandardGNU)
 endif()
 
+# Fill a result cache, mark its entries, and check that a second build
+# tree reuses them.  Only the plain successful check is stored.
+set(cache_dir "${RunCMake_BINARY_DIR}/ResultCache-cache")
+file(REMOVE_RECURSE "${cache_dir}")
+set(RunCMake_TEST_OPTIONS -DCMAKE_TRY_COMPILE_CACHE_DIR=${cache_dir})
+run_cmake(ResultCache)
+file(GLOB_RECURSE entries "${cache_dir}/*/result.txt")
+list(LENGTH entries num_entries)
+if(NOT num_entries EQUAL 1)
+  message(SEND_ERROR "Expected 1 try_compile cache entry, found:\n"
+    "  ${entries}")
+endif()
+foreach(entry IN LISTS entries)
+  file(APPEND "${entry}" "CACHED-MARKER\n")
+endforeach()
+run_cmake(ResultCacheHit)
+unset(RunCMake_TEST_OPTIONS)
+
 run_cmake(CMP0056)
 run_cmake(CMP0066)
 run_cmake(CMP0067)
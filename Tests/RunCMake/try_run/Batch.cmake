@@ -0,0 +1,2 @@
+try_run(RUN_RESULT COMPILE_RESULT ${CMAKE_CURRENT_BINARY_DIR}
+  BATCH RESULT_SRC ${CMAKE_CURRENT_SOURCE_DIR}/src.c)
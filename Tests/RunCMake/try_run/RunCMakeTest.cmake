@@ -1,6 +1,7 @@
 include(RunCMake)
 
 run_cmake(BadLinkLibraries)
+run_cmake(Batch)
 
 if (CMAKE_SYSTEM_NAME MATCHES "^(Linux|Darwin|Windows)$" AND
     CMAKE_C_COMPILER_ID MATCHES "^(MSVC|GNU|Clang|AppleClang)$")
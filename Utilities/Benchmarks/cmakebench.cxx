@@ -0,0 +1,343 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+// Driver for the benchmarks in this directory.  Each benchmark writes
+// its inputs to a work directory, times the tool under test on them and
+// prints a rate.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmDefinitions.h"
+#include "cmGeneratedFileStream.h"
+#include "cmLinkedTree.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+
+int Usage()
+{
+  std::cerr << "Usage: cmakebench script <cmake> <work-dir> <commands>\n"
+               "       cmakebench script-flat <cmake> <work-dir> <commands>\n"
+               "       cmakebench configure-file <cmake> <work-dir> <lines>\n"
+               "       cmakebench generate <cmake> <work-dir> <targets> "
+               "[<cmake-options>...]\n"
+               "       cmakebench schedule <ctest> <work-dir> <tests> "
+               "[<ctest-options>...]\n"
+               "       cmakebench lookup-depth <lookups>\n";
+  return 1;
+}
+
+// Run a command and return the wall clock time it took in seconds, or a
+// negative value if it failed.
+double TimeCommand(std::vector<std::string> const& command,
+                   std::string const& dir)
+{
+  std::string output;
+  int result = 0;
+  auto const start = std::chrono::steady_clock::now();
+  bool const ran = cmSystemTools::RunSingleCommand(
+    command, &output, &output, &result, dir.c_str(),
+    cmSystemTools::OUTPUT_NONE);
+  auto const stop = std::chrono::steady_clock::now();
+  if (!ran || result != 0) {
+    std::cerr << cmSystemTools::PrintSingleCommand(command) << " failed:\n"
+              << output << "\n";
+    return -1;
+  }
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+// The body of a loop executed as many times as needed to reach the
+// requested number of commands.  Every line is one command.
+char const* const ScriptBody[] = {
+  "  set(a \"${i}\")",
+  "  set(b a${i} b c)",
+  "  list(LENGTH b n)",
+  "  math(EXPR m \"${n} + ${i}\")",
+  "  if(n EQUAL 3)",
+  "    empty_function(${a} ${b})",
+  "  endif()",
+  "  empty_macro(${a})",
+  "  string(LENGTH \"${b}\" l)",
+  "  unset(a)",
+};
+
+// Without a loop every call is executed once, as in most project code,
+// so nothing is gained from what a call caches for its next execution.
+// The flat script repeats the body with a "set(i)" command before each
+// copy.
+int Script(std::string const& cmake, std::string const& dir,
+           unsigned long commands, bool flat)
+{
+  unsigned long const perIteration =
+    sizeof(ScriptBody) / sizeof(ScriptBody[0]) + (flat ? 1 : 0);
+  unsigned long const iterations =
+    commands > perIteration ? commands / perIteration : 1;
+  unsigned long const total = iterations * perIteration;
+
+  cmSystemTools::MakeDirectory(dir);
+  std::string const script = cmStrCat(dir, "/script.cmake");
+  {
+    cmGeneratedFileStream fout(script);
+    fout << "function(empty_function)\nendfunction()\n"
+         << "macro(empty_macro)\nendmacro()\n";
+    if (flat) {
+      for (unsigned long i = 1; i <= iterations; ++i) {
+        fout << "set(i " << i << ")\n";
+        for (char const* line : ScriptBody) {
+          fout << line << "\n";
+        }
+      }
+    } else {
+      fout << "foreach(i RANGE 1 " << iterations << ")\n";
+      for (char const* line : ScriptBody) {
+        fout << line << "\n";
+      }
+      fout << "endforeach()\n";
+    }
+  }
+
+  double const seconds = TimeCommand({ cmake, "-P", script }, dir);
+  if (seconds < 0) {
+    return 1;
+  }
+  std::cout << "Executed " << total << " commands in " << seconds
+            << " s: " << static_cast<unsigned long>(total / seconds)
+            << " commands/s\n";
+  return 0;
+}
+
+// Lines of the template used by the configure_file benchmark.  They mix
+// literal text with ${}, @@, $ENV{} and escaped references.
+char const* const TemplateBody[] = {
+  "#define NAME_${i} \"${a}\" /* @b@ */",
+  "#cmakedefine HAVE_A @a@",
+  "static char const* p_${i} = \"${b}/$ENV{HOME}/\\$\\{x}\";",
+  "// Plain text without any reference at all, as most lines have.",
+};
+
+// Expand a large template with configure_file once for each way of
+// expanding variables and report the input throughput of each.
+int ConfigureFile(std::string const& cmake, std::string const& dir,
+                  unsigned long lines)
+{
+  unsigned long const perIteration =
+    sizeof(TemplateBody) / sizeof(TemplateBody[0]);
+  unsigned long const iterations =
+    lines > perIteration ? lines / perIteration : 1;
+
+  cmSystemTools::MakeDirectory(dir);
+  std::string const input = cmStrCat(dir, "/template.h.in");
+  unsigned long size = 0;
+  {
+    cmGeneratedFileStream fout(input);
+    for (unsigned long i = 0; i < iterations; ++i) {
+      for (char const* line : TemplateBody) {
+        std::string const text = cmStrCat(line, '\n');
+        fout << text;
+        size += static_cast<unsigned long>(text.size());
+      }
+    }
+  }
+
+  struct Mode
+  {
+    char const* Name;
+    char const* Policy;
+    char const* Options;
+  };
+  static Mode const modes[] = {
+    { "CMP0053 OLD", "OLD", "" },
+    { "CMP0053 OLD @ONLY", "OLD", "@ONLY" },
+    { "CMP0053 NEW", "NEW", "" },
+    { "CMP0053 NEW @ONLY", "NEW", "@ONLY" },
+  };
+  for (Mode const& mode : modes) {
+    std::string const script = cmStrCat(dir, "/configure.cmake");
+    {
+      cmGeneratedFileStream fout(script);
+      fout << "cmake_policy(SET CMP0053 " << mode.Policy << ")\n"
+           << "set(a \"value of a\")\n"
+           << "set(b \"value of b\")\n"
+           << "set(i 1)\n"
+           << "configure_file(\"" << input << "\" \"" << dir
+           << "/template.h\" " << mode.Options << ")\n";
+    }
+    double const seconds = TimeCommand({ cmake, "-P", script }, dir);
+    if (seconds < 0) {
+      return 1;
+    }
+    std::cout << mode.Name << ": configured " << size << " bytes in "
+              << seconds << " s: " << (size / seconds / (1024 * 1024))
+              << " MiB/s\n";
+  }
+  return 0;
+}
+
+// Configure and generate a synthetic project with the given number of
+// library targets in chains of ten, all linking to the first library,
+// and an executable at the end of every chain.  The project is
+// configured once to detect the compiler, then the time of a second
+// configure and generate run is reported.
+int Generate(std::string const& cmake, std::string const& dir,
+             unsigned long targets, std::vector<std::string> const& options)
+{
+  std::string const src = cmStrCat(dir, "/src");
+  std::string const bin = cmStrCat(dir, "/bin");
+  cmSystemTools::MakeDirectory(src);
+  cmSystemTools::MakeDirectory(bin);
+  {
+    cmGeneratedFileStream fout(cmStrCat(src, "/CMakeLists.txt"));
+    fout.SetCopyIfDifferent(true);
+    fout << "cmake_minimum_required(VERSION 3.10)\n"
+         << "project(Generate C)\n"
+         << "foreach(i RANGE 1 " << targets << ")\n"
+         << "  add_library(lib${i} STATIC src/a${i}.c src/b${i}.c)\n"
+         << "  target_compile_definitions(lib${i} PRIVATE LIB=${i})\n"
+         << "  target_include_directories(lib${i} PUBLIC inc/${i})\n"
+         << "  math(EXPR p \"${i} - 1\")\n"
+         << "  math(EXPR r \"${i} % 10\")\n"
+         << "  if(i GREATER 1)\n"
+         << "    target_link_libraries(lib${i} PUBLIC lib1)\n"
+         << "  endif()\n"
+         << "  if(NOT r EQUAL 1 AND p GREATER 1)\n"
+         << "    target_link_libraries(lib${i} PUBLIC lib${p})\n"
+         << "  endif()\n"
+         << "  if(r EQUAL 0)\n"
+         << "    add_executable(exe${i} src/a${i}.c)\n"
+         << "    target_link_libraries(exe${i} PRIVATE lib${i})\n"
+         << "  endif()\n"
+         << "endforeach()\n";
+  }
+  std::string const srcDir = cmStrCat(src, "/src");
+  cmSystemTools::MakeDirectory(srcDir);
+  for (unsigned long i = 1; i <= targets; ++i) {
+    for (char const* name : { "/a", "/b" }) {
+      std::string const file = cmStrCat(srcDir, name, i, ".c");
+      if (!cmSystemTools::FileExists(file)) {
+        cmGeneratedFileStream fout(file);
+        fout << "int " << (name + 1) << i << "(void) { return 0; }\n";
+      }
+    }
+  }
+
+  std::vector<std::string> command = { cmake };
+  command.insert(command.end(), options.begin(), options.end());
+  command.push_back(src);
+  if (TimeCommand(command, bin) < 0) {
+    return 1;
+  }
+  double const seconds = TimeCommand({ cmake, "." }, bin);
+  if (seconds < 0) {
+    return 1;
+  }
+  std::cout << "Configured and generated " << targets << " targets in "
+            << seconds << " s\n";
+  return 0;
+}
+
+// Run a synthetic test suite of no-op tests with ctest so that the time
+// is dominated by scheduling.  Every fourth test depends on the test
+// before it and every hundredth test takes one of three resource locks.
+// Runs after the first one also read and update the cost data of all
+// tests, as in a build tree that is tested repeatedly.
+int Schedule(std::string const& ctest, std::string const& dir,
+             unsigned long tests, std::vector<std::string> const& options)
+{
+  std::string const cmake =
+    cmStrCat(cmSystemTools::GetFilenamePath(ctest), "/cmake",
+             cmSystemTools::GetExecutableExtension());
+  cmSystemTools::MakeDirectory(dir);
+  {
+    cmGeneratedFileStream fout(cmStrCat(dir, "/CTestTestfile.cmake"));
+    for (unsigned long i = 1; i <= tests; ++i) {
+      fout << "add_test(t" << i << " \"" << cmake << "\" -E true)\n";
+      if (i % 4 == 0) {
+        fout << "set_tests_properties(t" << i << " PROPERTIES DEPENDS t"
+             << (i - 1) << ")\n";
+      }
+      if (i % 100 == 0) {
+        fout << "set_tests_properties(t" << i
+             << " PROPERTIES RESOURCE_LOCK lock" << (i % 3) << ")\n";
+      }
+    }
+  }
+
+  std::vector<std::string> command = { ctest, "-Q" };
+  command.insert(command.end(), options.begin(), options.end());
+  double const seconds = TimeCommand(command, dir);
+  if (seconds < 0) {
+    return 1;
+  }
+  std::cout << "Ran " << tests << " tests in " << seconds
+            << " s: " << static_cast<unsigned long>(tests / seconds)
+            << " tests/s\n";
+  return 0;
+}
+
+// Look up a variable defined only in the outermost of a stack of
+// variable scopes, as in a variable read from a deeply nested function
+// call, and report the cost per lookup for several stack depths.
+int LookupDepth(unsigned long lookups)
+{
+  using Tree = cmLinkedTree<cmDefinitions>;
+  std::string const key = "CMAKE_SOME_TOOLCHAIN_VARIABLE_NAME";
+  for (int depth : { 1, 2, 5, 10, 20, 50 }) {
+    Tree tree;
+    Tree::iterator root = tree.Root();
+    Tree::iterator top = tree.Push(root);
+    top->Set(key, "value");
+    for (int i = 1; i < depth; ++i) {
+      top = tree.Push(top);
+      top->Set(cmStrCat("ARGV", i), "value");
+    }
+    unsigned long found = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < lookups; ++i) {
+      found += cmDefinitions::Get(key, top, root) != nullptr;
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    if (found != lookups) {
+      std::cerr << "Lookup failed at depth " << depth << "\n";
+      return 1;
+    }
+    std::chrono::duration<double, std::nano> const elapsed = stop - start;
+    std::cout << "Depth " << depth << ": " << elapsed.count() / lookups
+              << " ns/lookup\n";
+  }
+  return 0;
+}
+}
+
+int main(int argc, char const* const* argv)
+{
+  std::vector<std::string> args(argv + 1, argv + argc);
+  if (args.size() == 4 && (args[0] == "script" || args[0] == "script-flat")) {
+    unsigned long const commands = std::strtoul(args[3].c_str(), nullptr, 10);
+    return Script(args[1], args[2], commands, args[0] == "script-flat");
+  }
+  if (args.size() == 4 && args[0] == "configure-file") {
+    unsigned long const lines = std::strtoul(args[3].c_str(), nullptr, 10);
+    return ConfigureFile(args[1], args[2], lines);
+  }
+  if (args.size() >= 4 && args[0] == "generate") {
+    unsigned long const targets = std::strtoul(args[3].c_str(), nullptr, 10);
+    return Generate(args[1], args[2], targets,
+                    std::vector<std::string>(args.begin() + 4, args.end()));
+  }
+  if (args.size() >= 4 && args[0] == "schedule") {
+    unsigned long const tests = std::strtoul(args[3].c_str(), nullptr, 10);
+    return Schedule(args[1], args[2], tests,
+                    std::vector<std::string>(args.begin() + 4, args.end()));
+  }
+  if (args.size() == 2 && args[0] == "lookup-depth") {
+    unsigned long const lookups = std::strtoul(args[1].c_str(), nullptr, 10);
+    return LookupDepth(lookups);
+  }
+  return Usage();
+}